@@ -597,6 +597,98 @@ void lcd_set_window(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height)
     }
 }
 
+/**
+ * @brief       жϵǰʾܷʹӲֱ
+ * @note        ֱ(0x33/0x37)ԭ(gate), 0x36нλ޹:
+ *              9341/5310/5510/7789/7796/9806 ԭΪ, ʱ(н)ĻX;
+ *              1963 ԭΪ(800*480), ʱͬ. ֧.
+ *              ֻĬɨ跽(DFT_SCAN_DIR), ùlcd_scan_dir()ĳʱкſܷ.
+ * @param       
+ * @retval      0, ֧; 1, ֧(ĻY, lcddev.height)
+ */
+uint8_t lcd_scroll_supported(void)
+{
+    if (lcddev.id == 0x1963)
+    {
+        return lcddev.dir == 1;
+    }
+
+    if (lcddev.id == 0x9341 || lcddev.id == 0x5310 || lcddev.id == 0x5510 ||
+        lcddev.id == 0x7789 || lcddev.id == 0x7796 || lcddev.id == 0x9806)
+    {
+        return lcddev.dir == 0;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       Ӳֱ(0x33/0x3300)
+ * @note        ĻΪ: Ϸ̶ top ,  height , ·̶().
+ *              úʼΪ top(),  lcd_scroll_start() ı.
+ *              ָʾ: lcd_scroll_area(0, lcddev.height)  lcd_scroll_start(0).
+ * @param       top   : Ϸ̶
+ * @param       height: , top + height ܳ lcddev.height
+ * @retval      0, ɹ; 1, ǰIC/ʾֻ֧
+ */
+uint8_t lcd_scroll_area(uint16_t top, uint16_t height)
+{
+    uint16_t bottom;
+
+    if (!lcd_scroll_supported() || height == 0 || (uint32_t)top + height > lcddev.height)
+    {
+        return 1;
+    }
+
+    bottom = lcddev.height - top - height;
+
+    if (lcddev.id == 0x5510)
+    {
+        lcd_write_reg(0x3300, top >> 8);
+        lcd_write_reg(0x3301, top & 0xFF);
+        lcd_write_reg(0x3302, height >> 8);
+        lcd_write_reg(0x3303, height & 0xFF);
+        lcd_write_reg(0x3304, bottom >> 8);
+        lcd_write_reg(0x3305, bottom & 0xFF);
+    }
+    else    /* 9341/5310/7789/7796/9806/1963 */
+    {
+        lcd_wr_regno(0x33);
+        lcd_wr_data(top >> 8);
+        lcd_wr_data(top & 0xFF);
+        lcd_wr_data(height >> 8);
+        lcd_wr_data(height & 0xFF);
+        lcd_wr_data(bottom >> 8);
+        lcd_wr_data(bottom & 0xFF);
+    }
+
+    lcd_scroll_start(top);
+    return 0;
+}
+
+/**
+ * @brief       Ӳֱʼ(0x37/0x3700)
+ * @note        ĵһ(Ļ top )ʾ GRAM ĵ line , ֮, ĩβص top.
+ *              Ļ top + k ʾ GRAM  top + (line - top + k) % height .
+ *              ֻıʾʼ, GRAM Ķд(lcd_set_window)Ӱ.
+ * @param       line: ʼ, Χ top ~ top + height - 1 (GRAMк)
+ * @retval      
+ */
+void lcd_scroll_start(uint16_t line)
+{
+    if (lcddev.id == 0x5510)
+    {
+        lcd_write_reg(0x3700, line >> 8);
+        lcd_write_reg(0x3701, line & 0xFF);
+    }
+    else
+    {
+        lcd_wr_regno(0x37);
+        lcd_wr_data(line >> 8);
+        lcd_wr_data(line & 0xFF);
+    }
+}
+
 /**
  * @brief       SRAMײʱʹܣŷ
  * @note        ˺ᱻHAL_SRAM_Init(),ʼд
@@ -223,6 +223,9 @@ void lcd_fill_circle(uint16_t x, uint16_t y, uint16_t r, uint16_t color);
 void lcd_draw_circle(uint16_t x0, uint16_t y0, uint8_t r, uint16_t color);                  /* Բ */
 void lcd_draw_hline(uint16_t x, uint16_t y, uint16_t len, uint16_t color);                  /* ˮƽ */
 void lcd_set_window(uint16_t sx, uint16_t sy, uint16_t width, uint16_t height);             /* ô */
+uint8_t lcd_scroll_supported(void);                                                         /* ǰܷӲֱ */
+uint8_t lcd_scroll_area(uint16_t top, uint16_t height);                                     /* Ӳֱ */
+void lcd_scroll_start(uint16_t line);                                                       /* Ӳֱʼ */
 void lcd_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint32_t color);          /* ɫ(32λɫ,LTDC) */
 void lcd_color_fill(uint16_t sx, uint16_t sy, uint16_t ex, uint16_t ey, uint16_t *color);   /* ɫ */
 void lcd_draw_line(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);     /* ֱ */
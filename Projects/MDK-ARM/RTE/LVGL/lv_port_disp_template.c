@@ -13,6 +13,8 @@
 #include <stdbool.h>
 #include "lvgl.h"
 #include "./BSP/LCD/lcd.h"
+#include "mem_map.h"
+#include "profiler.h"
 
 /*********************
  *      DEFINES
@@ -29,6 +31,29 @@
 
 #define BYTE_PER_PIXEL (LV_COLOR_FORMAT_GET_SIZE(LV_COLOR_FORMAT_RGB565)) /*will be 2 for RGB565 */
 
+/*Both partial draw buffers live in external SRAM, see User/mem_map.h*/
+#define DISP_BUF_ROWS       EXT_SRAM_DISP_BUF_ROWS
+
+#if MY_DISP_HOR_RES != EXT_SRAM_DISP_HOR_RES
+    #error "EXT_SRAM_DISP_HOR_RES in mem_map.h does not match MY_DISP_HOR_RES"
+#endif
+
+#if LV_USE_STDLIB_MALLOC == LV_STDLIB_BUILTIN
+    #if LV_MEM_ADR != EXT_SRAM_LV_MEM_ADDR || LV_MEM_SIZE != EXT_SRAM_LV_MEM_SIZE
+        #error "LV_MEM_ADR/LV_MEM_SIZE in lv_conf_cmsis.h do not match mem_map.h"
+    #endif
+#endif
+
+/*DMA2 memory-to-memory stream used to push px_map into LCD->LCD_RAM.
+ *Only DMA2 can do memory-to-memory. Stream0 is the ADC and Stream7 is USART1_TX.*/
+#define DISP_DMA_STREAM         DMA2_Stream1
+#define DISP_DMA_CHANNEL        DMA_CHANNEL_0
+#define DISP_DMA_IRQn           DMA2_Stream1_IRQn
+#define DISP_DMA_IRQHandler     DMA2_Stream1_IRQHandler
+
+/*NDTR is 16 bits wide, longer areas are sent in several chunks*/
+#define DISP_DMA_MAX_XFER       0xFFFF
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -39,10 +64,35 @@
 static void disp_init(void);
 
 static void disp_flush(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static void disp_dma_init(void);
+static void disp_dma_start(void);
+static void disp_dma_xfer_cplt(DMA_HandleTypeDef * hdma);
+static void disp_set_area(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * src);
+static void disp_flush_done(void);
+static void disp_wait_flush(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static DMA_HandleTypeDef s_disp_dma;
+
+/*State of the flush in progress, owned by the DMA interrupt until flush_ready is signalled*/
+static lv_display_t * volatile s_flush_disp;
+static const uint16_t * volatile s_flush_src;
+static volatile uint32_t s_flush_remain;
+static uint32_t s_flush_t0;                     /*prof_now() at disp_flush, for PROF_ZONE_DISP_FLUSH*/
+static volatile bool s_flush_busy;              /*Set from disp_flush until flush_ready, direct LCD access waits on it*/
+
+/*Part of the area below the scroll band, sent after the part above it*/
+static int32_t s_flush_x;
+static int32_t s_flush_w;
+static int32_t s_flush_tail_y;
+static int32_t s_flush_tail_h;
+static const uint16_t * s_flush_tail_src;
+
+/*Rows owned by the hardware scroll band (s_band_h == 0: none), see lv_port_disp_scroll_begin()*/
+static int32_t s_band_y;
+static int32_t s_band_h;
 
 /**********************
  *      MACROS
@@ -65,21 +115,20 @@ void lv_port_disp_init(void)
     lv_display_t * disp = lv_display_create(MY_DISP_HOR_RES, MY_DISP_VER_RES);
     lv_display_set_flush_cb(disp, disp_flush);
 
-    /* Example 1
-     * One buffer for partial rendering*/
-    LV_ATTRIBUTE_MEM_ALIGN
-    static uint8_t buf_1_1[MY_DISP_HOR_RES * 10 * BYTE_PER_PIXEL];            /*A buffer for 10 rows*/
-    lv_display_set_buffers(disp, buf_1_1, NULL, sizeof(buf_1_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
-
-//    /* Example 2
-//     * Two buffers for partial rendering
-//     * In flush_cb DMA or similar hardware should be used to update the display in the background.*/
+//    /* Example 1
+//     * One buffer for partial rendering*/
 //    LV_ATTRIBUTE_MEM_ALIGN
-//    static uint8_t buf_2_1[MY_DISP_HOR_RES * 10 * BYTE_PER_PIXEL];
+//    static uint8_t buf_1_1[MY_DISP_HOR_RES * 10 * BYTE_PER_PIXEL];            /*A buffer for 10 rows*/
+//    lv_display_set_buffers(disp, buf_1_1, NULL, sizeof(buf_1_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
 
-//    LV_ATTRIBUTE_MEM_ALIGN
-//    static uint8_t buf_2_2[MY_DISP_HOR_RES * 10 * BYTE_PER_PIXEL];
-//    lv_display_set_buffers(disp, buf_2_1, buf_2_2, sizeof(buf_2_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    /* Example 2
+     * Two buffers for partial rendering
+     * disp_flush() hands one buffer to DMA2 while LVGL renders into the other.
+     * The buffers must not be placed in CCM RAM, the DMA cannot reach it.
+     * They are fixed regions of the external SRAM (sram_init() runs before this).*/
+    uint8_t * buf_2_1 = (uint8_t *)EXT_SRAM_DISP_BUF1_ADDR;
+    uint8_t * buf_2_2 = (uint8_t *)EXT_SRAM_DISP_BUF2_ADDR;
+    lv_display_set_buffers(disp, buf_2_1, buf_2_2, EXT_SRAM_DISP_BUF_SIZE, LV_DISPLAY_RENDER_MODE_PARTIAL);
 
 //    /* Example 3
 //     * Two buffers screen sized buffer for double buffering.
@@ -102,6 +151,101 @@ static void disp_init(void)
 {
     lcd_init();
     lcd_display_dir(1);
+    disp_dma_init();
+}
+
+/*Memory-to-memory DMA: source (PAR) walks px_map, destination (M0AR) stays on LCD->LCD_RAM.
+ *The FIFO is mandatory in memory-to-memory mode, single beats keep the FSMC timing unchanged.*/
+static void disp_dma_init(void)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    s_disp_dma.Instance                 = DISP_DMA_STREAM;
+    s_disp_dma.Init.Channel             = DISP_DMA_CHANNEL;
+    s_disp_dma.Init.Direction           = DMA_MEMORY_TO_MEMORY;
+    s_disp_dma.Init.PeriphInc           = DMA_PINC_ENABLE;
+    s_disp_dma.Init.MemInc              = DMA_MINC_DISABLE;
+    s_disp_dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    s_disp_dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    s_disp_dma.Init.Mode                = DMA_NORMAL;
+    s_disp_dma.Init.Priority            = DMA_PRIORITY_MEDIUM;
+    s_disp_dma.Init.FIFOMode            = DMA_FIFOMODE_ENABLE;
+    s_disp_dma.Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_HALFFULL;
+    s_disp_dma.Init.MemBurst            = DMA_MBURST_SINGLE;
+    s_disp_dma.Init.PeriphBurst         = DMA_PBURST_SINGLE;
+    HAL_DMA_Init(&s_disp_dma);
+
+    s_disp_dma.XferCpltCallback = disp_dma_xfer_cplt;
+
+    /*Below the ADC DMA (0) and the LVGL tick (1): a late flush_ready only delays the next flush*/
+    HAL_NVIC_SetPriority(DISP_DMA_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DISP_DMA_IRQn);
+}
+
+/*Send the next chunk of the current area, or signal LVGL when nothing is left*/
+static void disp_dma_start(void)
+{
+    if(s_flush_remain == 0 && s_flush_tail_h > 0) {
+        disp_set_area(s_flush_x, s_flush_tail_y, s_flush_w, s_flush_tail_h, s_flush_tail_src);
+        s_flush_tail_h = 0;
+    }
+
+    uint32_t len = s_flush_remain;
+
+    if(len == 0) {
+        disp_flush_done();
+        return;
+    }
+
+    if(len > DISP_DMA_MAX_XFER) len = DISP_DMA_MAX_XFER;
+
+    s_flush_remain -= len;
+
+    if(HAL_DMA_Start_IT(&s_disp_dma, (uint32_t)s_flush_src, (uint32_t)&LCD->LCD_RAM, len) != HAL_OK) {
+        s_flush_remain = 0;
+        s_flush_tail_h = 0;
+        disp_flush_done();
+        return;
+    }
+
+    s_flush_src += len;
+}
+
+/*Open the LCD window for the next part of the area and point the DMA source at its pixels*/
+static void disp_set_area(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * src)
+{
+    lcd_set_window(x, y, w, h);
+    lcd_write_ram_prepare();
+
+    s_flush_src = src;
+    s_flush_remain = (uint32_t)w * h;
+}
+
+static void disp_flush_done(void)
+{
+#if PROFILE_ENABLE
+    prof_record(PROF_ZONE_DISP_FLUSH, prof_now() - s_flush_t0);
+#endif
+    s_flush_busy = false;
+    lv_display_flush_ready(s_flush_disp);
+}
+
+/*The FSMC has a single window/GRAM pointer, LCD register writes must not interleave with a flush*/
+static void disp_wait_flush(void)
+{
+    while(s_flush_busy) {
+    }
+}
+
+static void disp_dma_xfer_cplt(DMA_HandleTypeDef * hdma)
+{
+    LV_UNUSED(hdma);
+    disp_dma_start();
+}
+
+void DISP_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&s_disp_dma);
 }
 
 volatile bool disp_flush_enabled = true;
@@ -121,29 +265,108 @@ void disp_disable_update(void)
 }
 
 /*Flush the content of the internal buffer the specific area on the display.
- *`px_map` contains the rendered image as raw pixel map and it should be copied to `area` on the display.
- *You can use DMA or any hardware acceleration to do this operation in the background but
- *'lv_display_flush_ready()' has to be called when it's finished.*/
+ *`px_map` is streamed to LCD->LCD_RAM by DMA2 in the background and
+ *'lv_display_flush_ready()' is called from the transfer complete interrupt.
+ *LVGL does not call flush again before that, so the window set here stays valid for the whole transfer.
+ *Rows inside the hardware scroll band are skipped: the band shows GRAM rows in scrolled order,
+ *the owner of the band draws it with lv_port_disp_scroll_write() instead.
+ *An area crossing the band is sent in two parts, the window is reopened for the part below it.*/
 static void disp_flush(lv_display_t * disp_drv, const lv_area_t * area, uint8_t * px_map)
 {
-    if (disp_flush_enabled)
+    if (!disp_flush_enabled)
     {
-        int16_t width = area->x2 - area->x1 + 1;
-        int16_t height = area->y2 - area->y1 + 1;
-        uint32_t draw_size = width * height;
-        
-        lcd_set_window(area->x1, area->y1, width, height);
-        lcd_write_ram_prepare();
-        
-        uint16_t *color_data = (uint16_t *)px_map;
-        
-        for (uint32_t i = 0; i < draw_size; i++)
-        {
-            lcd_wr_data(color_data[i]);
+        lv_display_flush_ready(disp_drv);
+        return;
+    }
+
+    int32_t width = area->x2 - area->x1 + 1;
+    int32_t y2 = area->y2;
+
+#if PROFILE_ENABLE
+    s_flush_t0 = prof_now();
+#endif
+    s_flush_disp = disp_drv;
+    s_flush_busy = true;
+    s_flush_x = area->x1;
+    s_flush_w = width;
+    s_flush_tail_h = 0;
+
+    if(s_band_h > 0 && area->y1 < s_band_y + s_band_h && area->y2 >= s_band_y) {
+        int32_t tail_y = s_band_y + s_band_h;
+
+        if(area->y2 >= tail_y) {
+            s_flush_tail_y = tail_y;
+            s_flush_tail_h = area->y2 - tail_y + 1;
+            s_flush_tail_src = (const uint16_t *)px_map + (uint32_t)(tail_y - area->y1) * width;
         }
+        y2 = s_band_y - 1;
     }
 
-    lv_display_flush_ready(disp_drv);
+    if(y2 >= area->y1) {
+        disp_set_area(area->x1, area->y1, width, y2 - area->y1 + 1, (const uint16_t *)px_map);
+    }
+    else {
+        s_flush_remain = 0;
+    }
+
+    disp_dma_start();
+}
+
+/*Reserve rows y .. y + h - 1 (full width) as a hardware vertical scroll band.
+ *LVGL keeps rendering in screen coordinates, but its pixels inside the band are no longer sent.
+ *The band's own GRAM rows 0 .. h - 1 are written with lv_port_disp_scroll_write() and
+ *lv_port_disp_scroll_to(line) makes band row `line` the top one (rows below it follow, wrapping around).
+ *Returns 0 on success, 1 when the LCD cannot scroll along the screen's y axis in this orientation
+ *(lcd_scroll_supported(), e.g. NT35510 in landscape) - the caller then keeps drawing through LVGL.*/
+uint8_t lv_port_disp_scroll_begin(int32_t y, int32_t h)
+{
+    if(y < 0 || h <= 0 || y + h > MY_DISP_VER_RES) return 1;
+
+    disp_wait_flush();
+    if(lcd_scroll_area(y, h) != 0) return 1;
+
+    s_band_y = y;
+    s_band_h = h;
+    return 0;
+}
+
+/*Back to normal display. The band is invalidated, LVGL redraws whatever is there now.*/
+void lv_port_disp_scroll_end(void)
+{
+    if(s_band_h == 0) return;
+
+    lv_area_t band = { 0, s_band_y, MY_DISP_HOR_RES - 1, s_band_y + s_band_h - 1 };
+
+    disp_wait_flush();
+    lcd_scroll_area(0, lcddev.height);
+    lcd_scroll_start(0);
+    s_band_h = 0;
+
+    lv_obj_invalidate_area(lv_screen_active(), &band);
+}
+
+/*Write `lines` full-width rows of RGB565 into band rows line .. line + lines - 1 (GRAM order, not screen order).
+ *Written by the CPU: one row per waterfall frame, the whole band only when the band is (re)started.*/
+void lv_port_disp_scroll_write(uint16_t line, const uint16_t * px, uint16_t lines)
+{
+    if(s_band_h == 0 || line + lines > s_band_h) return;
+
+    disp_wait_flush();
+    lcd_set_window(0, s_band_y + line, MY_DISP_HOR_RES, lines);
+    lcd_write_ram_prepare();
+
+    for(uint32_t i = (uint32_t)MY_DISP_HOR_RES * lines; i > 0; i--) {
+        LCD->LCD_RAM = *px++;
+    }
+}
+
+/*Show band row `line` at the top of the band*/
+void lv_port_disp_scroll_to(uint16_t line)
+{
+    if(s_band_h == 0 || line >= s_band_h) return;
+
+    disp_wait_flush();
+    lcd_scroll_start(s_band_y + line);
 }
 
 //static void disp_flush(lv_display_t * disp_drv, const lv_area_t * area, uint8_t * px_map)
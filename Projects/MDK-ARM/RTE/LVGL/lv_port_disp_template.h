@@ -44,6 +44,13 @@ void disp_enable_update(void);
  */
 void disp_disable_update(void);
 
+/* Hardware vertical scroll band (full width rows y .. y + h - 1), see lv_port_disp_template.c
+ * begin returns 0 on success, 1 when the LCD/orientation cannot scroll vertically */
+uint8_t lv_port_disp_scroll_begin(int32_t y, int32_t h);
+void lv_port_disp_scroll_end(void);
+void lv_port_disp_scroll_write(uint16_t line, const uint16_t * px, uint16_t lines);
+void lv_port_disp_scroll_to(uint16_t line);
+
 /**********************
  *      MACROS
  **********************/
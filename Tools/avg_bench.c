@@ -0,0 +1,280 @@
+/**
+ ****************************************************************************************************
+ * @file        avg_bench.c
+ * @brief       主機端頻譜平均測試: 增量更新與雙精度參考比對, 平均後的雜訊抖動, 每幀耗時與記憶體
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -Ihost -I../User -o avg_bench avg_bench.c host/arm_math_host.c \
+ *       ../User/spec_avg.c ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c \
+ *       ../User/profiler.c -lm
+ *
+ * 選項:
+ *   -n npt           FFT 點數 (預設 1024)
+ *   -F frames        幀數 (預設 64)
+ *   -T reps          計時重複次數 (預設 20000)
+ *
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 隨機幅度下各模式與雙精度參考遞迴的相對誤差 < 1e-5; 線性平均前 n 幀等於算術平均
+ *   2. 頻點範圍改變時重新開始 (輸出等於本幀)
+ *   3. 440Hz 正弦波 + 雜訊 (Hann): 線性 16 幀平均後雜訊底的逐幀抖動 (dB 標準差) 至少降為 1/2,
+ *      正弦波峰值頻點的幅度變化 < 0.1dB
+ *
+ * 耗時為 spec_avg_apply() 每個頻點的主機時間; 記憶體為 spec_avg_t 加上累加器 (範圍點數 x 4 byte).
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "spec_avg.h"
+#include "fft_proc.h"
+#include "adc_synth.h"
+#include "profiler.h"
+
+
+#define BENCH_NPT_MAX   FFT_PROC_NPT_MAX
+#define BENCH_BINS      (BENCH_NPT_MAX / 2 + 1)
+
+static float    s_acc[BENCH_BINS];
+static float    s_mag[BENCH_BINS];
+static double   s_ref[BENCH_BINS];
+static uint16_t s_raw[BENCH_NPT_MAX];
+static float    s_in[BENCH_NPT_MAX];
+static float    s_out[BENCH_NPT_MAX];
+static float    s_win[BENCH_NPT_MAX];
+static double   s_db_sum[BENCH_BINS];
+static double   s_db_sq[BENCH_BINS];
+
+static uint32_t s_rng = 0x2545F491u;
+
+
+static float bench_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (float)(s_rng >> 8) / 16777216.0f;
+}
+
+/* 以雙精度計算同一個遞迴, 回傳最大相對誤差 */
+static double check_mode(spec_avg_mode_t mode, int bins, int frames)
+{
+    spec_avg_t avg;
+    double max_err = 0.0;
+
+    spec_avg_init(&avg, s_acc, BENCH_BINS);
+    spec_avg_set_mode(&avg, mode);
+
+    for (int f = 0; f < frames; f++)
+    {
+        int k = (f + 1 < avg.n) ? f + 1 : avg.n;            /* 線性平均的權重分母 */
+
+        for (int i = 0; i < bins; i++)
+        {
+            double x = 0.01 + bench_rand();
+
+            s_mag[i] = (float)x;
+            x = s_mag[i];
+
+            if (f == 0)
+            {
+                s_ref[i] = x;
+                continue;
+            }
+
+            switch (mode)
+            {
+                case SPEC_AVG_LINEAR:   s_ref[i] += (x - s_ref[i]) / k; break;
+                case SPEC_AVG_EXP:      s_ref[i] += avg.alpha * (x - s_ref[i]); break;
+                case SPEC_AVG_MAX_HOLD: s_ref[i] = fmax(x, s_ref[i] * avg.decay); break;
+                case SPEC_AVG_MIN_HOLD: s_ref[i] = fmin(x, s_ref[i]); break;
+                default: break;
+            }
+        }
+
+        spec_avg_apply(&avg, s_mag, 0, (uint16_t)(bins - 1));
+
+        for (int i = 0; i < bins; i++)
+        {
+            double err = fabs(s_mag[i] - s_ref[i]) / s_ref[i];
+            if (err > max_err) max_err = err;
+        }
+    }
+
+    return max_err;
+}
+
+/* 每個頻點的 dB 逐幀標準差 (雜訊底 = 平均, 排除正弦波 ± 8 頻點), 以及正弦波頻點的 dB 變化範圍 */
+static void measure_jitter(fft_proc_t *fp, spec_avg_mode_t mode, int frames, int k0,
+                           double *noise_std, double *tone_range)
+{
+    adc_synth_t gen;
+    spec_avg_t avg;
+    uint16_t bin_start = 1;
+    uint16_t bin_end = fp->npt / 2 - 1;
+    double tone_min = 1e9, tone_max = -1e9;
+    int warm = 16;                      /* 前 16 幀讓平均收斂, 不計入 */
+
+    adc_synth_init(&gen, 2000.0f);
+    adc_synth_add_tone(&gen, 440.0f, 0.5f);
+    adc_synth_set_noise(&gen, 0.01f, 7);
+    spec_avg_init(&avg, s_acc, BENCH_BINS);
+    spec_avg_set_mode(&avg, mode);
+    memset(s_db_sum, 0, sizeof(s_db_sum));
+    memset(s_db_sq, 0, sizeof(s_db_sq));
+
+    for (int f = 0; f < warm + frames; f++)
+    {
+        adc_synth_fill(&gen, s_raw, fp->npt);
+        fft_proc_load_u16(fp, s_raw);
+        fft_proc_spectrum_range(fp, bin_start, bin_end);
+        spec_avg_apply(&avg, fp->mag, bin_start, bin_end);
+
+        if (f < warm) continue;
+
+        for (int i = bin_start; i <= bin_end; i++)
+        {
+            double db = 20.0 * log10(fp->mag[i] + 1e-12);
+            s_db_sum[i] += db;
+            s_db_sq[i]  += db * db;
+        }
+
+        double t = 20.0 * log10(fp->mag[k0]);
+        if (t < tone_min) tone_min = t;
+        if (t > tone_max) tone_max = t;
+    }
+
+    double sum = 0.0;
+    int count = 0;
+
+    for (int i = bin_start; i <= bin_end; i++)
+    {
+        if (abs(i - k0) <= 8) continue;
+
+        double m = s_db_sum[i] / frames;
+        double var = s_db_sq[i] / frames - m * m;
+        sum += sqrt(var > 0.0 ? var : 0.0);
+        count++;
+    }
+
+    *noise_std  = sum / count;
+    *tone_range = tone_max - tone_min;
+}
+
+int main(int argc, char *argv[])
+{
+    int npt = 1024;
+    int frames = 64;
+    int reps = 20000;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-n") == 0) npt = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-F") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-T") == 0) reps = atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n npt] [-F frames] [-T reps]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    fft_proc_t fp;
+
+    if (npt > BENCH_NPT_MAX || fft_proc_init(&fp, BENCH_NPT_MAX, s_in, s_out, s_win) != 0 ||
+        fft_proc_set_npt(&fp, (uint16_t)npt) != 0 || frames < 2)
+    {
+        fprintf(stderr, "unsupported npt %d / frames %d\n", npt, frames);
+        return 2;
+    }
+    fft_proc_set_window(&fp, FFT_WIN_HANN);
+
+    /* 1. 與雙精度參考比對 */
+    for (spec_avg_mode_t m = SPEC_AVG_LINEAR; m < SPEC_AVG_COUNT; m++)
+    {
+        double err = check_mode(m, npt / 2 + 1, frames);
+
+        printf("%-10s max rel err %.2e %s\n", spec_avg_mode_name(m), err, err < 1e-5 ? "ok" : "MISMATCH");
+        if (!(err < 1e-5)) fail = 1;
+    }
+
+    /* 2. 範圍改變時重新開始 */
+    {
+        spec_avg_t avg;
+        int ok = 1;
+
+        spec_avg_init(&avg, s_acc, BENCH_BINS);
+        spec_avg_set_mode(&avg, SPEC_AVG_EXP);
+        for (int i = 0; i < 64; i++) s_mag[i] = 1.0f;
+        spec_avg_apply(&avg, s_mag, 0, 31);
+        for (int i = 0; i < 64; i++) s_mag[i] = 2.0f;
+        spec_avg_apply(&avg, s_mag, 0, 31);
+        ok &= (s_mag[0] != 2.0f);
+        for (int i = 0; i < 64; i++) s_mag[i] = 3.0f;
+        spec_avg_apply(&avg, s_mag, 1, 32);
+        ok &= (s_mag[1] == 3.0f && avg.count == 1);
+
+        printf("%-10s %s\n", "range reset", ok ? "ok" : "FAIL");
+        if (!ok) fail = 1;
+    }
+
+    /* 3. 雜訊抖動 */
+    int k0 = (int)(440.0f * npt / 2000.0f + 0.5f);
+    double off_std, off_tone;
+
+    measure_jitter(&fp, SPEC_AVG_OFF, frames, k0, &off_std, &off_tone);
+    printf("\n%-10s %12s %12s   (440Hz 0.5V + 0.01V rms noise, Hann, %d frames)\n",
+           "mode", "noise_std_db", "tone_pp_db", frames);
+    printf("%-10s %12.3f %12.3f\n", "off", off_std, off_tone);
+
+    for (spec_avg_mode_t m = SPEC_AVG_LINEAR; m < SPEC_AVG_COUNT; m++)
+    {
+        double sd, tr;
+
+        measure_jitter(&fp, m, frames, k0, &sd, &tr);
+        printf("%-10s %12.3f %12.3f\n", spec_avg_mode_name(m), sd, tr);
+
+        if (m == SPEC_AVG_LINEAR && (sd > off_std / 2.0 || tr > 0.1))
+        {
+            fail = 1;
+        }
+    }
+
+    /* 耗時與記憶體 */
+    printf("\n%-10s %10s %10s   (ns/bin, host)\n", "mode", "206 bins", "full");
+    for (spec_avg_mode_t m = SPEC_AVG_LINEAR; m < SPEC_AVG_COUNT; m++)
+    {
+        double ns[2];
+        int widths[2] = { 206, npt / 2 + 1 };
+
+        for (int w = 0; w < 2; w++)
+        {
+            spec_avg_t avg;
+
+            spec_avg_init(&avg, s_acc, BENCH_BINS);
+            spec_avg_set_mode(&avg, m);
+            for (int i = 0; i < widths[w]; i++) s_mag[i] = 0.01f + bench_rand();
+            spec_avg_apply(&avg, s_mag, 0, (uint16_t)(widths[w] - 1));
+
+            uint32_t t0 = prof_now();
+            for (int r = 0; r < reps; r++)
+            {
+                spec_avg_apply(&avg, s_mag, 0, (uint16_t)(widths[w] - 1));
+            }
+            ns[w] = (double)(uint32_t)(prof_now() - t0) / ((double)reps * widths[w]);
+        }
+
+        printf("%-10s %10.3f %10.3f\n", spec_avg_mode_name(m), ns[0], ns[1]);
+    }
+
+    printf("memory: spec_avg_t %u bytes + accumulator %u bytes (%d bins)\n",
+           (unsigned)sizeof(spec_avg_t), (unsigned)((npt / 2 + 1) * sizeof(float)), npt / 2 + 1);
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
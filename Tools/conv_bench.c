@@ -0,0 +1,199 @@
+/**
+ ****************************************************************************************************
+ * @file        conv_bench.c
+ * @brief       主機端 ADC 轉換核心測試: adc_convert.c 與逐點參考迴圈逐位元比對, 並比較耗時
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下), 可攜 C 版本與 SIMD 版本 (以 host/arm_math.h 模擬指令) 各編一次:
+ *   gcc -std=c99 -O2 -Ihost -I../User -o conv_bench conv_bench.c ../User/adc_convert.c \
+ *       ../User/profiler.c -lm
+ *   gcc -std=c99 -O2 -Ihost -I../User -DADC_CONVERT_USE_SIMD=1 -o conv_bench_simd conv_bench.c \
+ *       ../User/adc_convert.c ../User/profiler.c -lm
+ *
+ * 選項:
+ *   -n npt           點數 (預設 1024)
+ *   -r reps          計時重複次數 (預設 2000)
+ *
+ * 檢查項目 (任一失敗則回傳 1), 輸入為 0 ~ 4095 全範圍 (含 0 與 4095) 的隨機碼與正弦波:
+ *   1. 不去直流時與原本的轉換迴圈 (src[i] * win[i] / src[i] * k) 逐位元相同
+ *   2. 去直流時與 (float)(src[i] - dc) * win[i] 逐位元相同
+ *   3. q15 (有無窗函數, 含飽和) 與參考算式逐位元相同
+ *   4. 平均碼與雙精度平均四捨五入相同
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "adc_convert.h"
+#include "profiler.h"
+
+
+#define BENCH_MAX_NPT   4096
+#define BENCH_K         (3.3f / 4095.0f)
+
+static uint32_t s_src_store[BENCH_MAX_NPT / 2];     /* 4-byte 對齊 */
+static uint16_t *s_src = (uint16_t *)s_src_store;
+static float    s_win[BENCH_MAX_NPT];
+static q15_t    s_win_q15[BENCH_MAX_NPT];
+static float    s_ref[BENCH_MAX_NPT];
+static float    s_out[BENCH_MAX_NPT];
+static q15_t    s_ref_q15[BENCH_MAX_NPT];
+static q15_t    s_out_q15[BENCH_MAX_NPT];
+
+
+/* 原本 fft_proc_load_u16() 的迴圈 */
+static void ref_f32(const uint16_t *src, int n, int32_t dc, const float *tab, float k, float *dst)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (dc == 0)
+        {
+            dst[i] = (tab != NULL) ? src[i] * tab[i] : src[i] * k;
+        }
+        else
+        {
+            dst[i] = (float)((int32_t)src[i] - dc) * (tab != NULL ? tab[i] : k);
+        }
+    }
+}
+
+static void ref_q15(const uint16_t *src, int n, int32_t dc, const q15_t *win, q15_t *dst)
+{
+    for (int i = 0; i < n; i++)
+    {
+        int32_t v = ((int32_t)src[i] - dc) * 16;
+
+        if (v > 32767)  v = 32767;
+        if (v < -32768) v = -32768;
+        if (win != NULL) v = (v * win[i]) >> 15;
+
+        dst[i] = (q15_t)v;
+    }
+}
+
+static int check(const char *name, const void *a, const void *b, size_t size)
+{
+    int ok = (memcmp(a, b, size) == 0);
+
+    fprintf(stderr, "%-28s %s\n", name, ok ? "bit-exact" : "MISMATCH");
+    return ok ? 0 : 1;
+}
+
+/* 計時 reps 次, 回傳每點 ns */
+#define TIME_NS_PER_SAMPLE(expr, reps, n, result)               \
+    do {                                                        \
+        uint32_t t0_ = prof_now();                              \
+        for (int r_ = 0; r_ < (reps); r_++) { expr; }           \
+        (result) = (double)(uint32_t)(prof_now() - t0_) / ((double)(reps) * (n)); \
+    } while (0)
+
+int main(int argc, char *argv[])
+{
+    int npt = 1024;
+    int reps = 2000;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-n") == 0) npt = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0) reps = atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n npt] [-r reps]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (npt < 4 || npt > BENCH_MAX_NPT || (npt & 3) != 0)
+    {
+        fprintf(stderr, "npt must be a multiple of 4, 4 ~ %d\n", BENCH_MAX_NPT);
+        return 2;
+    }
+
+    /* Hann (含 ADC 換算) 與 q15 Hann */
+    for (int i = 0; i < npt; i++)
+    {
+        float w = 0.5f - 0.5f * cosf(6.28318530718f * i / npt);
+
+        s_win[i] = w * 2.0f * BENCH_K;
+        s_win_q15[i] = (q15_t)(w * 32767.0f + 0.5f);
+    }
+
+    fprintf(stderr, "npt=%d path=%s\n", npt, ADC_CONVERT_USE_SIMD ? "simd" : "portable");
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        uint32_t rng = 0x2545F491u;
+
+        for (int i = 0; i < npt; i++)
+        {
+            if (pass == 0)
+            {
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                s_src[i] = (uint16_t)(rng % 4096);
+            }
+            else
+            {
+                s_src[i] = (uint16_t)(2048.0f + 2047.0f * sinf(6.28318530718f * 37.3f * i / npt));
+            }
+        }
+        s_src[0] = 0;
+        s_src[1] = 4095;
+
+        double mean = 0.0;
+        for (int i = 0; i < npt; i++) mean += s_src[i];
+        int32_t dc_ref = (int32_t)(mean / npt + 0.5);
+        int32_t dc = adc_convert_mean(s_src, npt);
+
+        fprintf(stderr, "-- %s input, mean code %ld\n", pass == 0 ? "random" : "sine", (long)dc);
+        if (dc != dc_ref)
+        {
+            fprintf(stderr, "%-28s MISMATCH (%ld vs %ld)\n", "mean", (long)dc, (long)dc_ref);
+            fail = 1;
+        }
+
+        ref_f32(s_src, npt, 0, s_win, 0.0f, s_ref);
+        adc_convert_f32(s_src, npt, 0, s_win, 0.0f, s_out);
+        fail |= check("f32 window, no dc", s_ref, s_out, npt * sizeof(float));
+
+        ref_f32(s_src, npt, 0, NULL, BENCH_K, s_ref);
+        adc_convert_f32(s_src, npt, 0, NULL, BENCH_K, s_out);
+        fail |= check("f32 const, no dc", s_ref, s_out, npt * sizeof(float));
+
+        ref_f32(s_src, npt, dc, s_win, 0.0f, s_ref);
+        adc_convert_f32(s_src, npt, dc, s_win, 0.0f, s_out);
+        fail |= check("f32 window, dc removed", s_ref, s_out, npt * sizeof(float));
+
+        ref_q15(s_src, npt, dc, NULL, s_ref_q15);
+        adc_convert_q15(s_src, npt, dc, NULL, s_out_q15);
+        fail |= check("q15, dc removed", s_ref_q15, s_out_q15, npt * sizeof(q15_t));
+
+        ref_q15(s_src, npt, dc, s_win_q15, s_ref_q15);
+        adc_convert_q15(s_src, npt, dc, s_win_q15, s_out_q15);
+        fail |= check("q15 window, dc removed", s_ref_q15, s_out_q15, npt * sizeof(q15_t));
+
+        ref_q15(s_src, npt, 0, s_win_q15, s_ref_q15);
+        adc_convert_q15(s_src, npt, 0, s_win_q15, s_out_q15);
+        fail |= check("q15 window, saturating", s_ref_q15, s_out_q15, npt * sizeof(q15_t));
+    }
+
+    /* 耗時 (主機時間, 只用來比較同一台主機上的版本) */
+    double t_ref, t_f32, t_mean, t_q15;
+
+    TIME_NS_PER_SAMPLE(ref_f32(s_src, npt, 0, s_win, 0.0f, s_ref), reps, npt, t_ref);
+    TIME_NS_PER_SAMPLE(adc_convert_f32(s_src, npt, 2048, s_win, 0.0f, s_out), reps, npt, t_f32);
+    TIME_NS_PER_SAMPLE(adc_convert_mean(s_src, npt), reps, npt, t_mean);
+    TIME_NS_PER_SAMPLE(adc_convert_q15(s_src, npt, 2048, s_win_q15, s_out_q15), reps, npt, t_q15);
+
+    fprintf(stderr, "ns/sample: reference loop %.3f, f32 kernel %.3f (+mean %.3f), q15 kernel %.3f\n",
+            t_ref, t_f32, t_mean, t_q15);
+    fprintf(stderr, "%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,400 @@
+/**
+ ****************************************************************************************************
+ * @file        dsp_bench.c
+ * @brief       主機端頻譜管線測試: 合成 ADC 訊號 => fft_proc => 與參考 DFT 比對, 並統計各階段耗時
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下), 浮點管線與 q15 定點管線 (-DFFT_PROC_USE_Q15=1) 各編一次:
+ *   gcc -std=c99 -O2 -Ihost -I../User -o dsp_bench dsp_bench.c host/arm_math_host.c \
+ *       ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c ../User/profiler.c -lm
+ *   gcc -std=c99 -O2 -Ihost -I../User -DFFT_PROC_USE_Q15=1 -o dsp_bench_q15 dsp_bench.c \
+ *       host/arm_math_host.c ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c \
+ *       ../User/profiler.c -lm
+ *
+ * host/arm_math.h 取代 DSP_LIB (只有 Cortex-M 預編譯函式庫), 其餘都是板端的同一份程式碼.
+ * 所有主機端 bench 一次編譯 (-Wall -Wextra) 並檢查: make -C Tools check (見 Tools/Makefile).
+ *
+ * 選項:
+ *   -n npt           FFT 點數 (64 ~ 4096 的 2 的冪, 預設 1024)
+ *   -r fs            採樣率 Hz (預設 2000)
+ *   -t freq:amp      加入正弦波 (V 峰值), 可重複; 未指定任何訊號時為 440Hz:1.0
+ *   -w rms           高斯雜訊 RMS (V)
+ *   -c f0:f1:amp:sec 線性掃頻
+ *   -l / -h          峰值搜尋範圍 Hz (預設 250 / 650, 與板端相同)
+ *   -W window        窗函數: rect, hann, hamming, blackman-harris, flattop (預設 rect)
+ *   -D               保留直流 (預設與板端相同, 轉換時扣除每幀平均)
+ *   -F frames        處理幀數 (預設 200)
+ *   -R frames        與參考 DFT 比對的幀數 (預設 4)
+ *   -v               每幀輸出 CSV: frame,peak_bin,peak_freq,peak_amp,expect_freq
+ *   -s               只在 stdout 輸出一行 CSV (給 q15_compare.sh):
+ *                    path,npt,window,amp,snr_db,proc_snr_db,mag_err,fft_us
+ *
+ * 兩種 SNR 都只在與參考 DFT 比對的幀計算:
+ *   snr      輸入 SNR: 同一幀量化前的電壓 (adc_synth_fill_volts()) 與量化後的 ADC 碼, 以相同的去直流與窗函數
+ *            各自經參考 DFT; 量化前的頻譜能量 / (量化後 - 量化前) 的頻譜能量, 即 ADC 量化 (與削波) 加入的誤差.
+ *            洩漏屬於訊號, 兩邊相同而相消; 與管線無關, 兩種管線應相同.
+ *            正弦波峰值 1.65V (滿刻度) 時約為 12-bit 的理論上限 74dB, 振幅每小 10 倍約少 20dB
+ *   proc_snr 運算 SNR: 參考頻譜能量 / (管線幅度 - 參考幅度) 的能量, 即 FFT 與幅度運算額外加入的誤差
+ * proc_snr 比 snr 高 10dB 以上時, 運算誤差被 ADC 量化雜訊蓋過, 在頻譜上看不出來.
+ * q15 的 arm_cmplx_mag_q15 會把很小的幅度截成 0, 所以不能直接從管線輸出的頻譜量 SNR.
+ *
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 幅度與雙精度參考 DFT (輸入為管線實際送進 RFFT 的資料) 的最大誤差 (相對於最大幅度)
+ *      < 1e-4 (q15 管線 < BENCH_Q15_TOL)
+ *   2. 只有正弦波時, 搜尋範圍內最強的正弦波頻率與峰值頻率相差不超過 1 個頻點
+ *   3. fft_proc_to_db() 與 20 log10(mag * 2 / npt) 的最大誤差 < 0.01dB (高於 FFT_PROC_DB_FLOOR 的頻點)
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fft_proc.h"
+#include "adc_synth.h"
+#include "profiler.h"
+
+
+#define BENCH_MAX_NPT   FFT_PROC_NPT_MAX
+#define BENCH_Q15_TOL   3e-2        /* 主要來自 arm_cmplx_mag_q15 把平方和截成 q15 */
+
+#if FFT_PROC_USE_Q15
+#define BENCH_PATH      "q15"
+#define BENCH_MAG_TOL   BENCH_Q15_TOL
+#else
+#define BENCH_PATH      "f32"
+#define BENCH_MAG_TOL   1e-4
+#endif
+
+static uint16_t s_raw[BENCH_MAX_NPT];
+static float    s_in[BENCH_MAX_NPT];
+static float    s_out[BENCH_MAX_NPT];
+static float    s_win[BENCH_MAX_NPT];
+static float    s_ref_in[BENCH_MAX_NPT];
+static float    s_volts[BENCH_MAX_NPT];
+static float    s_adc_in[BENCH_MAX_NPT];
+static float    s_err_in[BENCH_MAX_NPT];
+static double   s_ref_mag[BENCH_MAX_NPT / 2 + 1];
+static float    s_db[BENCH_MAX_NPT / 2 + 1];
+
+
+/* 管線實際送進 RFFT 的輸入 (V), 作為參考 DFT 的輸入 */
+static void bench_input_volts(const fft_proc_t *fp, float *dst)
+{
+#if FFT_PROC_USE_Q15
+    const q15_t *in = (const q15_t *)fp->in;
+    float k = fp->q15_lsb / (float)(1u << fp->q15_shift);
+
+    for (int i = 0; i < fp->npt; i++)
+    {
+        dst[i] = in[i] * k;
+    }
+#else
+    memcpy(dst, fp->in, fp->npt * sizeof(float));
+#endif
+}
+
+/* 輸入 SNR 用的前處理 (與管線相同的去直流與窗形狀, 常數倍在比值中相消): src 為電壓 (V) */
+static void bench_condition(const fft_proc_t *fp, const float *src, float *dst)
+{
+    double dc = 0.0;
+
+    if (fp->remove_dc)
+    {
+        for (int i = 0; i < fp->npt; i++) dc += src[i];
+        dc /= fp->npt;
+    }
+
+    for (int i = 0; i < fp->npt; i++)
+    {
+        float w = 1.0f;
+
+        if (fp->window != FFT_WIN_RECT)
+        {
+#if FFT_PROC_USE_Q15
+            w = ((const q15_t *)fp->win)[i];
+#else
+            w = fp->win[i];
+#endif
+        }
+
+        dst[i] = (float)(src[i] - dc) * w;
+    }
+}
+
+/* 雙精度直接 DFT, 輸出 |X[k]|, k = 0 ~ npt/2 */
+static void reference_dft(const float *x, int npt, double *mag)
+{
+    for (int k = 0; k <= npt / 2; k++)
+    {
+        double re = 0.0;
+        double im = 0.0;
+
+        for (int n = 0; n < npt; n++)
+        {
+            double a = -2.0 * 3.14159265358979323846 * (double)((long)k * n % npt) / npt;
+            re += x[n] * cos(a);
+            im += x[n] * sin(a);
+        }
+
+        mag[k] = sqrt(re * re + im * im);
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-n npt] [-r fs] [-t freq:amp]... [-w rms] [-c f0:f1:amp:sec] "
+                    "[-l hz] [-h hz] [-W window] [-D] [-F frames] [-R frames] [-v] [-s]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    int npt = 1024;
+    float fs = 2000.0f;
+    float f_low = 250.0f;
+    float f_high = 650.0f;
+    int frames = 200;
+    int ref_frames = 4;
+    int verbose = 0;
+    int summary = 0;
+    int has_other = 0;          /* 有雜訊或掃頻 => 不檢查峰值頻率 */
+    float tone_f[ADC_SYNTH_MAX_TONES];
+    float tone_a[ADC_SYNTH_MAX_TONES];
+    int tones = 0;
+    float noise = 0.0f;
+    float c_f0 = 0.0f, c_f1 = 0.0f, c_amp = 0.0f, c_sec = 0.0f;
+    fft_window_t window = FFT_WIN_RECT;
+    int keep_dc = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-v") == 0)
+        {
+            verbose = 1;
+            continue;
+        }
+
+        if (strcmp(a, "-s") == 0)
+        {
+            summary = 1;
+            continue;
+        }
+
+        if (strcmp(a, "-D") == 0)
+        {
+            keep_dc = 1;
+            continue;
+        }
+
+        if (v == NULL) usage(argv[0]);
+        i++;
+
+        if      (strcmp(a, "-n") == 0) npt = atoi(v);
+        else if (strcmp(a, "-r") == 0) fs = (float)atof(v);
+        else if (strcmp(a, "-l") == 0) f_low = (float)atof(v);
+        else if (strcmp(a, "-h") == 0) f_high = (float)atof(v);
+        else if (strcmp(a, "-F") == 0) frames = atoi(v);
+        else if (strcmp(a, "-R") == 0) ref_frames = atoi(v);
+        else if (strcmp(a, "-w") == 0) { noise = (float)atof(v); has_other = 1; }
+        else if (strcmp(a, "-W") == 0)
+        {
+            for (window = FFT_WIN_RECT; window < FFT_WIN_COUNT; window++)
+            {
+                if (strcmp(v, fft_proc_window_name(window)) == 0) break;
+            }
+            if (window == FFT_WIN_COUNT) usage(argv[0]);
+        }
+        else if (strcmp(a, "-t") == 0)
+        {
+            if (tones >= ADC_SYNTH_MAX_TONES || sscanf(v, "%f:%f", &tone_f[tones], &tone_a[tones]) != 2) usage(argv[0]);
+            tones++;
+        }
+        else if (strcmp(a, "-c") == 0)
+        {
+            if (sscanf(v, "%f:%f:%f:%f", &c_f0, &c_f1, &c_amp, &c_sec) != 4) usage(argv[0]);
+            has_other = 1;
+        }
+        else usage(argv[0]);
+    }
+
+    if (tones == 0 && !has_other)
+    {
+        tone_f[0] = 440.0f;
+        tone_a[0] = 1.0f;
+        tones = 1;
+    }
+
+    if (npt > BENCH_MAX_NPT)
+    {
+        fprintf(stderr, "npt %d > %d\n", npt, BENCH_MAX_NPT);
+        return 2;
+    }
+
+    fft_proc_t fp;
+    adc_synth_t gen;
+
+    /* 與板端相同: 以最大點數規劃, 再切換到要測試的點數 */
+    if (fft_proc_init(&fp, BENCH_MAX_NPT, s_in, s_out, s_win) != 0 || fft_proc_set_npt(&fp, (uint16_t)npt) != 0 ||
+        fft_proc_set_window(&fp, window) != 0)
+    {
+        fprintf(stderr, "unsupported npt %d\n", npt);
+        return 2;
+    }
+
+    fp.remove_dc = !keep_dc;
+
+    adc_synth_init(&gen, fs);
+    for (int i = 0; i < tones; i++) adc_synth_add_tone(&gen, tone_f[i], tone_a[i]);
+    if (noise > 0.0f) adc_synth_set_noise(&gen, noise, 1);
+    if (c_amp > 0.0f) adc_synth_set_chirp(&gen, c_f0, c_f1, c_amp, c_sec);
+
+    /* 範圍內最強的正弦波 */
+    float expect_f = 0.0f;
+    float expect_a = -1.0f;
+    for (int i = 0; i < tones; i++)
+    {
+        if (tone_f[i] >= f_low && tone_f[i] <= f_high && tone_a[i] > expect_a)
+        {
+            expect_f = tone_f[i];
+            expect_a = tone_a[i];
+        }
+    }
+
+    double worst_err = 0.0;
+    int worst_bin = -1;
+    double worst_db_err = 0.0;
+    double ref_pow = 0.0;
+    double in_sig_pow = 0.0;
+    double in_err_pow = 0.0;
+    double err_pow = 0.0;
+    int peak_miss = 0;
+    float amp_sum = 0.0f;
+    float bin_hz = fs / npt;
+
+    prof_init();
+
+    if (verbose) printf("frame,peak_bin,peak_freq,peak_amp,expect_freq\n");
+
+    for (int f = 0; f < frames; f++)
+    {
+        uint16_t bin_start, bin_end;
+        fft_peak_t pk;
+
+        if (f < ref_frames)
+        {
+            adc_synth_t ideal = gen;    /* 同一段訊號, 量化前 */
+
+            adc_synth_fill_volts(&ideal, s_volts, npt);
+        }
+        adc_synth_fill(&gen, s_raw, npt);
+
+        PROF_BEGIN(PROF_ZONE_FFT_TOTAL);
+        fft_proc_load_u16(&fp, s_raw);
+        if (f < ref_frames) bench_input_volts(&fp, s_ref_in);       /* RFFT 會改寫 in[] */
+        fft_proc_spectrum(&fp);
+        PROF_BEGIN(PROF_ZONE_PEAK);
+        fft_proc_bin_range(&fp, fs, f_low, f_high, &bin_start, &bin_end);
+        fft_proc_find_peak(&fp, fs, bin_start, bin_end, &pk);
+        PROF_END(PROF_ZONE_PEAK);
+        PROF_END(PROF_ZONE_FFT_TOTAL);
+
+        if (f < ref_frames)
+        {
+            double full = 0.0;
+            float lsb = gen.vref / gen.full_scale;
+
+            /* 輸入 SNR: 量化前 / 量化後的誤差, 都經同一個參考 DFT (DFT 為線性, 誤差頻譜即差值的 DFT) */
+            bench_condition(&fp, s_volts, s_volts);
+            for (int n = 0; n < npt; n++) s_adc_in[n] = s_raw[n] * lsb;
+            bench_condition(&fp, s_adc_in, s_adc_in);
+            for (int n = 0; n < npt; n++) s_err_in[n] = s_adc_in[n] - s_volts[n];
+
+            reference_dft(s_volts, npt, s_ref_mag);
+            for (int k = 0; k <= npt / 2; k++) in_sig_pow += s_ref_mag[k] * s_ref_mag[k];
+            reference_dft(s_err_in, npt, s_ref_mag);
+            for (int k = 0; k <= npt / 2; k++) in_err_pow += s_ref_mag[k] * s_ref_mag[k];
+
+            reference_dft(s_ref_in, npt, s_ref_mag);
+            for (int k = 0; k <= npt / 2; k++) if (s_ref_mag[k] > full) full = s_ref_mag[k];
+
+            for (int k = 0; k <= npt / 2; k++)
+            {
+                double err = fabs(fp.mag[k] - s_ref_mag[k]) / full;
+
+                if (err > worst_err)
+                {
+                    worst_err = err;
+                    worst_bin = k;
+                }
+
+                ref_pow += s_ref_mag[k] * s_ref_mag[k];
+                err_pow += (fp.mag[k] - s_ref_mag[k]) * (fp.mag[k] - s_ref_mag[k]);
+            }
+
+            fft_proc_to_db(&fp, fp.mag, s_db, npt / 2 + 1);
+            for (int k = 0; k <= npt / 2; k++)
+            {
+                double db = 20.0 * log10(fp.mag[k] * 2.0 / npt);
+
+                if (db > FFT_PROC_DB_FLOOR && fabs(s_db[k] - db) > worst_db_err)
+                {
+                    worst_db_err = fabs(s_db[k] - db);
+                }
+            }
+        }
+
+        amp_sum += pk.value * 2.0f / npt;       /* 振幅修正後的峰值 => 正弦波峰值 (V) */
+
+        if (!has_other && expect_a > 0.0f && fabsf(pk.freq - expect_f) > bin_hz)
+        {
+            peak_miss++;
+        }
+
+        if (verbose)
+        {
+            printf("%d,%lu,%.3f,%.4f,%.3f\n", f, (unsigned long)pk.index, pk.freq, pk.value, expect_f);
+        }
+    }
+
+    int fail = (worst_err >= BENCH_MAG_TOL) || (peak_miss > 0) || (worst_db_err >= 0.01);
+
+    double snr = 10.0 * log10(in_sig_pow / in_err_pow);
+    double proc_snr = 10.0 * log10(ref_pow / err_pow);
+
+    fprintf(stderr, "path=%s npt=%d fs=%.1f bin=%.3fHz frames=%d window=%s enbw=%.3f bins\n",
+            BENCH_PATH, npt, fs, bin_hz, frames, fft_proc_window_name(window), fp.enbw);
+    fprintf(stderr, "magnitude vs reference DFT (%d frames): max rel err %.3g at bin %d\n",
+            ref_frames < frames ? ref_frames : frames, worst_err, worst_bin);
+    fprintf(stderr, "fast dB vs 20log10: max err %.5fdB\n", worst_db_err);
+    fprintf(stderr, "input SNR %.1fdB (12-bit quantisation)\n", snr);
+    fprintf(stderr, "processing SNR %.1fdB\n", proc_snr);
+    if (!has_other && expect_a > 0.0f)
+    {
+        fprintf(stderr, "peak within 1 bin of %.2fHz: %d/%d frames\n", expect_f, frames - peak_miss, frames);
+        fprintf(stderr, "mean peak amplitude %.4fV (tone %.4fV, %+.2fdB)\n", amp_sum / frames, expect_a,
+                20.0f * log10f(amp_sum / frames / expect_a));
+    }
+
+    if (!summary)
+    {
+        prof_print();
+    }
+    else
+    {
+        const prof_stat_t *st = prof_get(PROF_ZONE_FFT_TOTAL);
+
+        printf("%s,%d,%s,%.4f,%.1f,%.1f,%.3g,%.2f\n", BENCH_PATH, npt, fft_proc_window_name(window),
+               tones > 0 ? tone_a[0] : 0.0f, snr, proc_snr, worst_err,
+               (double)st->sum / st->count * 1e6 / prof_tick_hz());
+    }
+
+    fprintf(stderr, "%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,221 @@
+/**
+ ****************************************************************************************************
+ * @file        fq_stress.c
+ * @brief       主機端頻譜幀佇列壓力測試: 生產端執行緒 (代替 PendSV) 對消費端 (代替 LVGL timer)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -pthread -I../User -o fq_stress fq_stress.c ../User/frame_queue.c
+ *
+ * 選項:
+ *   -N frames        生產端嘗試寫入的幀數 (預設 200000)
+ *   -s seed          亂數種子 (預設 1)
+ *
+ * 兩個執行緒只透過 frame_queue.c (內部以 FQ_BARRIER 排序索引與槽內容) 溝通:
+ *   生產端: frame_queue_begin_write() => 整個槽 (db[], peaks[], count, max_freq ...) 填入由
+ *           即將發佈的序號推出的內容 => frame_queue_commit(); 偶爾連續寫入讓佇列滿
+ *   消費端: frame_queue_read_latest() => 檢查內容, 隨機停留一段時間 (讓生產端追上) 後再檢查一次
+ *           => frame_queue_release()
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 每幀的內容都與其 seq 相符 (沒有讀到寫到一半的槽, 持有期間也沒有被覆寫)
+ *   2. 消費端看到的 seq 嚴格遞增
+ *   3. 結束後: 嘗試 == 寫入 + dropped, 寫入 == 讀取 + skipped (佇列已讀空)
+ *
+ ****************************************************************************************************
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "frame_queue.h"
+
+
+static frame_queue_t s_q;
+static volatile int s_done;
+static uint32_t s_attempts;
+static uint32_t s_written;
+static uint32_t s_limit = 200000;
+static uint32_t s_seed = 1;
+
+static uint32_t s_read;
+static uint32_t s_bad_payload;
+static uint32_t s_bad_order;
+
+
+static uint32_t xorshift(uint32_t *s)
+{
+    *s ^= *s << 13;
+    *s ^= *s >> 17;
+    *s ^= *s << 5;
+    return *s;
+}
+
+/* 序號 => 槽內容 (每個欄位都不同, 混到另一幀一定看得出來) */
+static float pattern(uint32_t seq, uint32_t i)
+{
+    return (float)((seq * 2654435761u + i * 40503u) & 0xFFFFF);
+}
+
+static void fill(spec_frame_t *f, uint32_t seq)
+{
+    f->count      = (uint16_t)(1 + seq % SPEC_FRAME_MAX_BINS);
+    f->bin_start  = (uint16_t)seq;
+    f->bin_end    = (uint16_t)(seq >> 16);
+    f->max_freq   = pattern(seq, 0xFFFF);
+    f->peak_count = (uint16_t)(seq % (SPEC_FRAME_MAX_PEAKS + 1));
+    for (uint32_t i = 0; i < SPEC_FRAME_MAX_PEAKS; i++)
+    {
+        f->peaks[i].freq = pattern(seq, 1000 + i);
+    }
+    for (uint32_t i = 0; i < SPEC_FRAME_MAX_BINS; i++)
+    {
+        f->db[i] = pattern(seq, i);
+    }
+}
+
+static int check(const spec_frame_t *f)
+{
+    uint32_t seq = f->seq;
+
+    if (f->count != 1 + seq % SPEC_FRAME_MAX_BINS || f->bin_start != (uint16_t)seq ||
+        f->bin_end != (uint16_t)(seq >> 16) || f->max_freq != pattern(seq, 0xFFFF) ||
+        f->peak_count != seq % (SPEC_FRAME_MAX_PEAKS + 1))
+    {
+        return 1;
+    }
+    for (uint32_t i = 0; i < SPEC_FRAME_MAX_PEAKS; i++)
+    {
+        if (f->peaks[i].freq != pattern(seq, 1000 + i)) return 1;
+    }
+    for (uint32_t i = 0; i < SPEC_FRAME_MAX_BINS; i++)
+    {
+        if (f->db[i] != pattern(seq, i)) return 1;
+    }
+    return 0;
+}
+
+/* 代替 PendSV: 只有生產端寫 next_seq, 因此發佈前就知道這一幀的序號 */
+static void *producer(void *arg)
+{
+    uint32_t rng = s_seed * 2654435761u + 1;
+
+    (void)arg;
+    while (s_attempts < s_limit)
+    {
+        uint32_t burst = (xorshift(&rng) & 63) == 0 ? FRAME_QUEUE_DEPTH * 2 : 1;
+
+        for (uint32_t b = 0; b < burst && s_attempts < s_limit; b++)
+        {
+            spec_frame_t *f = frame_queue_begin_write(&s_q);
+
+            s_attempts++;
+            if (f != NULL)
+            {
+                fill(f, s_q.next_seq);
+                frame_queue_commit(&s_q);
+                s_written++;
+            }
+        }
+
+        if ((xorshift(&rng) & 7) == 0)
+        {
+            sched_yield();
+        }
+    }
+
+    s_done = 1;
+    return NULL;
+}
+
+static void consume_one(const spec_frame_t *f, uint32_t *last, int *have_last, uint32_t *rng)
+{
+    if (check(f)) s_bad_payload++;
+    if (*have_last && f->seq <= *last) s_bad_order++;
+    *last = f->seq;
+    *have_last = 1;
+
+    /* 持有一段時間, 生產端在這期間必須不碰這個槽 */
+    uint32_t hold = xorshift(rng) & 255;
+    for (volatile uint32_t i = 0; i < hold * 16; i++)
+    {
+    }
+    if ((xorshift(rng) & 15) == 0)
+    {
+        sched_yield();
+    }
+
+    if (check(f)) s_bad_payload++;
+    s_read++;
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t th;
+    uint32_t rng;
+    uint32_t last = 0;
+    int have_last = 0;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-N") == 0) s_limit = (uint32_t)atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0) s_seed = (uint32_t)atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-N frames] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    rng = s_seed * 40503u + 7;
+    frame_queue_init(&s_q);
+
+    if (pthread_create(&th, NULL, producer, NULL) != 0)
+    {
+        fprintf(stderr, "pthread_create failed\n");
+        return 2;
+    }
+
+    while (!s_done)
+    {
+        const spec_frame_t *f = frame_queue_read_latest(&s_q);
+
+        if (f != NULL)
+        {
+            consume_one(f, &last, &have_last, &rng);
+            frame_queue_release(&s_q);
+        }
+        else
+        {
+            sched_yield();      /* 佇列空: 讓出 CPU (單核主機上生產端才跑得動) */
+        }
+    }
+    pthread_join(th, NULL);
+
+    /* 生產端結束後讀空 */
+    const spec_frame_t *f;
+    while ((f = frame_queue_read_latest(&s_q)) != NULL)
+    {
+        consume_one(f, &last, &have_last, &rng);
+        frame_queue_release(&s_q);
+    }
+
+    printf("attempts %u, written %u, dropped %u, read %u, skipped %u\n", s_attempts, s_written,
+           (unsigned)s_q.dropped, s_read, (unsigned)s_q.skipped);
+    printf("payload mismatches %u, out-of-order seq %u\n", s_bad_payload, s_bad_order);
+
+    if (s_bad_payload != 0 || s_bad_order != 0) fail = 1;
+    if (s_attempts != s_written + s_q.dropped || s_written != s_read + s_q.skipped) fail = 1;
+    if (s_q.dropped == 0 || s_q.skipped == 0)
+    {
+        printf("warning: queue never filled / never skipped, increase -N\n");
+    }
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,24 @@
+/**
+ ****************************************************************************************************
+ * @file        arm_const_structs.h
+ * @brief       主機端 CMSIS-DSP 替代品: 複數 FFT 的常數實例 (名稱與 CMSIS 相同, 只含 fftLen)
+ ****************************************************************************************************
+ */
+
+#ifndef __ARM_CONST_STRUCTS_HOST_H
+#define __ARM_CONST_STRUCTS_HOST_H
+
+#include "arm_math.h"
+
+
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len16;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len32;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len64;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len128;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len256;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len512;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len1024;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len2048;
+extern const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096;
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ ****************************************************************************************************
+ * @file        arm_math.h
+ * @brief       主機端 CMSIS-DSP 替代品: 只實作本專案用到的函數, 介面與輸出格式與 CMSIS 相同
+ ****************************************************************************************************
+ * @attention
+ *
+ * DSP_LIB 只附預先編譯好的 Cortex-M 函式庫, 主機端無法連結.
+ * 主機端編譯時把 Tools/host 放在 include 路徑最前面, User/ 下的模組即可不經修改直接編譯.
+ * 這裡的實作以正確為主 (基數 2 複數 FFT), 速度不代表板端 CMSIS 的表現.
+ * q15 函數以整數運算模擬 CMSIS 的縮放與捨入 (每級 1/2, q15 旋轉因子), 精度與板端相近, 但不保證逐位元相同.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ARM_MATH_HOST_H
+#define __ARM_MATH_HOST_H
+
+#include <stdint.h>
+
+
+typedef float   float32_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+typedef enum
+{
+    ARM_MATH_SUCCESS        =  0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+    ARM_MATH_LENGTH_ERROR   = -2
+} arm_status;
+
+#define ARM_HOST_FFT_MAX_LEN    4096
+
+typedef struct
+{
+    uint16_t fftLenRFFT;
+} arm_rfft_fast_instance_f32;
+
+typedef struct
+{
+    uint32_t fftLenReal;
+} arm_rfft_instance_q15;
+
+/* 只用到 fftLen; 常數實例見 arm_const_structs.h */
+typedef struct
+{
+    uint16_t fftLen;
+} arm_cfft_instance_f32;
+
+typedef struct
+{
+    uint8_t M;
+    uint16_t numTaps;
+    float32_t *pCoeffs;
+    float32_t *pState;
+} arm_fir_decimate_instance_f32;
+
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+void arm_max_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex);
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples);
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag);
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S, uint16_t numTaps, uint8_t M,
+                                     float32_t *pCoeffs, float32_t *pState, uint32_t blockSize);
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag);
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst);
+void arm_cmplx_mag_q15(const q15_t *pSrc, q15_t *pDst, uint32_t numSamples);
+void arm_max_q15(const q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex);
+void arm_min_q15(const q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex);
+void arm_shift_q15(const q15_t *pSrc, int8_t shiftBits, q15_t *pDst, uint32_t blockSize);
+
+
+/* Cortex-M4 SIMD 指令的 C 模擬 (與 cmsis_armcc.h 同名), 用來在主機上測試 SIMD 版本的程式碼 */
+static inline int32_t arm_host_sat16(int32_t x)
+{
+    return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+static inline uint32_t __SSUB16(uint32_t x, uint32_t y)
+{
+    uint32_t lo = (uint16_t)((int16_t)x - (int16_t)y);
+    uint32_t hi = (uint16_t)((int16_t)(x >> 16) - (int16_t)(y >> 16));
+
+    return lo | (hi << 16);
+}
+
+static inline uint32_t __QADD16(uint32_t x, uint32_t y)
+{
+    uint32_t lo = (uint16_t)arm_host_sat16((int16_t)x + (int16_t)y);
+    uint32_t hi = (uint16_t)arm_host_sat16((int16_t)(x >> 16) + (int16_t)(y >> 16));
+
+    return lo | (hi << 16);
+}
+
+static inline uint32_t __SMLAD(uint32_t x, uint32_t y, uint32_t sum)
+{
+    return (uint32_t)((int32_t)sum + (int16_t)x * (int16_t)y + (int16_t)(x >> 16) * (int16_t)(y >> 16));
+}
+
+#define __PKHBT(ARG1, ARG2, ARG3)   ((((uint32_t)(ARG1)) & 0x0000FFFFUL) | ((((uint32_t)(ARG2)) << (ARG3)) & 0xFFFF0000UL))
+
+#endif
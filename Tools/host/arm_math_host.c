@@ -0,0 +1,406 @@
+/**
+ ****************************************************************************************************
+ * @file        arm_math_host.c
+ * @brief       主機端 CMSIS-DSP 替代品
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include "arm_math.h"
+#include "arm_const_structs.h"
+
+
+static double s_re[ARM_HOST_FFT_MAX_LEN];
+static double s_im[ARM_HOST_FFT_MAX_LEN];
+static int32_t s_qre[ARM_HOST_FFT_MAX_LEN / 2];
+static int32_t s_qim[ARM_HOST_FFT_MAX_LEN / 2];
+
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len16   = { 16 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len32   = { 32 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len64   = { 64 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len128  = { 128 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len256  = { 256 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len512  = { 512 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len1024 = { 1024 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len2048 = { 2048 };
+const arm_cfft_instance_f32 arm_cfft_sR_f32_len4096 = { 4096 };
+
+
+/* s_re[] / s_im[] (已依位元反轉排列) 的基數 2 蝶形運算, 雙精度 */
+static void arm_host_fft_stages(uint32_t n)
+{
+    uint32_t i, j, len;
+
+    for (len = 2; len <= n; len <<= 1)
+    {
+        double ang = -2.0 * 3.14159265358979323846 / len;
+
+        for (i = 0; i < n; i += len)
+        {
+            for (j = 0; j < len / 2; j++)
+            {
+                double wr = cos(ang * j);
+                double wi = sin(ang * j);
+                uint32_t a = i + j;
+                uint32_t b = a + len / 2;
+                double tr = s_re[b] * wr - s_im[b] * wi;
+                double ti = s_re[b] * wi + s_im[b] * wr;
+
+                s_re[b] = s_re[a] - tr;
+                s_im[b] = s_im[a] - ti;
+                s_re[a] += tr;
+                s_im[a] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief       初始化 RFFT (32 ~ ARM_HOST_FFT_MAX_LEN 的 2 的冪)
+ */
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+    if (fftLen < 32 || fftLen > ARM_HOST_FFT_MAX_LEN || (fftLen & (fftLen - 1)) != 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->fftLenRFFT = fftLen;
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief       實數 FFT, 輸出格式與 CMSIS 相同:
+ *              pOut[0] = Re X[0], pOut[1] = Re X[N/2], pOut[2k], pOut[2k+1] = Re, Im X[k] (k = 1 ~ N/2-1)
+ * @note        只支援正轉換 (ifftFlag = 0); 與 CMSIS 一樣 p[] 的內容不保證保留
+ */
+void arm_rfft_fast_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+    uint32_t n = S->fftLenRFFT;
+    uint32_t i, j;
+
+    (void)ifftFlag;
+
+    /* 位元反轉排列 */
+    for (i = 0, j = 0; i < n; i++)
+    {
+        s_re[j] = p[i];
+        s_im[j] = 0.0;
+
+        uint32_t bit = n >> 1;
+        while (j & bit)
+        {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+
+    arm_host_fft_stages(n);
+
+    pOut[0] = (float32_t)s_re[0];
+    pOut[1] = (float32_t)s_re[n / 2];
+
+    for (i = 1; i < n / 2; i++)
+    {
+        pOut[2 * i]     = (float32_t)s_re[i];
+        pOut[2 * i + 1] = (float32_t)s_im[i];
+    }
+}
+
+/**
+ * @brief       最大值 (相同時取第一個)
+ */
+void arm_max_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult, uint32_t *pIndex)
+{
+    float32_t maxv = pSrc[0];
+    uint32_t idx = 0;
+
+    for (uint32_t i = 1; i < blockSize; i++)
+    {
+        if (pSrc[i] > maxv)
+        {
+            maxv = pSrc[i];
+            idx = i;
+        }
+    }
+
+    *pResult = maxv;
+    *pIndex = idx;
+}
+
+/**
+ * @brief       複數幅度, 與 CMSIS 一樣逐點讀完再寫, 可就地 (pDst == pSrc 或在其前方)
+ */
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        float32_t re = pSrc[2 * i];
+        float32_t im = pSrc[2 * i + 1];
+
+        pDst[i] = sqrtf(re * re + im * im);
+    }
+}
+
+/* i 的低 bits 位元反轉 */
+static uint32_t arm_host_bitrev(uint32_t i, uint32_t n)
+{
+    uint32_t r = 0;
+
+    for (uint32_t bit = n >> 1; bit != 0; bit >>= 1, i >>= 1)
+    {
+        r = (r << 1) | (i & 1);
+    }
+
+    return r;
+}
+
+/**
+ * @brief       複數 FFT (就地), p1[2k], p1[2k+1] = Re, Im; 與 CMSIS 相同, 反轉換含 1/N
+ * @note        bitReverseFlag = 0 時輸出維持位元反轉的順序 (與 CMSIS 相同)
+ */
+void arm_cfft_f32(const arm_cfft_instance_f32 *S, float32_t *p1, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+    uint32_t n = S->fftLen;
+    double sign = ifftFlag ? -1.0 : 1.0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t j = arm_host_bitrev(i, n);
+
+        s_re[j] = p1[2 * i];
+        s_im[j] = sign * p1[2 * i + 1];
+    }
+
+    arm_host_fft_stages(n);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t j = bitReverseFlag ? i : arm_host_bitrev(i, n);
+        double scale = ifftFlag ? 1.0 / n : 1.0;
+
+        p1[2 * j]     = (float32_t)(s_re[i] * scale);
+        p1[2 * j + 1] = (float32_t)(sign * s_im[i] * scale);
+    }
+}
+
+/**
+ * @brief       初始化 FIR 抽取器 (blockSize 須為 M 的倍數); pState 為 numTaps + blockSize - 1 點, 清零
+ */
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S, uint16_t numTaps, uint8_t M,
+                                     float32_t *pCoeffs, float32_t *pState, uint32_t blockSize)
+{
+    if (M == 0 || (blockSize % M) != 0)
+    {
+        return ARM_MATH_LENGTH_ERROR;
+    }
+
+    S->M       = M;
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState  = pState;
+
+    for (uint32_t i = 0; i < (uint32_t)numTaps + blockSize - 1; i++)
+    {
+        pState[i] = 0.0f;
+    }
+
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief       FIR 抽取, 輸出 blockSize / M 點; 與 CMSIS 相同, 係數為時間反序 (pCoeffs[0] 乘最舊的點),
+ *              pState 前 numTaps - 1 點保存上一次呼叫最後的輸入
+ */
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S, float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+    uint32_t taps = S->numTaps;
+    float32_t *st = S->pState;
+
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        st[taps - 1 + i] = pSrc[i];
+    }
+
+    for (uint32_t k = 0; k < blockSize / S->M; k++)
+    {
+        const float32_t *x = &st[k * S->M + S->M - 1];     /* 最新的點為 x[taps - 1] */
+        double acc = 0.0;
+
+        for (uint32_t t = 0; t < taps; t++)
+        {
+            acc += (double)S->pCoeffs[t] * x[t];
+        }
+
+        pDst[k] = (float32_t)acc;
+    }
+
+    for (uint32_t i = 0; i + 1 < taps; i++)
+    {
+        st[i] = st[blockSize + i];
+    }
+}
+
+static q15_t arm_host_q15(double x)
+{
+    long v = lround(x * 32768.0);
+
+    return (q15_t)((v > 32767) ? 32767 : ((v < -32768) ? -32768 : v));
+}
+
+/**
+ * @brief       初始化 q15 RFFT (32 ~ ARM_HOST_FFT_MAX_LEN 的 2 的冪, 只支援正轉換)
+ */
+arm_status arm_rfft_init_q15(arm_rfft_instance_q15 *S, uint32_t fftLenReal, uint32_t ifftFlagR, uint32_t bitReverseFlag)
+{
+    (void)bitReverseFlag;
+
+    if (ifftFlagR != 0 || fftLenReal < 32 || fftLenReal > ARM_HOST_FFT_MAX_LEN || (fftLenReal & (fftLenReal - 1)) != 0)
+    {
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+
+    S->fftLenReal = fftLenReal;
+    return ARM_MATH_SUCCESS;
+}
+
+/**
+ * @brief       q15 實數 FFT, 輸出格式與 CMSIS 相同: 完整 N 個複數 (2N 個 q15), 數值為 X[k] / N
+ * @note        與 CMSIS 相同的作法: 偶 / 奇點組成 N/2 點複數, 每級先 1/2 的 DIT FFT (共 1/(N/2)),
+ *              再以 q15 旋轉因子拆分 (1/2); pSrc 會被改寫
+ */
+void arm_rfft_q15(const arm_rfft_instance_q15 *S, q15_t *pSrc, q15_t *pDst)
+{
+    uint32_t n = S->fftLenReal;
+    uint32_t m = n / 2;
+    uint32_t i, j, len;
+
+    for (i = 0, j = 0; i < m; i++)
+    {
+        s_qre[j] = pSrc[2 * i];
+        s_qim[j] = pSrc[2 * i + 1];
+
+        uint32_t bit = m >> 1;
+        while (j & bit)
+        {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+
+    for (len = 2; len <= m; len <<= 1)
+    {
+        for (i = 0; i < m; i += len)
+        {
+            for (j = 0; j < len / 2; j++)
+            {
+                double ang = -2.0 * 3.14159265358979323846 * j / len;
+                int32_t wr = arm_host_q15(cos(ang));
+                int32_t wi = arm_host_q15(sin(ang));
+                uint32_t a = i + j;
+                uint32_t b = a + len / 2;
+                int32_t tr = (int32_t)(((int64_t)s_qre[b] * wr - (int64_t)s_qim[b] * wi) >> 15);
+                int32_t ti = (int32_t)(((int64_t)s_qre[b] * wi + (int64_t)s_qim[b] * wr) >> 15);
+
+                s_qre[b] = (s_qre[a] - tr) >> 1;
+                s_qim[b] = (s_qim[a] - ti) >> 1;
+                s_qre[a] = (s_qre[a] + tr) >> 1;
+                s_qim[a] = (s_qim[a] + ti) >> 1;
+            }
+        }
+    }
+
+    /* X[k] / N = ((Z[k] + Z*[m-k]) - j W^k (Z[k] - Z*[m-k])) / 4, W = e^(-j2π/N) */
+    for (i = 0; i <= m; i++)
+    {
+        uint32_t kk = i % m;
+        uint32_t kc = (m - i) % m;
+        int64_t ar = (int64_t)s_qre[kk] + s_qre[kc];
+        int64_t ai = (int64_t)s_qim[kk] - s_qim[kc];
+        int64_t br = (int64_t)s_qre[kk] - s_qre[kc];
+        int64_t bi = (int64_t)s_qim[kk] + s_qim[kc];
+        double ang = 2.0 * 3.14159265358979323846 * i / n;
+        int64_t c = arm_host_q15(cos(ang));
+        int64_t s = arm_host_q15(sin(ang));
+        int32_t xr = (int32_t)(((ar << 15) - s * br + c * bi) >> 17);
+        int32_t xi = (int32_t)(((ai << 15) - c * br - s * bi) >> 17);
+
+        xr = arm_host_sat16(xr);
+        xi = arm_host_sat16(xi);
+
+        pDst[2 * i]     = (q15_t)xr;
+        pDst[2 * i + 1] = (q15_t)xi;
+
+        if (i != 0 && i != m)
+        {
+            pDst[2 * (n - i)]     = (q15_t)xr;
+            pDst[2 * (n - i) + 1] = (q15_t)arm_host_sat16(-xi);
+        }
+    }
+}
+
+/**
+ * @brief       q15 複數幅度 (1.15 => 2.14), 與 CMSIS 相同先把平方和截成 q15 再開根號
+ */
+void arm_cmplx_mag_q15(const q15_t *pSrc, q15_t *pDst, uint32_t numSamples)
+{
+    for (uint32_t i = 0; i < numSamples; i++)
+    {
+        int32_t re = pSrc[2 * i];
+        int32_t im = pSrc[2 * i + 1];
+        int32_t acc = (int32_t)(((int64_t)re * re + (int64_t)im * im) >> 17);
+
+        pDst[i] = (q15_t)sqrt((double)acc * 32768.0);
+    }
+}
+
+void arm_max_q15(const q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex)
+{
+    q15_t v = pSrc[0];
+    uint32_t idx = 0;
+
+    for (uint32_t i = 1; i < blockSize; i++)
+    {
+        if (pSrc[i] > v)
+        {
+            v = pSrc[i];
+            idx = i;
+        }
+    }
+
+    *pResult = v;
+    *pIndex = idx;
+}
+
+void arm_min_q15(const q15_t *pSrc, uint32_t blockSize, q15_t *pResult, uint32_t *pIndex)
+{
+    q15_t v = pSrc[0];
+    uint32_t idx = 0;
+
+    for (uint32_t i = 1; i < blockSize; i++)
+    {
+        if (pSrc[i] < v)
+        {
+            v = pSrc[i];
+            idx = i;
+        }
+    }
+
+    *pResult = v;
+    *pIndex = idx;
+}
+
+/**
+ * @brief       飽和移位 (shiftBits > 0 左移, < 0 右移)
+ */
+void arm_shift_q15(const q15_t *pSrc, int8_t shiftBits, q15_t *pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        int32_t v = (shiftBits >= 0) ? ((int32_t)pSrc[i] * (1 << shiftBits)) : (pSrc[i] >> -shiftBits);
+
+        pDst[i] = (q15_t)arm_host_sat16(v);
+    }
+}
@@ -0,0 +1,219 @@
+/**
+ ****************************************************************************************************
+ * @file        job_bench.c
+ * @brief       主機端 DMA 回呼 => PendSV 工作佇列測試: 2kHz / 20kHz 下不掉幀, 序號連續, 過載時掉幀有計數
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -I../User -o job_bench job_bench.c ../User/fft_job.c
+ *
+ * 選項:
+ *   -F frames        每個情境的 DMA 回呼次數 (預設 20000)
+ *   -l us            PendSV 啟動延遲上限 (較高優先權中斷佔用, 預設 2000us)
+ *   -p us            每 1024 點的處理時間 (FFT_Calc 等, 預設 600us = 約 100k 週期 @168MHz)
+ *   -s seed          亂數種子 (預設 1)
+ *
+ * 以離散事件模擬板端的時序, 佇列是板端同一份 fft_job.c:
+ *   DMA 每 npt / fs 回呼一次 (前半 / 後半交替), 回呼即 fft_job_post();
+ *   PendSV 在回呼後延遲 0 ~ l us (均勻分布) 才開始, 依序 fft_job_take() => 複製 (每點 0.02us)
+ *   => fft_job_check() => 處理 (p x npt / 1024 x (1 ~ 1.5), 最少 50us); 處理期間到期的回呼照常發佈.
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 2kHz / 1024 點, 20kHz / 1024 點, 20kHz / 64 點 (最短的一幀 3.2ms):
+ *      fft_job_dropped() == 0, 處理的序號從 1 開始逐一連續, 處理幀數 == 回呼次數, 每幀讀的是正確的那一半
+ *   2. 過載 (處理時間 = 1.5 幀): 一定有掉幀, 且 處理 + dropped == 回呼次數, 序號的缺口總數 == dropped
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fft_job.h"
+
+
+#define BENCH_COPY_US_PER_PT    0.02
+#define BENCH_PROC_MIN_US       50.0
+
+typedef struct
+{
+    const char *name;
+    double   fs;                /* 採樣率 (Hz) */
+    uint32_t npt;               /* 每幀點數 */
+    double   proc_scale;        /* 處理時間倍數 (0: 依 -p; >0: 幀時間的倍數) */
+    int      expect_drops;
+} scenario_t;
+
+typedef struct
+{
+    uint32_t callbacks;
+    uint32_t processed;
+    uint32_t gaps;              /* 序號缺口的總數 */
+    uint32_t wrong_half;
+    uint32_t contiguous;        /* 1: 處理的序號逐一連續 */
+    double   worst_start_us;    /* 回呼到讀完輸入的最長時間 */
+} result_t;
+
+static fft_job_queue_t s_q;
+static uint16_t s_half[2];      /* 只用位址代表前半 / 後半 */
+static uint32_t s_rng;
+
+static double     s_next_dma;
+static double     s_period;
+static uint32_t   s_callbacks;
+static uint32_t   s_limit;
+static double     s_post_time[2];
+
+
+static double rand01(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (double)(s_rng & 0xFFFFFF) / (double)0x1000000;
+}
+
+/* 時間推進到 t: 期間到期的 DMA 回呼依序發佈 (中斷搶佔 PendSV) */
+static void dma_until(double t)
+{
+    while (s_next_dma <= t && s_callbacks < s_limit)
+    {
+        s_post_time[s_callbacks & 1] = s_next_dma;
+        fft_job_post(&s_q, &s_half[s_callbacks & 1]);
+        s_callbacks++;
+        s_next_dma += s_period;
+    }
+}
+
+static void run(const scenario_t *sc, uint32_t frames, double lat_max, double proc_1024, result_t *res)
+{
+    double t = 0.0;
+    uint32_t last = 0;
+    fft_job_t job;
+
+    fft_job_init(&s_q);
+    memset(res, 0, sizeof(*res));
+    res->contiguous = 1;
+
+    s_period    = sc->npt / sc->fs * 1e6;
+    s_next_dma  = s_period;
+    s_callbacks = 0;
+    s_limit     = frames;
+
+    double copy = sc->npt * BENCH_COPY_US_PER_PT;
+    double proc = (sc->proc_scale > 0.0) ? sc->proc_scale * s_period : proc_1024 * sc->npt / 1024.0;
+    if (proc < BENCH_PROC_MIN_US) proc = BENCH_PROC_MIN_US;
+
+    while (s_callbacks < s_limit || s_q.head != s_q.tail)
+    {
+        /* 閒置到下一次回呼, 之後 PendSV 延遲一段時間才開始 */
+        if (s_q.head == s_q.tail)
+        {
+            if (s_next_dma > t) t = s_next_dma;
+            dma_until(t);
+        }
+        t += rand01() * lat_max;
+        dma_until(t);
+
+        while (fft_job_take(&s_q, &job))
+        {
+            t += copy;
+            dma_until(t);
+
+            if (fft_job_check(&s_q, &job) != 0)
+            {
+                continue;
+            }
+
+            if (job.data != &s_half[(job.seq - 1) & 1]) res->wrong_half++;
+            if (job.seq != last + 1)
+            {
+                res->contiguous = 0;
+                res->gaps += job.seq - last - 1;
+            }
+            if (t - s_post_time[(job.seq - 1) & 1] > res->worst_start_us)
+            {
+                res->worst_start_us = t - s_post_time[(job.seq - 1) & 1];
+            }
+            last = job.seq;
+            res->processed++;
+
+            t += proc * (1.0 + 0.5 * rand01());
+            dma_until(t);
+        }
+    }
+
+    res->gaps += s_callbacks - last;    /* 最後處理的幀之後被丟棄的 */
+    res->callbacks = s_callbacks;
+}
+
+int main(int argc, char *argv[])
+{
+    static const scenario_t scen[] =
+    {
+        { "2kHz/1024",     2000.0, 1024, 0.0, 0 },
+        { "20kHz/1024",   20000.0, 1024, 0.0, 0 },
+        { "20kHz/64",     20000.0,   64, 0.0, 0 },
+        { "overload 1.5x", 20000.0,  64, 1.5, 1 },
+    };
+    uint32_t frames = 20000;
+    double lat_max = 2000.0;
+    double proc_1024 = 600.0;
+    uint32_t seed = 1;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-F") == 0) frames = (uint32_t)atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-l") == 0) lat_max = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-p") == 0) proc_1024 = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-s") == 0) seed = (uint32_t)atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-F frames] [-l latency_us] [-p proc_us_per_1024] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (frames < 1 || lat_max < 0.0 || proc_1024 < 0.0)
+    {
+        fprintf(stderr, "bad arguments\n");
+        return 2;
+    }
+
+    printf("%-14s %10s %10s %10s %8s %8s %6s %12s   (PendSV latency <= %.0fus, %.0fus per 1024 pt)\n",
+           "scenario", "frame_us", "callbacks", "processed", "dropped", "gaps", "contig", "worst_read_us",
+           lat_max, proc_1024);
+
+    for (unsigned i = 0; i < sizeof(scen) / sizeof(scen[0]); i++)
+    {
+        const scenario_t *sc = &scen[i];
+        result_t res;
+        uint32_t dropped;
+        int ok;
+
+        s_rng = seed * 2654435761u + i + 1;
+        run(sc, frames, lat_max, proc_1024, &res);
+        dropped = fft_job_dropped(&s_q);
+
+        if (sc->expect_drops)
+        {
+            ok = dropped > 0 && res.processed + dropped == res.callbacks && res.gaps == dropped &&
+                 res.wrong_half == 0;
+        }
+        else
+        {
+            ok = dropped == 0 && res.contiguous && res.processed == res.callbacks && res.gaps == 0 &&
+                 res.wrong_half == 0;
+        }
+
+        printf("%-14s %10.0f %10u %10u %8u %8u %6s %12.0f %s\n", sc->name, sc->npt / sc->fs * 1e6,
+               res.callbacks, res.processed, (unsigned)dropped, res.gaps, res.contiguous ? "yes" : "no",
+               res.worst_start_us, ok ? "" : "FAIL");
+        if (!ok) fail = 1;
+    }
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+# q15_compare.sh - 浮點 (arm_rfft_fast_f32) 與 q15 定點 (arm_rfft_q15) 管線的精度 / 耗時比較
+#
+# 用法 (Linux, 在 Tools/ 目錄下): sh q15_compare.sh [窗函數 ...]
+#   預設比較 rect 與 blackman-harris; 點數 256 / 1024 / 4096, 440Hz 正弦波 1V / 0.1V / 0.01V 峰值.
+#
+# 每列為同一組條件下兩種管線的 dsp_bench -s 結果:
+#   snr       輸入 SNR: 同一幀量化前 / 量化後經同一個參考 DFT (ADC 量化, 兩種管線應相同;
+#             1V 約 70dB, 接近 12-bit 上限 74dB, 振幅每小 10 倍約少 20dB)
+#   proc      運算 SNR (FFT 與幅度運算額外加入的誤差, 見 dsp_bench.c)
+#   us        每幀 fft_total (主機時間, 只能比較同一台主機上的版本; 板端請看 profiler 遙測)
+#   pick      q15 的運算 SNR 比輸入 SNR 高 10dB 以上 => q15 (運算誤差被量化雜訊蓋過), 否則 f32
+#
+# 目前的結果 (rect / blackman-harris, 上述 18 列): 全部 f32.
+# q15 的運算 SNR 矩形窗約 21 ~ 26dB, Blackman-Harris 約 30 ~ 47dB (主要是 arm_cmplx_mag_q15 的截斷),
+# 只有 0.01V (輸入 SNR 約 30dB) 配 Blackman-Harris 時與輸入 SNR 相當, 仍未高出 10dB.
+# 因此 q15 只在顯示動態範圍 (約 20 ~ 40dB) 夠用, 而 FFT 耗時或 RAM 比精度重要時才值得選.
+
+set -e
+
+cd "$(dirname "$0")"
+
+SRC="dsp_bench.c host/arm_math_host.c ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c ../User/profiler.c"
+OUT="${TMPDIR:-/tmp}/q15_compare.$$"
+
+mkdir -p "$OUT"
+trap 'rm -rf "$OUT"' EXIT
+
+gcc -std=c99 -O2 -Ihost -I../User -o "$OUT/f32" $SRC -lm
+gcc -std=c99 -O2 -Ihost -I../User -DFFT_PROC_USE_Q15=1 -o "$OUT/q15" $SRC -lm
+
+WINDOWS="${*:-rect blackman-harris}"
+
+printf '%-16s %5s %7s | %6s %6s %8s | %6s %6s %8s | %s\n' \
+       window npt amp f32_snr proc us q15_snr proc us pick
+
+for w in $WINDOWS; do
+    for n in 256 1024 4096; do
+        for a in 1.0 0.1 0.01; do
+            f=$("$OUT/f32" -n "$n" -W "$w" -t "440:$a" -F 50 -s 2>/dev/null) || true
+            q=$("$OUT/q15" -n "$n" -W "$w" -t "440:$a" -F 50 -s 2>/dev/null) || true
+
+            echo "$f,$q" | awk -F, '{
+                pick = ($14 >= $5 + 10.0) ? "q15" : "f32";
+                printf "%-16s %5s %7s | %6s %6s %8s | %6s %6s %8s | %s\n",
+                       $3, $2, $4, $5, $6, $8, $13, $14, $16, pick
+            }'
+        done
+    done
+done
@@ -0,0 +1,325 @@
+/**
+ ****************************************************************************************************
+ * @file        scan_bench.c
+ * @brief       主機端多通道掃描測試: 解交錯正確性, 每通道 FFT 的頻率 / 振幅 / 串音, 耗時隨通道數的變化
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -Ihost -I../User -o scan_bench scan_bench.c host/arm_math_host.c \
+ *       ../User/adc_scan.c ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c \
+ *       ../User/profiler.c -lm
+ *
+ * 選項:
+ *   -n npt           每通道 FFT 點數 (預設 1024, 超過該通道數的上限時取上限)
+ *   -r fs            每通道採樣率 Hz (預設 2000)
+ *   -F frames        比對的幀數 (預設 16)
+ *   -T reps          計時重複次數 (預設 500)
+ *
+ * 緩衝配置與板端 (main.c) 相同: DMA 半緩衝與 in / out / win 都是 FFT_PROC_NPT_MAX 點, 由各通道平分,
+ * 每通道一個 fft_proc_t, 容量為 ADC_SCAN_NPT_MAX(FFT_PROC_NPT_MAX, ch).
+ * 訊號: 通道 c 只有一個正弦波 (437.3 / 523.9 / 611.1 / 289.7Hz, 0.8 / 0.5 / 0.3 / 0.6V) + 0.002V rms 雜訊,
+ *       各通道先各自合成, 再依掃描順序交錯成 DMA 的排列.
+ * 檢查項目 (1 ~ 4 通道, 任一失敗則回傳 1):
+ *   1. adc_scan_deinterleave() 與逐點參考迴圈逐位元相同, 不寫出 frames x ch 點之外 (含奇數點數)
+ *   2. 每通道的峰值 (Hann + Jacobsen) 頻率誤差 < 0.05 頻點, 振幅誤差 < 1%
+ *   3. 串音: 每通道在其他通道正弦波頻點上的幅度比自己的峰值低 40dB 以上
+ *
+ * 耗時為主機時間 (ns/幀): 解交錯 (對照同樣點數的 memcpy, 即單通道板端的複製) 與所有通道的
+ * 轉換 + RFFT + 範圍內幅度 + 峰值; 最後一欄為一幀時間 (npt / fs) 內的佔用比例.
+ * 列出共同點數與每通道上限兩種點數: 前者看負載與通道數成正比, 後者看總點數固定時負載大致不變.
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "adc_scan.h"
+#include "fft_proc.h"
+#include "adc_synth.h"
+#include "profiler.h"
+
+
+#define BENCH_NPT_BUF   FFT_PROC_NPT_MAX
+#define BENCH_CANARY    0xA5A5
+
+static uint16_t s_plain[ADC_SCAN_MAX_CH][BENCH_NPT_BUF];    /* 各通道各自合成的原始碼 */
+static uint16_t s_dma[BENCH_NPT_BUF];                       /* 交錯排列 (DMA 半緩衝) */
+static uint16_t s_split[BENCH_NPT_BUF + 1];                 /* 解交錯結果, 多一點放 canary */
+static uint16_t s_ref[BENCH_NPT_BUF];
+static float    s_in[BENCH_NPT_BUF];
+static float    s_out[BENCH_NPT_BUF];
+static float    s_win[BENCH_NPT_BUF];
+
+static const float s_freq[ADC_SCAN_MAX_CH] = { 437.3f, 523.9f, 611.1f, 289.7f };
+static const float s_amp[ADC_SCAN_MAX_CH]  = { 0.8f, 0.5f, 0.3f, 0.6f };
+
+
+/* 依掃描順序交錯: dma[i x ch + c] = plain[c][i] */
+static void interleave(int ch, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        for (int c = 0; c < ch; c++)
+        {
+            s_dma[i * ch + c] = s_plain[c][i];
+        }
+    }
+}
+
+/* 1. 與逐點參考迴圈比對; 回傳不符的點數 (canary 被改寫也算一點) */
+static int check_split(int ch, int frames)
+{
+    int bad = 0;
+
+    for (int i = 0; i < frames * ch; i++)
+    {
+        s_dma[i] = (uint16_t)((i * 2654435761u) >> 20);
+    }
+
+    for (int c = 0; c < ch; c++)
+    {
+        for (int i = 0; i < frames; i++)
+        {
+            s_ref[c * frames + i] = s_dma[i * ch + c];
+        }
+    }
+
+    s_split[frames * ch] = BENCH_CANARY;
+    adc_scan_deinterleave(s_dma, (uint32_t)frames, (uint8_t)ch, s_split);
+
+    for (int i = 0; i < frames * ch; i++)
+    {
+        if (s_split[i] != s_ref[i]) bad++;
+    }
+    if (s_split[frames * ch] != BENCH_CANARY) bad++;
+
+    return bad;
+}
+
+/* 與板端相同: 通道 c 的 in / out / win 從 c x cap 起 */
+static int pipelines_init(fft_proc_t *fp, int ch, int n)
+{
+    uint16_t cap = ADC_SCAN_NPT_MAX(BENCH_NPT_BUF, ch);
+
+    for (int c = 0; c < ch; c++)
+    {
+        if (fft_proc_init(&fp[c], cap, s_in + c * cap, s_out + c * cap, s_win + c * cap) != 0 ||
+            fft_proc_set_npt(&fp[c], (uint16_t)n) != 0)
+        {
+            return 1;
+        }
+        fft_proc_set_window(&fp[c], FFT_WIN_HANN);
+        fp[c].interp = FFT_INTERP_JACOBSEN;
+    }
+
+    return 0;
+}
+
+/* 一幀: 解交錯, 每通道轉換 + 範圍內頻譜 + 峰值 */
+static void process_frame(fft_proc_t *fp, int ch, int n, float fs, fft_peak_t *pk)
+{
+    adc_scan_deinterleave(s_dma, (uint32_t)n, (uint8_t)ch, s_split);
+
+    for (int c = 0; c < ch; c++)
+    {
+        uint16_t bs, be;
+
+        fft_proc_load_u16(&fp[c], s_split + c * n);
+        fft_proc_bin_range(&fp[c], fs, 250.0f, 650.0f, &bs, &be);
+        fft_proc_spectrum_range(&fp[c], bs, be);
+        fft_proc_find_peak(&fp[c], fs, bs, be, &pk[c]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int npt = 1024;
+    float fs = 2000.0f;
+    int frames = 16;
+    int reps = 500;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-n") == 0) npt = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0) fs = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-F") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-T") == 0) reps = atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n npt] [-r fs] [-F frames] [-T reps]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (npt < FFT_PROC_NPT_MIN || npt > BENCH_NPT_BUF || (npt & (npt - 1)) != 0 || frames < 1 ||
+        fs < 1400.0f)
+    {
+        fprintf(stderr, "unsupported npt %d / fs %.0f / frames %d (fs must exceed 2 x 650Hz)\n", npt, fs, frames);
+        return 2;
+    }
+
+    /* 1. 解交錯 */
+    {
+        static const int counts[] = { 1, 3, 64, 255, 1024 };
+        int bad_total = 0;
+
+        for (int ch = 1; ch <= ADC_SCAN_MAX_CH; ch++)
+        {
+            for (unsigned k = 0; k < sizeof(counts) / sizeof(counts[0]); k++)
+            {
+                if (counts[k] * ch <= BENCH_NPT_BUF)
+                {
+                    bad_total += check_split(ch, counts[k]);
+                }
+            }
+        }
+
+        printf("deinterleave vs reference (1..%d ch, odd and even lengths): %d mismatches %s\n",
+               ADC_SCAN_MAX_CH, bad_total, bad_total == 0 ? "ok" : "MISMATCH");
+        if (bad_total != 0) fail = 1;
+    }
+
+    /* 2, 3. 每通道的頻譜 */
+    printf("\n%-4s %6s %10s %14s %12s %14s   (%d frames, Hann + Jacobsen, %.0f Hz)\n",
+           "ch", "npt", "tone", "freq_err_bin", "amp_err_pct", "xtalk_db_max", frames, fs);
+
+    for (int ch = 1; ch <= ADC_SCAN_MAX_CH; ch++)
+    {
+        fft_proc_t fp[ADC_SCAN_MAX_CH];
+        adc_synth_t gen[ADC_SCAN_MAX_CH];
+        fft_peak_t pk[ADC_SCAN_MAX_CH];
+        int n = npt;
+        double f_err[ADC_SCAN_MAX_CH] = { 0 }, a_err[ADC_SCAN_MAX_CH] = { 0 }, xtalk[ADC_SCAN_MAX_CH];
+
+        if (n > ADC_SCAN_NPT_MAX(BENCH_NPT_BUF, ch)) n = ADC_SCAN_NPT_MAX(BENCH_NPT_BUF, ch);
+        if (pipelines_init(fp, ch, n) != 0)
+        {
+            fprintf(stderr, "fft_proc_init failed (%d ch, %d pt)\n", ch, n);
+            return 2;
+        }
+
+        for (int c = 0; c < ch; c++)
+        {
+            adc_synth_init(&gen[c], fs);
+            adc_synth_add_tone(&gen[c], s_freq[c], s_amp[c]);
+            adc_synth_set_noise(&gen[c], 0.002f, 7 + c);
+            xtalk[c] = -999.0;
+        }
+
+        for (int f = 0; f < frames; f++)
+        {
+            for (int c = 0; c < ch; c++)
+            {
+                adc_synth_fill(&gen[c], s_plain[c], n);
+            }
+            interleave(ch, n);
+            process_frame(fp, ch, n, fs, pk);
+
+            for (int c = 0; c < ch; c++)
+            {
+                double e = fabs(pk[c].freq - s_freq[c]) * n / fs;
+                if (e > f_err[c]) f_err[c] = e;
+                e = fabs(pk[c].amp - s_amp[c]) / s_amp[c];
+                if (e > a_err[c]) a_err[c] = e;
+
+                for (int o = 0; o < ch; o++)
+                {
+                    if (o == c) continue;
+
+                    uint32_t k = (uint32_t)(s_freq[o] * n / fs + 0.5f);
+                    double db = 20.0 * log10((fp[c].mag[k] + 1e-12) / pk[c].value);
+                    if (db > xtalk[c]) xtalk[c] = db;
+                }
+            }
+        }
+
+        for (int c = 0; c < ch; c++)
+        {
+            int ok = f_err[c] < 0.05 && a_err[c] < 0.01 && (ch == 1 || xtalk[c] < -40.0);
+
+            if (ch == 1)
+            {
+                printf("%d/%-2d %6d %8.1fHz %14.4f %12.3f %14s %s\n", c, ch, n, s_freq[c], f_err[c],
+                       a_err[c] * 100.0, "-", ok ? "" : "FAIL");
+            }
+            else
+            {
+                printf("%d/%-2d %6d %8.1fHz %14.4f %12.3f %14.1f %s\n", c, ch, n, s_freq[c], f_err[c],
+                       a_err[c] * 100.0, xtalk[c], ok ? "" : "FAIL");
+            }
+            if (!ok) fail = 1;
+        }
+    }
+
+    /* 耗時: 通道數 x 點數 */
+    printf("\n%-4s %6s %10s %10s %12s %12s %8s %8s   (ns/frame, host)\n",
+           "ch", "npt", "split", "memcpy", "dsp_all_ch", "total", "x_1ch", "cpu_pct");
+
+    double base_total = 0.0;
+
+    for (int ch = 1; ch <= ADC_SCAN_MAX_CH; ch++)
+    {
+        int sizes[2];
+        int count = 0;
+        int cap = ADC_SCAN_NPT_MAX(BENCH_NPT_BUF, ch);
+
+        sizes[count++] = (npt < cap) ? npt : cap;
+        if (cap != sizes[0]) sizes[count++] = cap;
+
+        for (int s = 0; s < count; s++)
+        {
+            fft_proc_t fp[ADC_SCAN_MAX_CH];
+            fft_peak_t pk[ADC_SCAN_MAX_CH];
+            int n = sizes[s];
+
+            pipelines_init(fp, ch, n);
+            for (int c = 0; c < ch; c++)
+            {
+                adc_synth_t g;
+
+                adc_synth_init(&g, fs);
+                adc_synth_add_tone(&g, s_freq[c], s_amp[c]);
+                adc_synth_fill(&g, s_plain[c], n);
+            }
+            interleave(ch, n);
+
+            uint32_t t0 = prof_now();
+            for (int r = 0; r < reps; r++)
+            {
+                adc_scan_deinterleave(s_dma, (uint32_t)n, (uint8_t)ch, s_split);
+            }
+            uint32_t t1 = prof_now();
+            for (int r = 0; r < reps; r++)
+            {
+                memcpy(s_split, s_dma, (size_t)n * ch * sizeof(uint16_t));
+            }
+            uint32_t t2 = prof_now();
+            for (int r = 0; r < reps; r++)
+            {
+                process_frame(fp, ch, n, fs, pk);
+            }
+            uint32_t t3 = prof_now();
+
+            double split_ns = (double)(uint32_t)(t1 - t0) / reps;
+            double copy_ns  = (double)(uint32_t)(t2 - t1) / reps;
+            double total_ns = (double)(uint32_t)(t3 - t2) / reps;
+            double dsp_ns   = total_ns - split_ns;
+            double frame_ns = n / fs * 1e9;
+
+            if (ch == 1 && s == 0) base_total = total_ns;
+
+            printf("%-4d %6d %10.0f %10.0f %12.0f %12.0f %8.2f %8.4f\n", ch, n, split_ns, copy_ns, dsp_ns,
+                   total_ns, total_ns / base_total, total_ns / frame_ns * 100.0);
+        }
+    }
+
+    printf("memory: fft_proc_t %u bytes per channel; buffers shared: %u pt DMA half, 3 x %u pt DSP scratch\n",
+           (unsigned)sizeof(fft_proc_t), BENCH_NPT_BUF, BENCH_NPT_BUF);
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
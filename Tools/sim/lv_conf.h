@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************************
+ * @file        lv_conf.h
+ * @brief       模擬器用的 LVGL 設定: 沿用板端 lv_conf_cmsis.h, 只改掉依賴硬體的項目
+ ****************************************************************************************************
+ * @attention
+ *
+ * 以 -DLV_CONF_INCLUDE_SIMPLE 編譯 LVGL 時會先找到本檔.
+ * 板端的 LV_MEM_ADR 指向外部 SRAM (0x68000000), 主機上改成 0 => LVGL 使用內部靜態陣列,
+ * LV_MEM_SIZE 不變, 所以 lv_mem 用量與板端可以直接比較.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SIM_LV_CONF_H
+#define __SIM_LV_CONF_H
+
+#include "lv_conf_cmsis.h"
+
+#undef  LV_MEM_ADR
+#define LV_MEM_ADR  0
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ ****************************************************************************************************
+ * @file        sim.h
+ * @brief       主機端 LVGL 模擬器: 記憶體畫面緩衝 + 腳本觸控
+ ****************************************************************************************************
+ * @attention
+ *
+ * sim_disp.c / sim_indev.c 提供與板端同名的 lv_port_disp_init() / lv_port_indev_init(),
+ * 所以 User/lv_mainstart.c 不需任何修改就能在主機上執行.
+ * 時間由 sim_main.c 的虛擬時鐘推進, 與主機速度無關, 同一組參數每次輸出相同畫面.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SIM_H
+#define __SIM_H
+
+#include <stdint.h>
+
+
+#define SIM_HOR_RES         800
+#define SIM_VER_RES         480
+#define SIM_BUF_ROWS        120         /* 與板端 EXT_SRAM_DISP_BUF_ROWS 相同 */
+
+/* 顯示統計 (sim_disp_stats_reset() 之後累計) */
+typedef struct
+{
+    uint32_t refreshes;                 /* 有輸出的畫面更新次數 */
+    uint32_t flushes;                   /* flush_cb 呼叫次數 */
+    uint64_t flush_px;                  /* flush 的像素數 */
+    uint32_t inv_areas;                 /* 失效區域數 */
+    uint64_t inv_px;                    /* 失效區域像素數 (合併前) */
+    uint32_t inv_max_px;                /* 最大的單一失效區域 */
+} sim_disp_stats_t;
+
+extern uint32_t g_sim_tick_ms;          /* 虛擬時鐘 */
+
+/* 顯示 */
+const uint16_t *sim_disp_fb(void);                          /* RGB565, SIM_HOR_RES x SIM_VER_RES */
+const sim_disp_stats_t *sim_disp_stats(void);
+void sim_disp_stats_reset(void);
+int sim_disp_write_ppm(const char *path);                   /* 0: 成功 */
+long sim_disp_compare_ppm(const char *path, int tol);       /* 回傳超出 tol 的像素數, -1: 讀檔失敗 */
+
+/* 觸控 */
+int sim_indev_load(const char *path);                       /* 0: 成功; 未呼叫時使用內建腳本 */
+
+#endif
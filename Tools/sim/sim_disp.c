@@ -0,0 +1,192 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_disp.c
+ * @brief       模擬器顯示: 取代 lv_port_disp_template.c, flush 到記憶體畫面緩衝並統計失效區域
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lv_port_disp_template.h"
+#include "sim.h"
+
+
+static uint16_t s_fb[SIM_HOR_RES * SIM_VER_RES];
+static uint16_t s_buf_1[SIM_HOR_RES * SIM_BUF_ROWS];
+static uint16_t s_buf_2[SIM_HOR_RES * SIM_BUF_ROWS];
+static sim_disp_stats_t s_stats;
+static volatile int s_update_enabled = 1;
+
+
+static void disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map)
+{
+    const uint16_t *src = (const uint16_t *)px_map;
+    int32_t w = lv_area_get_width(area);
+
+    if (s_update_enabled)
+    {
+        for (int32_t y = area->y1; y <= area->y2; y++)
+        {
+            memcpy(&s_fb[y * SIM_HOR_RES + area->x1], src, w * sizeof(uint16_t));
+            src += w;
+        }
+    }
+
+    s_stats.flushes++;
+    s_stats.flush_px += (uint64_t)lv_area_get_size(area);
+    if (lv_display_flush_is_last(disp)) s_stats.refreshes++;
+
+    lv_display_flush_ready(disp);
+}
+
+/* 每個 lv_obj_invalidate() 都會觸發, 合併前的面積才看得出哪個元件重繪太多 */
+static void disp_invalidate_cb(lv_event_t *e)
+{
+    const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+    uint32_t px = (uint32_t)lv_area_get_size(area);
+
+    s_stats.inv_areas++;
+    s_stats.inv_px += px;
+    if (px > s_stats.inv_max_px) s_stats.inv_max_px = px;
+}
+
+void lv_port_disp_init(void)
+{
+    lv_display_t *disp = lv_display_create(SIM_HOR_RES, SIM_VER_RES);
+
+    lv_display_set_flush_cb(disp, disp_flush);
+    lv_display_set_buffers(disp, s_buf_1, s_buf_2, sizeof(s_buf_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(disp, disp_invalidate_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+}
+
+void disp_enable_update(void)
+{
+    s_update_enabled = 1;
+}
+
+void disp_disable_update(void)
+{
+    s_update_enabled = 0;
+}
+
+/* 模擬器沒有 LCD 控制器的捲動暫存器, 瀑布圖走 LVGL canvas 的路徑 (與 NT35510 橫屏相同) */
+uint8_t lv_port_disp_scroll_begin(int32_t y, int32_t h)
+{
+    (void)y;
+    (void)h;
+    return 1;
+}
+
+void lv_port_disp_scroll_end(void)
+{
+}
+
+void lv_port_disp_scroll_write(uint16_t line, const uint16_t *px, uint16_t lines)
+{
+    (void)line;
+    (void)px;
+    (void)lines;
+}
+
+void lv_port_disp_scroll_to(uint16_t line)
+{
+    (void)line;
+}
+
+const uint16_t *sim_disp_fb(void)
+{
+    return s_fb;
+}
+
+const sim_disp_stats_t *sim_disp_stats(void)
+{
+    return &s_stats;
+}
+
+void sim_disp_stats_reset(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+/* RGB565 => RGB888 (高位複製到低位, 0x1F => 0xFF) */
+static void rgb565_to_888(uint16_t c, uint8_t *rgb)
+{
+    uint8_t r = (c >> 11) & 0x1F;
+    uint8_t g = (c >> 5) & 0x3F;
+    uint8_t b = c & 0x1F;
+
+    rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+    rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+    rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+/**
+ * @brief       把畫面緩衝寫成二進位 PPM (P6)
+ * @param       path: 檔名
+ * @retval      0: 成功; 1: 失敗
+ */
+int sim_disp_write_ppm(const char *path)
+{
+    FILE *fp = fopen(path, "wb");
+    uint8_t rgb[3];
+
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    fprintf(fp, "P6\n%d %d\n255\n", SIM_HOR_RES, SIM_VER_RES);
+    for (int i = 0; i < SIM_HOR_RES * SIM_VER_RES; i++)
+    {
+        rgb565_to_888(s_fb[i], rgb);
+        fwrite(rgb, 1, 3, fp);
+    }
+
+    return fclose(fp) == 0 ? 0 : 1;
+}
+
+/**
+ * @brief       與黃金影像 (sim_disp_write_ppm() 產生的 P6) 比對
+ * @param       path: 黃金影像
+ * @param       tol : 每個色彩通道允許的差值
+ * @retval      超出 tol 的像素數; -1: 讀檔失敗或尺寸不符
+ */
+long sim_disp_compare_ppm(const char *path, int tol)
+{
+    FILE *fp = fopen(path, "rb");
+    int w = 0, h = 0, maxval = 0;
+    long diff = 0;
+    uint8_t ref[3], cur[3];
+
+    if (fp == NULL)
+    {
+        return -1;
+    }
+
+    if (fscanf(fp, "P6 %d %d %d", &w, &h, &maxval) != 3 || w != SIM_HOR_RES || h != SIM_VER_RES || maxval != 255)
+    {
+        fclose(fp);
+        return -1;
+    }
+    fgetc(fp);      /* 標頭後的單一空白 */
+
+    for (int i = 0; i < SIM_HOR_RES * SIM_VER_RES; i++)
+    {
+        if (fread(ref, 1, 3, fp) != 3)
+        {
+            fclose(fp);
+            return -1;
+        }
+
+        rgb565_to_888(s_fb[i], cur);
+        if (abs(ref[0] - cur[0]) > tol || abs(ref[1] - cur[1]) > tol || abs(ref[2] - cur[2]) > tol)
+        {
+            diff++;
+        }
+    }
+
+    fclose(fp);
+    return diff;
+}
@@ -0,0 +1,125 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_indev.c
+ * @brief       模擬器觸控: 取代 lv_port_indev_template.c (tp_dev.scan), 依腳本回報觸點
+ ****************************************************************************************************
+ * @attention
+ *
+ * 腳本每行一個事件, '#' 開頭為註解:
+ *   t_ms x y p      在虛擬時間 t_ms 按下 (或移動到) x, y
+ *   t_ms x y r      在虛擬時間 t_ms 於 x, y 放開
+ * t_ms 必須遞增. 未載入腳本時使用 s_default_script (依序點選三個模式並拖動點數滑桿).
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lvgl.h"
+#include "lv_port_indev_template.h"
+#include "sim.h"
+
+
+#define SIM_INDEV_MAX_EVENTS    1024
+
+typedef struct
+{
+    uint32_t t_ms;
+    int16_t  x;
+    int16_t  y;
+    uint8_t  pressed;
+} sim_touch_t;
+
+/* 座標對應 lv_mainstart.c 的版面: 模式選擇在左上, 滑桿在底部 (寬 700, 置中) */
+static const sim_touch_t s_default_script[] =
+{
+    { 1000,  25,  25, 1 }, { 1100,  25,  25, 0 },      /* FFT */
+    { 2000,  25,  65, 1 }, { 2100,  25,  65, 0 },      /* Wave */
+    { 3000,  25, 105, 1 }, { 3100,  25, 105, 0 },      /* Both */
+    { 4000, 745, 452, 1 }, { 4100, 600, 452, 1 },      /* 點數滑桿 100% => 約 30% => 100% */
+    { 4200, 400, 452, 1 }, { 4300, 260, 452, 1 },
+    { 4400, 260, 452, 0 },
+    { 5500, 745, 452, 1 }, { 5600, 745, 452, 0 },
+};
+
+static sim_touch_t s_events[SIM_INDEV_MAX_EVENTS];
+static const sim_touch_t *s_script = s_default_script;
+static uint32_t s_count = sizeof(s_default_script) / sizeof(s_default_script[0]);
+
+
+/**
+ * @brief       載入觸控腳本
+ * @param       path: 檔名
+ * @retval      0: 成功; 1: 讀檔失敗或格式錯誤
+ */
+int sim_indev_load(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    char line[128];
+    uint32_t n = 0;
+
+    if (fp == NULL)
+    {
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL && n < SIM_INDEV_MAX_EVENTS)
+    {
+        unsigned long t;
+        int x, y;
+        char st;
+
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+
+        if (sscanf(line, "%lu %d %d %c", &t, &x, &y, &st) != 4 || (st != 'p' && st != 'r'))
+        {
+            fclose(fp);
+            return 1;
+        }
+
+        s_events[n].t_ms    = (uint32_t)t;
+        s_events[n].x       = (int16_t)x;
+        s_events[n].y       = (int16_t)y;
+        s_events[n].pressed = (st == 'p');
+        n++;
+    }
+
+    fclose(fp);
+    s_script = s_events;
+    s_count  = n;
+    return 0;
+}
+
+/* 回報時間已到的最後一個事件 */
+static void touchpad_read(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    static uint32_t next = 0;
+    static int16_t last_x = 0;
+    static int16_t last_y = 0;
+    static uint8_t pressed = 0;
+
+    (void)indev;
+
+    while (next < s_count && s_script[next].t_ms <= g_sim_tick_ms)
+    {
+        last_x  = s_script[next].x;
+        last_y  = s_script[next].y;
+        pressed = s_script[next].pressed;
+        next++;
+    }
+
+    data->point.x = last_x;
+    data->point.y = last_y;
+    data->state   = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+void lv_port_indev_init(void)
+{
+    lv_indev_t *indev = lv_indev_create();
+
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, touchpad_read);
+}
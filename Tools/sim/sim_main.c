@@ -0,0 +1,420 @@
+/**
+ ****************************************************************************************************
+ * @file        sim_main.c
+ * @brief       主機端 LVGL 模擬器: 板端介面 (lv_mainstart.c) + 合成訊號 => 記憶體畫面緩衝
+ ****************************************************************************************************
+ * @attention
+ *
+ * 不需要開發板就能量測介面每次更新的耗時, 失效區域大小與 lv_mem 用量, 並做黃金影像比對.
+ * 使用者端的 LVGL 來源需與 RTE 相同版本 (v9.3), 設定沿用 lv_conf_cmsis.h (見 Tools/sim/lv_conf.h).
+ *
+ * 編譯 (Linux, 在 Tools/sim/ 目錄下, LVGL_DIR 為 lvgl 原始碼根目錄):
+ *   gcc -std=gnu99 -O2 -DLV_CONF_INCLUDE_SIMPLE -DLV_LVGL_H_INCLUDE_SIMPLE \
+ *       -I. -I../host -I../../User -I../../Projects/MDK-ARM/RTE/LVGL -I../../Projects/MDK-ARM/RTE/_LVGL \
+ *       -I$LVGL_DIR -o lv_sim sim_main.c sim_disp.c sim_indev.c \
+ *       ../../User/lv_mainstart.c ../../User/wave_decim.c ../../User/frame_queue.c \
+ *       ../../User/fft_proc.c ../../User/peak_detect.c ../../User/spec_avg.c ../../User/waterfall.c \
+ *       ../../User/adc_convert.c ../../User/adc_synth.c \
+ *       ../../User/profiler.c ../host/arm_math_host.c \
+ *       $(find $LVGL_DIR/src -name '*.c') \
+ *       -Wl,--wrap=lv_malloc_core,--wrap=lv_realloc_core,--wrap=lv_free_core \
+ *       -Wl,--wrap=lv_obj_invalidate,--wrap=lv_scale_create,--wrap=lv_scale_set_range,--wrap=lv_obj_delete -lm
+ *
+ * 選項:
+ *   -d ms            模擬時間 (預設 8000)
+ *   -s script        觸控腳本 (格式見 sim_indev.c, 預設為內建腳本)
+ *   -t freq:amp      加入正弦波 (V 峰值), 可重複; 未指定時為 440Hz:1.0
+ *   -w rms           高斯雜訊 RMS (V)
+ *   -a mode          頻譜平均: off / linear / exp / max-hold / min-hold (預設 off, 板端以 WK_UP 切換)
+ *   -o out.ppm       結束時輸出畫面
+ *   -g golden.ppm    與黃金影像比對, 有差異時回傳 1
+ *   -T tol           比對時每個色彩通道允許的差值 (預設 0)
+ *   -v               每幀 (NPT / fs) 輸出 CSV:
+ *                    t_ms,handler_us,refreshes,flush_px,inv_areas,inv_px,inv_max_px,mem_used,allocs,
+ *                    obj_inv,scale_new,scale_range,obj_del
+ *
+ * obj_inv / scale_new / scale_range / obj_del 為 lv_obj_invalidate(), lv_scale_create(),
+ * lv_scale_set_range(), lv_obj_delete() 的呼叫次數 (以 -Wl,--wrap 攔截, 只算跨檔呼叫,
+ * 即介面程式與 LVGL 其他模組發出的; 同一檔內的呼叫不經過 wrap). 刻度每次建立或改範圍
+ * 都要重新產生刻度與標籤並整塊重繪, scale_new + scale_range 即刻度重新排版的次數.
+ * 結束時另印出每次介面更新 (PROF_ZONE_UI_UPDATE) 的平均值.
+ * 時間由虛擬時鐘推進 (每圈 5ms, 與板端主迴圈相同), 畫面內容與主機速度無關.
+ * 耗時為主機時間, 只適合在同一台主機上比較不同版本.
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lv_mainstart.h"
+#include "frame_queue.h"
+#include "fft_proc.h"
+#include "peak_detect.h"
+#include "spec_avg.h"
+#include "waterfall.h"
+#include "adc_synth.h"
+#include "profiler.h"
+#include "sim.h"
+
+
+#define SIM_STEP_MS     5
+#define SIM_NPT         1024        /* 與板端 NPT 相同 */
+#define SIM_FS          2000.0f     /* 與板端 Samples 相同 */
+#define SIM_FFT_LOW     250.0f      /* 與板端 g_fft_low / g_fft_high 相同 */
+#define SIM_FFT_HIGH    650.0f
+
+uint32_t g_sim_tick_ms;
+
+static frame_queue_t s_spec_queue;
+static fft_proc_t    s_fft;
+static peak_detect_cfg_t s_peak_cfg;
+static spec_avg_t    s_avg;
+static float         s_avg_acc[SIM_NPT / 2 + 1];
+static uint8_t       s_wf_index[WATERFALL_ROWS * WATERFALL_COLS];
+static uint16_t      s_wf_rgb[WATERFALL_ROWS * WATERFALL_COLS];
+static adc_synth_t   s_synth;
+static uint16_t      s_wave[SIM_NPT];
+static float         s_fft_in[SIM_NPT];
+static float         s_fft_out[SIM_NPT];
+static float         s_fft_win[SIM_NPT];
+
+/* lv_mem 配置次數 (以 -Wl,--wrap 攔截 builtin 配置器) */
+static uint32_t s_alloc_count;
+static uint32_t s_free_count;
+
+/* 失效與刻度重新排版次數 (同樣以 -Wl,--wrap 攔截) */
+typedef struct
+{
+    uint32_t obj_inv;
+    uint32_t scale_new;
+    uint32_t scale_range;
+    uint32_t obj_del;
+} sim_ui_calls_t;
+
+static sim_ui_calls_t s_calls;
+
+
+void *__real_lv_malloc_core(size_t size);
+void *__real_lv_realloc_core(void *p, size_t new_size);
+void __real_lv_free_core(void *p);
+
+void *__wrap_lv_malloc_core(size_t size)
+{
+    s_alloc_count++;
+    return __real_lv_malloc_core(size);
+}
+
+void *__wrap_lv_realloc_core(void *p, size_t new_size)
+{
+    s_alloc_count++;
+    return __real_lv_realloc_core(p, new_size);
+}
+
+void __wrap_lv_free_core(void *p)
+{
+    s_free_count++;
+    __real_lv_free_core(p);
+}
+
+void __real_lv_obj_invalidate(const lv_obj_t *obj);
+lv_obj_t *__real_lv_scale_create(lv_obj_t *parent);
+void __real_lv_scale_set_range(lv_obj_t *obj, int32_t min, int32_t max);
+void __real_lv_obj_delete(lv_obj_t *obj);
+
+void __wrap_lv_obj_invalidate(const lv_obj_t *obj)
+{
+    s_calls.obj_inv++;
+    __real_lv_obj_invalidate(obj);
+}
+
+lv_obj_t *__wrap_lv_scale_create(lv_obj_t *parent)
+{
+    s_calls.scale_new++;
+    return __real_lv_scale_create(parent);
+}
+
+void __wrap_lv_scale_set_range(lv_obj_t *obj, int32_t min, int32_t max)
+{
+    s_calls.scale_range++;
+    __real_lv_scale_set_range(obj, min, max);
+}
+
+void __wrap_lv_obj_delete(lv_obj_t *obj)
+{
+    s_calls.obj_del++;
+    __real_lv_obj_delete(obj);
+}
+
+static uint32_t sim_tick_get(void)
+{
+    return g_sim_tick_ms;
+}
+
+static const uint16_t *sim_wave_frame(uint16_t *len)
+{
+    *len = SIM_NPT;
+    return s_wave;
+}
+
+static const ui_source_t s_ui_source =
+{
+    &s_spec_queue,
+    sim_wave_frame,
+    s_wf_index,
+    s_wf_rgb,
+    1,
+};
+
+/* 與板端 PendSV + FFT_Calc() 相同的處理, 只是輸入換成合成訊號, 不送遙測 */
+static void sim_acquire(void)
+{
+    uint16_t bin_start, bin_end;
+    fft_peak_t peak;
+
+    adc_synth_fill(&s_synth, s_wave, SIM_NPT);
+
+    PROF_BEGIN(PROF_ZONE_FFT_TOTAL);
+    fft_proc_load_u16(&s_fft, s_wave);
+    fft_proc_bin_range(&s_fft, SIM_FS, SIM_FFT_LOW, SIM_FFT_HIGH, &bin_start, &bin_end);
+    fft_proc_spectrum_range(&s_fft, bin_start, bin_end);
+
+    PROF_BEGIN(PROF_ZONE_AVG);
+    spec_avg_apply(&s_avg, s_fft.mag, bin_start, bin_end);
+    PROF_END(PROF_ZONE_AVG);
+
+    PROF_BEGIN(PROF_ZONE_PEAK);
+    fft_proc_find_peak(&s_fft, SIM_FS, bin_start, bin_end, &peak);
+    PROF_END(PROF_ZONE_PEAK);
+
+    spec_frame_t *frame = frame_queue_begin_write(&s_spec_queue);
+    if (frame != NULL)
+    {
+        frame->count     = fft_proc_decimate_max(&s_fft, bin_start, bin_end, frame->db,
+                                                 SPEC_FRAME_MAX_BINS, &frame->bin_step);
+        fft_proc_to_db(&s_fft, frame->db, frame->db, frame->count);
+        frame->channel   = 0;
+        frame->bin_start = bin_start;
+        frame->bin_end   = bin_end;
+        frame->freq_start = bin_start * SIM_FS / SIM_NPT;
+        frame->freq_step  = SIM_FS / SIM_NPT * frame->bin_step;
+        frame->max_val   = peak.value;
+        frame->max_freq  = peak.freq;
+
+        /* 峰值標記, 與板端 fft_fill_peaks() 相同 */
+        peak_detect_t found[PEAK_DETECT_MAX];
+        float db[PEAK_DETECT_MAX];
+
+        PROF_BEGIN(PROF_ZONE_PEAKS);
+        uint8_t n = peak_detect_run(&s_peak_cfg, s_fft.mag, bin_start, bin_end, found);
+        for (uint8_t i = 0; i < n; i++)
+        {
+            fft_proc_refine_peak(&s_fft, SIM_FS, bin_start, bin_end, found[i].bin, &peak);
+            frame->peaks[i].pos  = (float)(peak.index - bin_start) + peak.offset;
+            frame->peaks[i].freq = peak.freq;
+            db[i] = peak.value;
+        }
+        fft_proc_to_db(&s_fft, db, db, n);
+        for (uint8_t i = 0; i < n; i++) frame->peaks[i].db = db[i];
+        frame->peak_count = n;
+        PROF_END(PROF_ZONE_PEAKS);
+
+        frame->avg_mode  = (uint8_t)s_avg.mode;
+        frame->avg_count = s_avg.count;
+
+        frame_queue_commit(&s_spec_queue);
+    }
+    PROF_END(PROF_ZONE_FFT_TOTAL);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-d ms] [-s script] [-t freq:amp]... [-w rms] [-a mode] "
+                    "[-o out.ppm] [-g golden.ppm] [-T tol] [-v]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t duration = 8000;
+    const char *script = NULL;
+    const char *out_ppm = NULL;
+    const char *golden = NULL;
+    int tol = 0;
+    int verbose = 0;
+    float tone_f[ADC_SYNTH_MAX_TONES];
+    float tone_a[ADC_SYNTH_MAX_TONES];
+    int tones = 0;
+    float noise = 0.0f;
+    spec_avg_mode_t avg_mode = SPEC_AVG_OFF;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(a, "-v") == 0)
+        {
+            verbose = 1;
+            continue;
+        }
+
+        if (v == NULL) usage(argv[0]);
+        i++;
+
+        if      (strcmp(a, "-d") == 0) duration = (uint32_t)atol(v);
+        else if (strcmp(a, "-s") == 0) script = v;
+        else if (strcmp(a, "-o") == 0) out_ppm = v;
+        else if (strcmp(a, "-g") == 0) golden = v;
+        else if (strcmp(a, "-T") == 0) tol = atoi(v);
+        else if (strcmp(a, "-w") == 0) noise = (float)atof(v);
+        else if (strcmp(a, "-a") == 0)
+        {
+            for (avg_mode = SPEC_AVG_OFF; avg_mode < SPEC_AVG_COUNT; avg_mode++)
+            {
+                if (strcmp(v, spec_avg_mode_name(avg_mode)) == 0) break;
+            }
+            if (avg_mode == SPEC_AVG_COUNT) usage(argv[0]);
+        }
+        else if (strcmp(a, "-t") == 0)
+        {
+            if (tones >= ADC_SYNTH_MAX_TONES || sscanf(v, "%f:%f", &tone_f[tones], &tone_a[tones]) != 2) usage(argv[0]);
+            tones++;
+        }
+        else usage(argv[0]);
+    }
+
+    if (tones == 0)
+    {
+        tone_f[0] = 440.0f;
+        tone_a[0] = 1.0f;
+        tones = 1;
+    }
+
+    if (script != NULL && sim_indev_load(script) != 0)
+    {
+        fprintf(stderr, "cannot load touch script %s\n", script);
+        return 2;
+    }
+
+    fft_proc_init(&s_fft, SIM_NPT, s_fft_in, s_fft_out, s_fft_win);
+    fft_proc_set_window(&s_fft, FFT_WIN_HANN);      /* 與板端預設相同 */
+    s_fft.interp = FFT_INTERP_JACOBSEN;
+    peak_detect_default(&s_peak_cfg);
+    spec_avg_init(&s_avg, s_avg_acc, SIM_NPT / 2 + 1);
+    spec_avg_set_mode(&s_avg, avg_mode);
+    frame_queue_init(&s_spec_queue);
+    adc_synth_init(&s_synth, SIM_FS);
+    for (int i = 0; i < tones; i++) adc_synth_add_tone(&s_synth, tone_f[i], tone_a[i]);
+    if (noise > 0.0f) adc_synth_set_noise(&s_synth, noise, 1);
+
+    prof_init();
+
+    lv_mainstart_init(&s_ui_source);
+    lv_tick_set_cb(sim_tick_get);
+
+    uint32_t frame_ms = (uint32_t)(SIM_NPT * 1000.0f / SIM_FS);
+    uint32_t next_acq = frame_ms;
+    uint32_t init_allocs = s_alloc_count;
+    lv_mem_monitor_t mon;
+
+    if (verbose) printf("t_ms,handler_us,refreshes,flush_px,inv_areas,inv_px,inv_max_px,mem_used,allocs,"
+                        "obj_inv,scale_new,scale_range,obj_del\n");
+
+    sim_disp_stats_reset();
+
+    uint32_t win_allocs = s_alloc_count;
+    uint64_t win_ticks = 0;
+    sim_ui_calls_t init_calls = s_calls;
+    sim_ui_calls_t win_calls = s_calls;
+
+    while (g_sim_tick_ms < duration)
+    {
+        g_sim_tick_ms += SIM_STEP_MS;
+
+        if (g_sim_tick_ms >= next_acq)
+        {
+            next_acq += frame_ms;
+
+            if (verbose)
+            {
+                const sim_disp_stats_t *st = sim_disp_stats();
+
+                lv_mem_monitor(&mon);
+                printf("%lu,%.1f,%lu,%llu,%lu,%llu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", (unsigned long)g_sim_tick_ms,
+                       win_ticks * 1e6 / prof_tick_hz(), (unsigned long)st->refreshes,
+                       (unsigned long long)st->flush_px, (unsigned long)st->inv_areas,
+                       (unsigned long long)st->inv_px, (unsigned long)st->inv_max_px,
+                       (unsigned long)(mon.total_size - mon.free_size),
+                       (unsigned long)(s_alloc_count - win_allocs),
+                       (unsigned long)(s_calls.obj_inv - win_calls.obj_inv),
+                       (unsigned long)(s_calls.scale_new - win_calls.scale_new),
+                       (unsigned long)(s_calls.scale_range - win_calls.scale_range),
+                       (unsigned long)(s_calls.obj_del - win_calls.obj_del));
+                sim_disp_stats_reset();
+                win_allocs = s_alloc_count;
+                win_calls = s_calls;
+                win_ticks = 0;
+            }
+
+            sim_acquire();
+        }
+
+        uint32_t t0 = prof_now();
+        lv_timer_handler();
+        uint32_t dt = prof_now() - t0;
+
+        prof_record(PROF_ZONE_LV_HANDLER, dt);
+        win_ticks += dt;
+    }
+
+    lv_mem_monitor(&mon);
+
+    fprintf(stderr, "simulated %lu ms, %lu spectrum frames (queue dropped %lu)\n",
+            (unsigned long)g_sim_tick_ms, (unsigned long)s_spec_queue.next_seq,
+            (unsigned long)s_spec_queue.dropped);
+    fprintf(stderr, "lv_mem: total %lu, used %lu, max used %lu, frag %u%%, biggest free %lu\n",
+            (unsigned long)mon.total_size, (unsigned long)(mon.total_size - mon.free_size),
+            (unsigned long)mon.max_used, (unsigned)mon.frag_pct, (unsigned long)mon.free_biggest_size);
+    fprintf(stderr, "lv_mem allocs: %lu during init, %lu after (%lu frees total)\n",
+            (unsigned long)init_allocs, (unsigned long)(s_alloc_count - init_allocs),
+            (unsigned long)s_free_count);
+
+    uint32_t updates = prof_get(PROF_ZONE_UI_UPDATE)->count;
+    double per = (updates > 0) ? 1.0 / updates : 0.0;
+
+    fprintf(stderr, "per UI update (%lu): lv_obj_invalidate %.2f, scale create %.2f, scale set_range %.2f, "
+                    "lv_obj_delete %.2f\n", (unsigned long)updates,
+            (s_calls.obj_inv - init_calls.obj_inv) * per, (s_calls.scale_new - init_calls.scale_new) * per,
+            (s_calls.scale_range - init_calls.scale_range) * per, (s_calls.obj_del - init_calls.obj_del) * per);
+
+    prof_print();
+
+    int fail = 0;
+
+    if (out_ppm != NULL && sim_disp_write_ppm(out_ppm) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", out_ppm);
+        fail = 1;
+    }
+
+    if (golden != NULL)
+    {
+        long diff = sim_disp_compare_ppm(golden, tol);
+
+        if (diff < 0)
+        {
+            fprintf(stderr, "cannot read golden image %s\n", golden);
+            fail = 1;
+        }
+        else
+        {
+            fprintf(stderr, "golden %s: %ld pixels differ (tol %d)\n", golden, diff, tol);
+            fail |= (diff != 0);
+        }
+    }
+
+    fprintf(stderr, "%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,336 @@
+/**
+ ****************************************************************************************************
+ * @file        telem_decode.c
+ * @brief       主機端遙測解碼器: 讀取 UART1 擷取的位元組流, 輸出 CSV
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux):
+ *   gcc -std=c99 -O2 -I../User -o telem_decode telem_decode.c ../User/telemetry_codec.c
+ *
+ * 使用:
+ *   stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > capture.bin
+ *   ./telem_decode capture.bin            (或 ./telem_decode < capture.bin)
+ *
+ * 輸出欄位: seq,timestamp_ms,peak_freq,peak_amp,bin_start,bin_end
+ * PROF 封包 (profiler 區段統計) 以 "# prof ..." 印在 stderr, 時間換算成 us.
+ * TONE 封包 (固定頻率追蹤) 以 "# tone seq=... freq:amp:phase ..." 印在 stderr.
+ * 結尾在 stderr 印出統計: 有效幀數, 序號缺口, COBS/CRC 錯誤, 超長幀.
+ *
+ * 自我檢查 (fixture 為固定內容的 PEAK/PROF/TONE 位元組流, 已放在 Tools/telem_fixture.bin):
+ *   ./telem_decode -g telem_fixture.bin   重新產生 fixture (封包格式變更後)
+ *   ./telem_decode -c telem_fixture.bin   解碼並逐欄比對, 失敗回傳 1
+ * fixture 依序為:
+ *   從一幀中間開始的殘段 (擷取途中才接上) => PEAK 100 => TONE 100 => PROF
+ *   => PEAK 101 (CRC 錯) => PEAK 102 (只收到前 12 位元組就遇到 0x00, 截斷)
+ *   => PEAK 103 => TONE 103 => 超長雜訊 => PEAK 104
+ * 檢查項目: 6 個有效封包的每個欄位都與產生時相同 (順序也相同), bad_frame == 3, overflow == 1,
+ *   unknown == 0, PEAK 序號缺口 == 1 (100 => 103); 亦即錯誤幀之後的下一幀都能重新同步.
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "telemetry_codec.h"
+
+
+/* fixture 中的有效封包 (產生與檢查共用同一份) */
+typedef struct
+{
+    uint8_t      type;          /* TELEM_TYPE_xxx */
+    telem_peak_t pk;
+    telem_prof_t pr;
+    telem_tone_t tn;
+} fixture_pkt_t;
+
+static const fixture_pkt_t s_fixture[] =
+{
+    { TELEM_TYPE_PEAK, { 100, 5000, 1000.0f, 0.8125f, 2, 510 }, { 0 }, { 0 } },
+    { TELEM_TYPE_TONE, { 0 }, { 0 }, { 100, 5000, 2, { 50.0f, 1000.0f }, { 1.5f, 0.25f }, { -0.5f, 3.0f } } },
+    { TELEM_TYPE_PROF, { 0 }, { 5, 1234, 80000, 125000, 98765, 168000000,
+                              { 0, 1, 2, 3, 400, 65535, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7 } }, { 0 } },
+    { TELEM_TYPE_PEAK, { 103, 5150, 440.25f, 1.5f, 0, 0 }, { 0 }, { 0 } },
+    { TELEM_TYPE_TONE, { 0 }, { 0 }, { 103, 5150, 4, { 50.0f, 100.0f, 150.0f, 440.25f },
+                                       { 0.0f, 1.0f, 2.0f, 3.0f }, { 0.125f, -3.0f, 0.0f, 1.0f } } },
+    { TELEM_TYPE_PEAK, { 104, 5200, 0.0f, 0.0f, 65535, 0 }, { 0 }, { 0 } },
+};
+
+#define FIXTURE_COUNT           (sizeof(s_fixture) / sizeof(s_fixture[0]))
+#define FIXTURE_BAD_FRAME       3   /* 開頭殘段, CRC 錯, 截斷 */
+#define FIXTURE_OVERFLOW        1
+#define FIXTURE_SEQ_GAPS        1
+
+
+static uint16_t encode_pkt(const fixture_pkt_t *f, uint8_t *frame)
+{
+    if (f->type == TELEM_TYPE_PROF) return telem_encode_prof(&f->pr, frame);
+    if (f->type == TELEM_TYPE_TONE) return telem_encode_tone(&f->tn, frame);
+    return telem_encode_peak(&f->pk, frame);
+}
+
+/**
+ * @brief       產生 fixture
+ * @param       path: 輸出檔
+ * @retval      0: 成功; 1: 無法寫入
+ */
+static int fixture_write(const char *path)
+{
+    uint8_t frame[TELEM_FRAME_MAX];
+    uint8_t raw[TELEM_FRAME_MAX];
+    uint16_t n;
+    telem_peak_t pk = { 99, 4950, 999.0f, 0.5f, 2, 510 };
+    FILE *fp = fopen(path, "wb");
+
+    if (fp == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+
+    /* 從一幀中間開始 */
+    n = telem_encode_peak(&pk, frame);
+    fwrite(frame + 6, 1, n - 6, fp);
+
+    for (unsigned i = 0; i < 3; i++)
+    {
+        fwrite(frame, 1, encode_pkt(&s_fixture[i], frame), fp);
+    }
+
+    /* PEAK 101: 解出 payload + CRC 後把 CRC 改錯再編回去 (COBS 結構仍正確, 只有 CRC 不符) */
+    pk.seq = 101;
+    pk.timestamp_ms = 5050;
+    n = telem_encode_peak(&pk, frame);
+    n = cobs_decode(frame, n - 1, raw);
+    raw[n - 1] ^= 0x5A;
+    n = cobs_encode(raw, n, frame);
+    frame[n++] = 0x00;
+    fwrite(frame, 1, n, fp);
+
+    /* PEAK 102: 中途斷線, 只有前 12 位元組 */
+    pk.seq = 102;
+    pk.timestamp_ms = 5100;
+    telem_encode_peak(&pk, frame);
+    frame[12] = 0x00;
+    fwrite(frame, 1, 13, fp);
+
+    for (unsigned i = 3; i < 5; i++)
+    {
+        fwrite(frame, 1, encode_pkt(&s_fixture[i], frame), fp);
+    }
+
+    /* 超過 TELEM_FRAME_MAX 的雜訊 */
+    memset(raw, 0x55, sizeof(raw));
+    fwrite(raw, 1, sizeof(raw), fp);
+    fwrite(raw, 1, 8, fp);
+    fputc(0x00, fp);
+
+    fwrite(frame, 1, encode_pkt(&s_fixture[5], frame), fp);
+
+    fclose(fp);
+    return 0;
+}
+
+static int same_pkt(const fixture_pkt_t *f, const uint8_t *payload, uint16_t n)
+{
+    telem_peak_t pk;
+    telem_prof_t pr;
+    telem_tone_t tn;
+
+    if (f->type == TELEM_TYPE_PROF)
+    {
+        return telem_parse_prof(payload, n, &pr) == 0 && pr.zone == f->pr.zone && pr.count == f->pr.count &&
+               pr.min == f->pr.min && pr.max == f->pr.max && pr.mean == f->pr.mean &&
+               pr.tick_hz == f->pr.tick_hz && memcmp(pr.hist, f->pr.hist, sizeof(pr.hist)) == 0;
+    }
+
+    if (f->type == TELEM_TYPE_TONE)
+    {
+        if (telem_parse_tone(payload, n, &tn) != 0 || tn.seq != f->tn.seq ||
+            tn.timestamp_ms != f->tn.timestamp_ms || tn.count != f->tn.count)
+        {
+            return 0;
+        }
+        for (int i = 0; i < tn.count; i++)
+        {
+            if (tn.freq[i] != f->tn.freq[i] || tn.amp[i] != f->tn.amp[i] || tn.phase[i] != f->tn.phase[i])
+            {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    return telem_parse_peak(payload, n, &pk) == 0 && pk.seq == f->pk.seq &&
+           pk.timestamp_ms == f->pk.timestamp_ms && pk.peak_freq == f->pk.peak_freq &&
+           pk.peak_amp == f->pk.peak_amp && pk.bin_start == f->pk.bin_start && pk.bin_end == f->pk.bin_end;
+}
+
+/**
+ * @brief       解碼 fixture 並比對
+ * @param       path: fixture 檔
+ * @retval      0: PASS; 1: FAIL
+ */
+static int fixture_check(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    telem_decoder_t dec;
+    uint8_t payload[TELEM_FRAME_MAX];
+    telem_peak_t pk;
+    unsigned got = 0;
+    unsigned mismatch = 0;
+    unsigned long gaps = 0;
+    uint32_t last_seq = 0;
+    int have_seq = 0;
+    int fail;
+    int c;
+
+    if (fp == NULL)
+    {
+        perror(path);
+        return 1;
+    }
+
+    telem_decoder_init(&dec);
+
+    while ((c = fgetc(fp)) != EOF)
+    {
+        uint16_t n = telem_decoder_feed(&dec, (uint8_t)c, payload);
+
+        if (n == 0)
+        {
+            continue;
+        }
+
+        if (got >= FIXTURE_COUNT || !same_pkt(&s_fixture[got], payload, n))
+        {
+            printf("packet %u: mismatch (type 0x%02X, %u bytes)\n", got, payload[0], n);
+            mismatch++;
+        }
+
+        if (telem_parse_peak(payload, n, &pk) == 0)
+        {
+            if (have_seq && pk.seq != last_seq + 1)
+            {
+                gaps++;
+            }
+            last_seq = pk.seq;
+            have_seq = 1;
+        }
+        got++;
+    }
+    fclose(fp);
+
+    printf("packets %u/%u, mismatches %u, bad_frame %lu/%u, overflow %lu/%u, seq_gaps %lu/%u\n",
+           got, (unsigned)FIXTURE_COUNT, mismatch, (unsigned long)dec.bad_frame, FIXTURE_BAD_FRAME,
+           (unsigned long)dec.overflow, FIXTURE_OVERFLOW, gaps, FIXTURE_SEQ_GAPS);
+
+    fail = got != FIXTURE_COUNT || mismatch != 0 || dec.bad_frame != FIXTURE_BAD_FRAME ||
+           dec.overflow != FIXTURE_OVERFLOW || gaps != FIXTURE_SEQ_GAPS;
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *fp = stdin;
+    telem_decoder_t dec;
+    uint8_t payload[TELEM_FRAME_MAX];
+    telem_peak_t pk;
+    telem_prof_t pr;
+    telem_tone_t tn;
+    unsigned long frames = 0;
+    unsigned long gaps = 0;
+    unsigned long unknown = 0;
+    uint32_t last_seq = 0;
+    int c;
+
+    if (argc == 3 && strcmp(argv[1], "-g") == 0)
+    {
+        return fixture_write(argv[2]);
+    }
+
+    if (argc == 3 && strcmp(argv[1], "-c") == 0)
+    {
+        return fixture_check(argv[2]);
+    }
+
+    if (argc > 1)
+    {
+        fp = fopen(argv[1], "rb");
+
+        if (fp == NULL)
+        {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    telem_decoder_init(&dec);
+    printf("seq,timestamp_ms,peak_freq,peak_amp,bin_start,bin_end\n");
+
+    while ((c = fgetc(fp)) != EOF)
+    {
+        uint16_t n = telem_decoder_feed(&dec, (uint8_t)c, payload);
+
+        if (n == 0)
+        {
+            continue;
+        }
+
+        if (telem_parse_prof(payload, n, &pr) == 0)
+        {
+            double us = 1e6 / (pr.tick_hz ? pr.tick_hz : 1);
+
+            fprintf(stderr, "# prof zone=%u count=%lu min=%.2fus mean=%.2fus max=%.2fus hist=",
+                    pr.zone, (unsigned long)pr.count, pr.min * us, pr.mean * us, pr.max * us);
+
+            for (int i = 0; i < TELEM_PROF_HIST_BINS; i++)
+            {
+                fprintf(stderr, "%u%c", pr.hist[i], i == TELEM_PROF_HIST_BINS - 1 ? '\n' : ' ');
+            }
+            continue;
+        }
+
+        if (telem_parse_tone(payload, n, &tn) == 0)
+        {
+            fprintf(stderr, "# tone seq=%lu", (unsigned long)tn.seq);
+
+            for (int i = 0; i < tn.count; i++)
+            {
+                fprintf(stderr, " %.3f:%.4f:%.4f", tn.freq[i], tn.amp[i], tn.phase[i]);
+            }
+            fprintf(stderr, "\n");
+            continue;
+        }
+
+        if (telem_parse_peak(payload, n, &pk) != 0)
+        {
+            unknown++;
+            continue;
+        }
+
+        if (frames > 0 && pk.seq != last_seq + 1)
+        {
+            gaps++;
+        }
+
+        last_seq = pk.seq;
+        frames++;
+
+        printf("%lu,%lu,%.3f,%.4f,%u,%u\n",
+               (unsigned long)pk.seq, (unsigned long)pk.timestamp_ms,
+               pk.peak_freq, pk.peak_amp, pk.bin_start, pk.bin_end);
+    }
+
+    fprintf(stderr, "frames=%lu seq_gaps=%lu unknown=%lu bad_frame=%lu overflow=%lu\n",
+            frames, gaps, unknown, (unsigned long)dec.bad_frame, (unsigned long)dec.overflow);
+
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,220 @@
+/**
+ ****************************************************************************************************
+ * @file        tone_bench.c
+ * @brief       主機端固定頻率追蹤測試: Goertzel 與雙精度 DTFT / 真值比對, 每幀耗時與整個 FFT 比較
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -Ihost -I../User -o tone_bench tone_bench.c host/arm_math_host.c \
+ *       ../User/tone_bank.c ../User/fft_proc.c ../User/adc_convert.c ../User/adc_synth.c \
+ *       ../User/profiler.c -lm
+ *
+ * 選項:
+ *   -n npt           FFT 點數 (預設 1024)
+ *   -r fs            採樣率 Hz (預設 2000)
+ *   -F frames        比對的幀數 (預設 32)
+ *   -T reps          計時重複次數 (預設 2000)
+ *
+ * 訊號: 437.3Hz 0.8V + 601.7Hz 0.3V (都不在頻點中心) + 0.005V rms 雜訊, Hann 窗.
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 與雙精度 DTFT (同一份 in[]) 比對: 振幅相對誤差 < 1e-4, 相位誤差 < 1e-3 rad
+ *   2. 與合成訊號的真值比對: 振幅誤差 < 1%, 相位誤差 < 0.02 rad
+ *      (同時列出 FFT 最大頻點的幅度, 看 scalloping loss)
+ *
+ * 耗時為主機時間 (ns/幀): tone_bank_run() 追蹤 1 ~ TONE_BANK_MAX 個頻率, 對照
+ * fft_proc_spectrum() (RFFT + 整個頻譜的幅度). 兩者都不含 fft_proc_load_u16().
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tone_bank.h"
+#include "fft_proc.h"
+#include "adc_synth.h"
+#include "profiler.h"
+
+
+#define BENCH_NPT_MAX   FFT_PROC_NPT_MAX
+#define BENCH_PI        3.14159265358979
+
+static uint16_t s_raw[BENCH_NPT_MAX];
+static float    s_in[BENCH_NPT_MAX];
+static float    s_out[BENCH_NPT_MAX];
+static float    s_win[BENCH_NPT_MAX];
+static float    s_x[BENCH_NPT_MAX];         /* 本幀 in[] 的複本 (RFFT 會改寫 in[]) */
+
+static const float s_freq[] = { 437.3f, 601.7f };
+static const float s_amp[]  = { 0.8f, 0.3f };
+
+
+static double wrap_pi(double a)
+{
+    while (a > BENCH_PI)   a -= 2.0 * BENCH_PI;
+    while (a < -BENCH_PI)  a += 2.0 * BENCH_PI;
+    return a;
+}
+
+/* 雙精度 DTFT, 回傳振幅 (2|X|/n) 與相位 */
+static void dtft_ref(const float *x, int n, double freq, double fs, double *amp, double *phase)
+{
+    double re = 0.0, im = 0.0;
+    double w = 2.0 * BENCH_PI * freq / fs;
+
+    for (int k = 0; k < n; k++)
+    {
+        re += x[k] * cos(w * k);
+        im -= x[k] * sin(w * k);
+    }
+
+    *amp   = 2.0 * sqrt(re * re + im * im) / n;
+    *phase = atan2(im, re);
+}
+
+int main(int argc, char *argv[])
+{
+    int npt = 1024;
+    float fs = 2000.0f;
+    int frames = 32;
+    int reps = 2000;
+    int fail = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if      (strcmp(argv[i], "-n") == 0) npt = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0) fs = (float)atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-F") == 0) frames = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-T") == 0) reps = atoi(argv[i + 1]);
+        else
+        {
+            fprintf(stderr, "usage: %s [-n npt] [-r fs] [-F frames] [-T reps]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    fft_proc_t fp;
+    tone_bank_t tb;
+    adc_synth_t gen;
+    tone_result_t res[TONE_BANK_MAX];
+    int tones = (int)(sizeof(s_freq) / sizeof(s_freq[0]));
+
+    if (npt > BENCH_NPT_MAX || fft_proc_init(&fp, BENCH_NPT_MAX, s_in, s_out, s_win) != 0 ||
+        fft_proc_set_npt(&fp, (uint16_t)npt) != 0 || frames < 1 || s_freq[tones - 1] >= fs / 2)
+    {
+        fprintf(stderr, "unsupported npt %d / fs %.0f / frames %d\n", npt, fs, frames);
+        return 2;
+    }
+    fft_proc_set_window(&fp, FFT_WIN_HANN);
+
+    adc_synth_init(&gen, fs);
+    adc_synth_set_noise(&gen, 0.005f, 3);
+    tone_bank_init(&tb, fs, (uint16_t)npt);
+    for (int t = 0; t < tones; t++)
+    {
+        adc_synth_add_tone(&gen, s_freq[t], s_amp[t]);
+        tone_bank_add(&tb, s_freq[t]);
+    }
+
+    /* 1, 2. 逐幀比對 */
+    double ref_amp_err = 0.0, ref_ph_err = 0.0;
+    double true_amp_err[TONE_BANK_MAX] = { 0 }, true_ph_err[TONE_BANK_MAX] = { 0 };
+    double fft_amp_err[TONE_BANK_MAX] = { 0 };
+
+    for (int f = 0; f < frames; f++)
+    {
+        double start_phase[TONE_BANK_MAX];
+
+        for (int t = 0; t < tones; t++)
+        {
+            start_phase[t] = gen.tone[t].phase - BENCH_PI / 2;     /* sin => 餘弦相位 */
+        }
+
+        adc_synth_fill(&gen, s_raw, npt);
+        fft_proc_load_u16(&fp, s_raw);
+        memcpy(s_x, fp.in, npt * sizeof(float));
+        tone_bank_run(&tb, s_x, res);
+        fft_proc_spectrum(&fp);
+
+        for (int t = 0; t < tones; t++)
+        {
+            double amp, phase, e;
+
+            dtft_ref(s_x, npt, s_freq[t], fs, &amp, &phase);
+            e = fabs(res[t].amp - amp) / amp;
+            if (e > ref_amp_err) ref_amp_err = e;
+            e = fabs(wrap_pi(res[t].phase - phase));
+            if (e > ref_ph_err) ref_ph_err = e;
+
+            e = fabs(res[t].amp - s_amp[t]) / s_amp[t];
+            if (e > true_amp_err[t]) true_amp_err[t] = e;
+            e = fabs(wrap_pi(res[t].phase - start_phase[t]));
+            if (e > true_ph_err[t]) true_ph_err[t] = e;
+
+            /* FFT: 最近頻點的幅度 (不插值) */
+            uint32_t k = (uint32_t)(s_freq[t] * npt / fs + 0.5f);
+            e = fabs(fp.mag[k] * 2.0 / npt - s_amp[t]) / s_amp[t];
+            if (e > fft_amp_err[t]) fft_amp_err[t] = e;
+        }
+    }
+
+    printf("vs double DTFT: max amp rel err %.2e, max phase err %.2e rad %s\n", ref_amp_err, ref_ph_err,
+           (ref_amp_err < 1e-4 && ref_ph_err < 1e-3) ? "ok" : "MISMATCH");
+    if (!(ref_amp_err < 1e-4 && ref_ph_err < 1e-3)) fail = 1;
+
+    printf("\n%-10s %8s %14s %14s %16s   (%d frames, Hann, %d pt, %.0f Hz)\n",
+           "tone", "amp", "amp_err_pct", "phase_err_rad", "fft_bin_err_pct", frames, npt, fs);
+    for (int t = 0; t < tones; t++)
+    {
+        printf("%8.1fHz %8.2f %14.3f %14.4f %16.3f\n", s_freq[t], s_amp[t],
+               true_amp_err[t] * 100.0, true_ph_err[t], fft_amp_err[t] * 100.0);
+        if (!(true_amp_err[t] < 0.01 && true_ph_err[t] < 0.02)) fail = 1;
+    }
+
+    /* 耗時: 1 ~ TONE_BANK_MAX 個頻率 vs 整個 FFT */
+    double fft_ns;
+    {
+        uint32_t t0 = prof_now();
+        for (int r = 0; r < reps; r++)
+        {
+            memcpy(fp.in, s_x, npt * sizeof(float));
+            fft_proc_spectrum(&fp);
+        }
+        uint32_t t1 = prof_now();
+        for (int r = 0; r < reps; r++)
+        {
+            memcpy(fp.in, s_x, npt * sizeof(float));
+        }
+        fft_ns = ((double)(uint32_t)(t1 - t0) - (double)(uint32_t)(prof_now() - t1)) / reps;
+    }
+
+    printf("\n%-6s %12s %12s %8s   (ns/frame, host; fft = RFFT + full magnitude)\n",
+           "tones", "goertzel", "fft", "ratio");
+    for (int k = 1; k <= TONE_BANK_MAX; k++)
+    {
+        tone_bank_t bank;
+
+        tone_bank_init(&bank, fs, (uint16_t)npt);
+        for (int t = 0; t < k; t++)
+        {
+            tone_bank_add(&bank, 300.0f + 37.1f * t);
+        }
+
+        uint32_t t0 = prof_now();
+        for (int r = 0; r < reps; r++)
+        {
+            tone_bank_run(&bank, s_x, res);
+        }
+        double ns = (double)(uint32_t)(prof_now() - t0) / reps;
+
+        printf("%-6d %12.0f %12.0f %8.2f\n", k, ns, fft_ns, ns / fft_ns);
+    }
+
+    printf("memory: tone_bank_t %u bytes (%d tones max), no buffers\n",
+           (unsigned)sizeof(tone_bank_t), TONE_BANK_MAX);
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
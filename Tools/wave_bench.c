@@ -0,0 +1,222 @@
+/**
+ ****************************************************************************************************
+ * @file        wave_bench.c
+ * @brief       主機端波形 min / max 抽取測試: 窄脈衝不會遺失, 相鄰欄相連, 不讀超過 src[n-1]
+ ****************************************************************************************************
+ * @attention
+ *
+ * 編譯 (Linux, 在 Tools/ 目錄下):
+ *   gcc -std=c99 -O2 -Ihost -I../User -o wave_bench wave_bench.c ../User/wave_decim.c
+ *
+ * 選項:
+ *   -s seed          亂數種子 (預設 1)
+ *
+ * 點數 FFT_PROC_NPT_MIN ~ FFT_PROC_NPT_MAX 的 2 的冪, 另加 1 / 250 / 1000 點, 與欄數 50 / 117 / 250
+ * (wave_points 的下限, 除不盡的值, 上限) 的每種組合. 第 c 欄的範圍為
+ * src[c*n/cols] ~ src[min((c+1)*n/cols, n-1)], 以此獨立計算預期結果.
+ * 檢查項目 (任一失敗則回傳 1):
+ *   1. 平坦波形上任一位置 k 的單點正 / 負脈衝 (逐一試遍每個 k): 出現在範圍含 k 的欄的 max / min,
+ *      其餘欄不受影響 (範圍只有 k 一點的欄 min = max = 脈衝);
+ *      n >= cols 時第一個含 k 的欄為 k*cols/n, k 剛好是該欄欄首時為前一欄
+ *   2. 亂數波形: 第 c 欄包含前一欄的最後一點 (src[c*n/cols]), 相鄰兩欄的 [min, max] 一定重疊
+ *   3. src[n] 之後放 0 / 4095 交錯的哨兵, dst 之後放哨兵: 輸出不含讀界外的值, 也不寫超過 cols 點
+ *      (cols > n 時多欄重複同一段取樣也成立)
+ *   4. n = FFT_PROC_NPT_MAX, cols = 250 (板端最大的一幀與最多的欄) 包含在上述組合中
+ *
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fft_proc.h"
+#include "wave_decim.h"
+
+
+#define BENCH_COLS_MAX  250         /* 與 lv_mainstart.c 的 WAVE_COLS_MAX 相同 */
+#define BENCH_GUARD     16          /* 界外哨兵點數 */
+#define BENCH_BASE      2048
+#define BENCH_HI        4000
+#define BENCH_LO        100
+
+static uint16_t s_src[FFT_PROC_NPT_MAX + BENCH_GUARD];
+static uint16_t s_min[BENCH_COLS_MAX + BENCH_GUARD];
+static uint16_t s_max[BENCH_COLS_MAX + BENCH_GUARD];
+static uint32_t s_rng;
+
+
+static uint32_t bench_rand(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/* 第 c 欄的範圍 (含兩端) */
+static void col_range(uint32_t n, uint16_t cols, uint16_t c, uint32_t *first, uint32_t *last)
+{
+    *first = (uint32_t)c * n / cols;
+    *last  = (uint32_t)(c + 1) * n / cols;
+    if (*first > n - 1) *first = n - 1;
+    if (*last > n - 1)  *last = n - 1;
+}
+
+/* 界外哨兵: 讀到就會成為 min (0) 或 max (4095) */
+static void set_guards(uint32_t n, uint16_t cols)
+{
+    for (uint32_t i = 0; i < BENCH_GUARD; i++)
+    {
+        s_src[n + i]    = (i & 1) ? 4095 : 0;
+        s_min[cols + i] = 0xA5A5;
+        s_max[cols + i] = 0xA5A5;
+    }
+}
+
+static int guards_intact(uint16_t cols)
+{
+    for (uint32_t i = 0; i < BENCH_GUARD; i++)
+    {
+        if (s_min[cols + i] != 0xA5A5 || s_max[cols + i] != 0xA5A5) return 0;
+    }
+    return 1;
+}
+
+/* 1. 單點脈衝逐一試遍每個位置; 回傳錯誤數 */
+static uint32_t check_spikes(uint32_t n, uint16_t cols)
+{
+    uint32_t errors = 0;
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+        for (int sign = 0; sign < 2; sign++)
+        {
+            uint16_t spike = sign ? BENCH_LO : BENCH_HI;
+
+            for (uint32_t i = 0; i < n; i++) s_src[i] = BENCH_BASE;
+            s_src[k] = spike;
+            set_guards(n, cols);
+
+            wave_decim_minmax(s_src, n, cols, s_min, s_max);
+            if (!guards_intact(cols)) errors++;
+
+            uint16_t owner = 0;
+            for (uint16_t c = 0; c < cols; c++)
+            {
+                uint32_t first, last;
+                col_range(n, cols, c, &first, &last);
+
+                int has = (k >= first && k <= last);
+                int only = has && (first == last);      /* 該欄只有脈衝這一點 (cols > n 或最後一欄) */
+                uint16_t lo = ((has && sign) || only) ? spike : BENCH_BASE;
+                uint16_t hi = ((has && !sign) || only) ? spike : BENCH_BASE;
+
+                if (s_min[c] != lo || s_max[c] != hi) errors++;
+                if (has && owner == 0) owner = c + 1;
+            }
+
+            /* n >= cols: 第一個含 k 的欄只能是 k*cols/n 那一欄, 或 k 為其欄首時的前一欄 */
+            if (n >= cols && owner != 0)
+            {
+                uint32_t c = (uint32_t)k * cols / n;
+                uint32_t first, last;
+
+                col_range(n, cols, (uint16_t)c, &first, &last);
+                if (c + 1 != owner && !(k == first && c == owner)) errors++;
+            }
+            if (owner == 0) errors++;
+        }
+    }
+
+    return errors;
+}
+
+/* 2 / 3. 亂數波形: 相鄰欄相連, 每欄等於其範圍內的 min / max, 不讀不寫界外; 回傳錯誤數 */
+static uint32_t check_random(uint32_t n, uint16_t cols)
+{
+    uint32_t errors = 0;
+
+    for (int rep = 0; rep < 8; rep++)
+    {
+        for (uint32_t i = 0; i < n; i++) s_src[i] = (uint16_t)(1 + bench_rand() % 4094);
+        set_guards(n, cols);
+
+        wave_decim_minmax(s_src, n, cols, s_min, s_max);
+        if (!guards_intact(cols)) errors++;
+
+        for (uint16_t c = 0; c < cols; c++)
+        {
+            uint32_t first, last;
+            uint16_t lo = 0xFFFF, hi = 0;
+
+            col_range(n, cols, c, &first, &last);
+            for (uint32_t i = first; i <= last; i++)
+            {
+                if (s_src[i] < lo) lo = s_src[i];
+                if (s_src[i] > hi) hi = s_src[i];
+            }
+            if (s_min[c] != lo || s_max[c] != hi) errors++;
+
+            if (c > 0)
+            {
+                uint32_t p_first, p_last;
+
+                col_range(n, cols, c - 1, &p_first, &p_last);
+                uint16_t shared = s_src[p_last];    /* 前一欄的最後一點 */
+
+                if (s_min[c] > shared || s_max[c] < shared) errors++;
+                if (s_min[c] > s_max[c - 1] || s_max[c] < s_min[c - 1]) errors++;
+            }
+        }
+    }
+
+    return errors;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-s seed]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t seed = 1;
+    static const uint32_t extra_n[] = { 1, 250, 1000 };
+    static const uint16_t cols_list[] = { 50, 117, BENCH_COLS_MAX };
+    uint32_t n_list[16];
+    int n_count = 0;
+    int fail = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else usage(argv[0]);
+    }
+
+    s_rng = seed ? seed : 1;
+
+    for (uint32_t n = FFT_PROC_NPT_MIN; n <= FFT_PROC_NPT_MAX; n *= 2) n_list[n_count++] = n;
+    for (unsigned i = 0; i < sizeof(extra_n) / sizeof(extra_n[0]); i++) n_list[n_count++] = extra_n[i];
+
+    printf("%6s %5s %8s %8s\n", "n", "cols", "spike", "random");
+
+    for (int i = 0; i < n_count; i++)
+    {
+        for (unsigned j = 0; j < sizeof(cols_list) / sizeof(cols_list[0]); j++)
+        {
+            uint32_t n = n_list[i];
+            uint16_t cols = cols_list[j];
+            uint32_t e_spike = check_spikes(n, cols);
+            uint32_t e_rand = check_random(n, cols);
+
+            printf("%6u %5u %8u %8u %s\n", (unsigned)n, (unsigned)cols, (unsigned)e_spike, (unsigned)e_rand,
+                   (e_spike || e_rand) ? "FAIL" : "");
+            if (e_spike || e_rand) fail = 1;
+        }
+    }
+
+    printf("%s\n", fail ? "FAIL" : "PASS");
+
+    return fail;
+}
@@ -0,0 +1,176 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_convert.c
+ * @brief       ADC 原始碼轉換核心
+ ****************************************************************************************************
+ */
+
+#include "adc_convert.h"
+#include "adc_pair.h"
+
+
+#if ADC_CONVERT_USE_SIMD
+
+#define ADC_PAIR_LO(w)      ((int32_t)(int16_t)(w))
+#define ADC_PAIR_HI(w)      ((int32_t)(w) >> 16)
+
+#endif
+
+/**
+ * @brief       平均碼 (四捨五入)
+ * @param       src: 原始碼
+ * @param       n  : 點數 (> 0)
+ * @retval      平均碼
+ */
+uint16_t adc_convert_mean(const uint16_t *src, uint32_t n)
+{
+    uint32_t sum = 0;       /* 4095 * 4096 < 2^24, 不會溢位 */
+    uint32_t i = 0;
+
+#if ADC_CONVERT_USE_SIMD
+    for (; i + 4 <= n; i += 4)
+    {
+        sum = __SMLAD(adc_pair_read(&src[i]), 0x00010001, sum);
+        sum = __SMLAD(adc_pair_read(&src[i + 2]), 0x00010001, sum);
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        sum += src[i];
+    }
+
+    return (uint16_t)((sum + n / 2) / n);
+}
+
+/**
+ * @brief       原始碼 => 去直流, 換算, 加窗後的 float
+ * @param       src: 原始碼
+ * @param       n  : 點數
+ * @param       dc : 要扣除的直流碼 (0: 不去直流)
+ * @param       tab: 每點的倍數 (窗函數 x 換算), NULL 時每點都乘 k
+ * @param       k  : tab 為 NULL 時的倍數
+ * @param       dst: 輸出, n 點
+ * @retval      無
+ */
+void adc_convert_f32(const uint16_t *src, uint32_t n, int32_t dc, const float *tab, float k, float *dst)
+{
+    uint32_t i = 0;
+
+#if ADC_CONVERT_USE_SIMD
+    uint32_t dc2 = ((uint32_t)dc & 0xFFFF) * 0x00010001;
+
+    if (tab != NULL)
+    {
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t d0 = __SSUB16(adc_pair_read(&src[i]), dc2);
+            uint32_t d1 = __SSUB16(adc_pair_read(&src[i + 2]), dc2);
+
+            dst[i]     = (float)ADC_PAIR_LO(d0) * tab[i];
+            dst[i + 1] = (float)ADC_PAIR_HI(d0) * tab[i + 1];
+            dst[i + 2] = (float)ADC_PAIR_LO(d1) * tab[i + 2];
+            dst[i + 3] = (float)ADC_PAIR_HI(d1) * tab[i + 3];
+        }
+    }
+    else
+    {
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t d0 = __SSUB16(adc_pair_read(&src[i]), dc2);
+            uint32_t d1 = __SSUB16(adc_pair_read(&src[i + 2]), dc2);
+
+            dst[i]     = (float)ADC_PAIR_LO(d0) * k;
+            dst[i + 1] = (float)ADC_PAIR_HI(d0) * k;
+            dst[i + 2] = (float)ADC_PAIR_LO(d1) * k;
+            dst[i + 3] = (float)ADC_PAIR_HI(d1) * k;
+        }
+    }
+#else
+    if (tab != NULL)
+    {
+        for (; i + 4 <= n; i += 4)
+        {
+            dst[i]     = (float)((int32_t)src[i] - dc) * tab[i];
+            dst[i + 1] = (float)((int32_t)src[i + 1] - dc) * tab[i + 1];
+            dst[i + 2] = (float)((int32_t)src[i + 2] - dc) * tab[i + 2];
+            dst[i + 3] = (float)((int32_t)src[i + 3] - dc) * tab[i + 3];
+        }
+    }
+    else
+    {
+        for (; i + 4 <= n; i += 4)
+        {
+            dst[i]     = (float)((int32_t)src[i] - dc) * k;
+            dst[i + 1] = (float)((int32_t)src[i + 1] - dc) * k;
+            dst[i + 2] = (float)((int32_t)src[i + 2] - dc) * k;
+            dst[i + 3] = (float)((int32_t)src[i + 3] - dc) * k;
+        }
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        dst[i] = (float)((int32_t)src[i] - dc) * (tab != NULL ? tab[i] : k);
+    }
+}
+
+/* 單點 q15: 飽和的 (x - dc) * 16, 再乘窗函數 */
+static inline q15_t adc_convert_q15_one(int32_t x, int32_t dc, const q15_t *win, uint32_t i)
+{
+    int32_t v = (x - dc) * 16;
+
+    if (v > 32767)  v = 32767;
+    if (v < -32768) v = -32768;
+
+    if (win != NULL)
+    {
+        v = (v * win[i]) >> 15;
+    }
+
+    return (q15_t)v;
+}
+
+/**
+ * @brief       原始碼 => 去直流, 加窗後的 q15 (12-bit 滿刻度對應 q15 滿刻度)
+ * @param       src: 原始碼
+ * @param       n  : 點數
+ * @param       dc : 要扣除的直流碼
+ * @param       win: q15 窗函數 (0 ~ 32767), NULL 時不加窗
+ * @param       dst: 輸出, n 點
+ * @retval      無
+ */
+void adc_convert_q15(const uint16_t *src, uint32_t n, int32_t dc, const q15_t *win, q15_t *dst)
+{
+    uint32_t i = 0;
+
+#if ADC_CONVERT_USE_SIMD
+    uint32_t dc2 = ((uint32_t)dc & 0xFFFF) * 0x00010001;
+
+    for (; i + 2 <= n; i += 2)
+    {
+        uint32_t d = __SSUB16(adc_pair_read(&src[i]), dc2);
+
+        d = __QADD16(d, d);         /* x16, 每半字各自飽和 */
+        d = __QADD16(d, d);
+        d = __QADD16(d, d);
+        d = __QADD16(d, d);
+
+        if (win != NULL)
+        {
+            int32_t lo = (ADC_PAIR_LO(d) * win[i]) >> 15;
+            int32_t hi = (ADC_PAIR_HI(d) * win[i + 1]) >> 15;
+
+            d = __PKHBT(lo, hi, 16);
+        }
+
+        dst[i]     = (q15_t)ADC_PAIR_LO(d);
+        dst[i + 1] = (q15_t)ADC_PAIR_HI(d);
+    }
+#endif
+
+    for (; i < n; i++)
+    {
+        dst[i] = adc_convert_q15_one(src[i], dc, win, i);
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_convert.h
+ * @brief       ADC 原始碼轉換核心: 去直流 + 換算 + 加窗, 輸出 float 或 q15
+ ****************************************************************************************************
+ * @attention
+ *
+ * Cortex-M4 (ARM_MATH_CM4) 上使用 SIMD 指令一次處理兩個 12-bit 原始碼:
+ *   __SMLAD 累加直流, __SSUB16 去直流, __QADD16 飽和放大為 q15; float 輸出每次展開 4 點,
+ *   讓 VCVT / VMUL 可以交錯執行. 其他平台使用同樣算式的可攜 C 版本.
+ * 兩種版本與逐點參考迴圈的結果逐位元相同 (見 Tools/conv_bench.c).
+ * 主機端可以 -DADC_CONVERT_USE_SIMD=1 配合 Tools/host/arm_math.h 的指令模擬測試 SIMD 版本.
+ *
+ * 直流以四捨五入後的整數碼扣除 (殘留 < 0.5 LSB), 減法因此不會有捨入誤差.
+ * 使用 SIMD 版本時 src 須符合 adc_pair.h 的對齊要求, n 必須為 4 的倍數 (FFT 點數都符合).
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ADC_CONVERT_H
+#define __ADC_CONVERT_H
+
+#include <stdint.h>
+#include "arm_math.h"
+
+
+#ifndef ADC_CONVERT_USE_SIMD
+#if defined(ARM_MATH_CM4) || defined(ARM_MATH_CM7)
+#define ADC_CONVERT_USE_SIMD    1
+#else
+#define ADC_CONVERT_USE_SIMD    0
+#endif
+#endif
+
+
+uint16_t adc_convert_mean(const uint16_t *src, uint32_t n);     /* 四捨五入後的平均碼 */
+
+/* dst[i] = (src[i] - dc) * (tab ? tab[i] : k) */
+void adc_convert_f32(const uint16_t *src, uint32_t n, int32_t dc, const float *tab, float k, float *dst);
+
+/* dst[i] = sat16((src[i] - dc) * 16), 有 win 時再 * win[i] >> 15 (win 為 0 ~ 32767) */
+void adc_convert_q15(const uint16_t *src, uint32_t n, int32_t dc, const q15_t *win, q15_t *dst);
+
+#endif
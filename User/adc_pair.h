@@ -0,0 +1,35 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_pair.h
+ * @brief       一次讀兩個相鄰的 16-bit ADC 原始碼 (adc_convert.c 的 SIMD 核心與 adc_scan.c 的解交錯共用)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 回傳的 32 位元字低半字為 p[0], 高半字為 p[1] (little-endian).
+ * p 必須 4-byte 對齊: ARMCC 直接以 uint32_t 指標讀取, 可能與相鄰的讀取合併成 LDRD / LDM,
+ * 未對齊時會 HardFault. DMA 緩衝與歷史緩衝都以 32 位元對齊配置, 偶數索引的位址都符合.
+ * 其他編譯器 (主機端 GCC / clang) 以 memcpy 避免 strict aliasing 問題, 最佳化後同樣是單一 LDR.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ADC_PAIR_H
+#define __ADC_PAIR_H
+
+#include <stdint.h>
+#include <string.h>
+
+
+#if defined(__CC_ARM)
+#define adc_pair_read(p)    (*(const uint32_t *)(const void *)(p))
+#else
+static inline uint32_t adc_pair_read(const uint16_t *p)
+{
+    uint32_t w;
+
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_scan.c
+ * @brief       ADC 掃描模式的解交錯
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "adc_scan.h"
+#include "adc_pair.h"
+
+
+/**
+ * @brief       交錯排列 => 依通道排列
+ * @note        2 / 4 通道每次讀 32 位元 (一對通道, adc_pair.h), 其他通道數逐點搬移
+ * @param       src     : DMA 寫入的交錯資料, frames x channels 點 (對齊要求見 adc_pair.h)
+ * @param       frames  : 每通道的點數
+ * @param       channels: 通道數 (1 ~ ADC_SCAN_MAX_CH)
+ * @param       dst     : 輸出, 通道 c 在 dst + c x frames
+ * @retval      無
+ */
+void adc_scan_deinterleave(const uint16_t *src, uint32_t frames, uint8_t channels, uint16_t *dst)
+{
+    uint32_t i;
+
+    switch (channels)
+    {
+        case 1:
+            memcpy(dst, src, frames * sizeof(uint16_t));
+            break;
+
+        case 2:
+        {
+            uint16_t *d0 = dst;
+            uint16_t *d1 = dst + frames;
+
+            for (i = 0; i < frames; i++)
+            {
+                uint32_t w = adc_pair_read(&src[2 * i]);
+
+                d0[i] = (uint16_t)w;
+                d1[i] = (uint16_t)(w >> 16);
+            }
+            break;
+        }
+
+        case 4:
+        {
+            uint16_t *d0 = dst;
+            uint16_t *d1 = dst + frames;
+            uint16_t *d2 = dst + 2 * frames;
+            uint16_t *d3 = dst + 3 * frames;
+
+            for (i = 0; i < frames; i++)
+            {
+                uint32_t w01 = adc_pair_read(&src[4 * i]);
+                uint32_t w23 = adc_pair_read(&src[4 * i + 2]);
+
+                d0[i] = (uint16_t)w01;
+                d1[i] = (uint16_t)(w01 >> 16);
+                d2[i] = (uint16_t)w23;
+                d3[i] = (uint16_t)(w23 >> 16);
+            }
+            break;
+        }
+
+        default:
+            for (uint8_t c = 0; c < channels; c++)
+            {
+                const uint16_t *s = src + c;
+                uint16_t *d = dst + c * frames;
+
+                for (i = 0; i < frames; i++)
+                {
+                    d[i] = s[i * channels];
+                }
+            }
+            break;
+    }
+}
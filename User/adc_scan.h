@@ -0,0 +1,51 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_scan.h
+ * @brief       ADC 掃描模式 (多通道) 的交錯資料 => 各通道連續資料
+ ****************************************************************************************************
+ * @attention
+ *
+ * ADC1 以掃描模式 (ScanConvMode = ENABLE, NbrOfConversion = ch) 執行時, 每次 TIM2 觸發
+ * 依 rank 順序轉換 ch 個通道, DMA 依序寫入, 半緩衝內為交錯排列:
+ *   src[i x ch + c] = 通道 c 的第 i 點
+ * adc_scan_deinterleave() 把它轉成依通道排列 (通道 c 在 dst + c x frames), 每個通道就是
+ * 一段連續的 12-bit 原始碼, 可直接交給 fft_proc_load_u16() / wave_frame 使用.
+ * 板端在複製 DMA 半緩衝到歷史緩衝時順便完成 (取代原本的 memcpy, 不多走一遍資料).
+ *
+ * 採樣率與通道數:
+ *   每通道的採樣率 = TIM2 觸發率 (Samples), 與通道數無關. 一次掃描的時間為
+ *   ch x (SamplingTime + 12) 個 ADCCLK; 目前 15 週期取樣, ADCCLK = 42MHz (PCLK2 / 2) 時
+ *   每通道 0.64us, 4 通道 2.6us, 觸發率上限約 1.56MHz / ch, 遠高於 2kHz ~ 20kHz 的使用範圍.
+ *   通道 c 比通道 0 晚 c x 0.64us 取樣, 600Hz 時每通道約 0.14 度的相位差 (比較相位時需扣除).
+ *   DMA 每次觸發搬 ch 個 halfword, 頻寬可以忽略.
+ * 記憶體與點數:
+ *   DMA 乒乓緩衝與 DSP 暫存區的總點數不變, 由各通道平分, 每通道點數上限為
+ *   ADC_SCAN_NPT_MAX(total, ch) (4096 點時: 1 通道 4096, 2 通道 2048, 3 / 4 通道 1024).
+ * CPU:
+ *   一幀的時間 = npt / Samples, 與通道數無關; 每幀的工作量 = 一次解交錯 (npt x ch 點, 約與原本的
+ *   memcpy 相同) + ch 次 (轉換 + RFFT + 幅度 + 平均 + 峰值 + 發佈). 因此 PendSV 的負載與通道數成正比:
+ *   1024 點每通道約 50k 週期 (RFFT + 幅度約 40k, 見 tone_bank.h), 4 通道約 200k 週期 = 1.2ms @168MHz,
+ *   2kHz 時一幀 512ms, 佔 0.2%; 最壞情況 (64 點, 20kHz, 一幀 3.2ms) 每通道約 4k 週期, 4 通道仍小於 0.1ms.
+ *   點數上限隨通道數縮小, 因此最大點數時每幀總工作量大致不變 (ch x (4096 / ch) 點).
+ *   主機量測見 Tools/scan_bench.c, 板端見 profiler 的 acq_copy / fft_total 區段.
+ * 不依賴 HAL.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ADC_SCAN_H
+#define __ADC_SCAN_H
+
+#include <stdint.h>
+
+
+#define ADC_SCAN_MAX_CH         4           /* 支援的通道數上限 */
+
+/* total 點的緩衝由 ch 個通道平分時, 每通道的最大點數 (2 的冪, 常數運算式) */
+#define ADC_SCAN_NPT_MAX(total, ch)     ((ch) <= 1 ? (total) : (ch) == 2 ? (total) / 2 : (total) / 4)
+
+
+/* dst[c x frames + i] = src[i x channels + c]; channels = 1 時等同 memcpy, src 與 dst 不可重疊 */
+void adc_scan_deinterleave(const uint16_t *src, uint32_t frames, uint8_t channels, uint16_t *dst);
+
+#endif
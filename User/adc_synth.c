@@ -0,0 +1,193 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_synth.c
+ * @brief       合成 ADC 訊號源
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include <math.h>
+#include "adc_synth.h"
+
+
+#define SYNTH_2PI       6.28318530718f
+
+
+/* xorshift32 => (0, 1] */
+static float synth_uniform(adc_synth_t *g)
+{
+    uint32_t x = g->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g->rng = x;
+
+    return ((x >> 8) + 1) * (1.0f / 16777216.0f);
+}
+
+/* Box-Muller, 標準常態分布 */
+static float synth_gauss(adc_synth_t *g)
+{
+    float u1 = synth_uniform(g);
+    float u2 = synth_uniform(g);
+
+    return sqrtf(-2.0f * logf(u1)) * cosf(SYNTH_2PI * u2);
+}
+
+static float synth_wrap(float phase)
+{
+    while (phase >= SYNTH_2PI)
+    {
+        phase -= SYNTH_2PI;
+    }
+
+    return phase;
+}
+
+/**
+ * @brief       初始化訊號源 (直流 1.65V, 3.3V/12-bit, 無任何訊號)
+ * @param       g : 訊號源
+ * @param       fs: 採樣率 (Hz)
+ * @retval      無
+ */
+void adc_synth_init(adc_synth_t *g, float fs)
+{
+    memset(g, 0, sizeof(*g));
+
+    g->fs         = fs;
+    g->dc         = 1.65f;
+    g->vref       = 3.3f;
+    g->full_scale = 4095;
+    g->rng        = 0x12345678u;
+}
+
+/**
+ * @brief       加入一個正弦波
+ * @param       g   : 訊號源
+ * @param       freq: 頻率 (Hz)
+ * @param       amp : 峰值 (V)
+ * @retval      0: 成功; 1: 已達 ADC_SYNTH_MAX_TONES
+ */
+uint8_t adc_synth_add_tone(adc_synth_t *g, float freq, float amp)
+{
+    if (g->tone_count >= ADC_SYNTH_MAX_TONES)
+    {
+        return 1;
+    }
+
+    g->tone[g->tone_count].freq  = freq;
+    g->tone[g->tone_count].amp   = amp;
+    g->tone[g->tone_count].phase = 0.0f;
+    g->tone_count++;
+    return 0;
+}
+
+/**
+ * @brief       設定高斯雜訊
+ * @param       g   : 訊號源
+ * @param       rms : RMS (V), 0 表示關閉
+ * @param       seed: 亂數種子 (0 時使用預設值)
+ * @retval      無
+ */
+void adc_synth_set_noise(adc_synth_t *g, float rms, uint32_t seed)
+{
+    g->noise_rms = rms;
+    g->rng = seed ? seed : 0x12345678u;
+}
+
+/**
+ * @brief       設定線性掃頻
+ * @param       g     : 訊號源
+ * @param       f0    : 起點 (Hz)
+ * @param       f1    : 終點 (Hz)
+ * @param       amp   : 峰值 (V), 0 表示關閉
+ * @param       period: 一次掃頻的時間 (s)
+ * @retval      無
+ */
+void adc_synth_set_chirp(adc_synth_t *g, float f0, float f1, float amp, float period)
+{
+    g->chirp_f0     = f0;
+    g->chirp_f1     = f1;
+    g->chirp_amp    = amp;
+    g->chirp_period = period;
+    g->chirp_t      = 0.0f;
+    g->chirp_phase  = 0.0f;
+}
+
+/* 下一點的類比電壓 (V), 相位與掃頻時間前進一點 */
+static float synth_sample(adc_synth_t *g, float dt)
+{
+    float v = g->dc;
+
+    for (uint8_t k = 0; k < g->tone_count; k++)
+    {
+        adc_synth_tone_t *t = &g->tone[k];
+
+        v += t->amp * sinf(t->phase);
+        t->phase = synth_wrap(t->phase + SYNTH_2PI * t->freq * dt);
+    }
+
+    if (g->chirp_amp > 0.0f && g->chirp_period > 0.0f)
+    {
+        float f = g->chirp_f0 + (g->chirp_f1 - g->chirp_f0) * g->chirp_t / g->chirp_period;
+
+        v += g->chirp_amp * sinf(g->chirp_phase);
+        g->chirp_phase = synth_wrap(g->chirp_phase + SYNTH_2PI * f * dt);
+
+        g->chirp_t += dt;
+        if (g->chirp_t >= g->chirp_period)
+        {
+            g->chirp_t -= g->chirp_period;
+        }
+    }
+
+    if (g->noise_rms > 0.0f)
+    {
+        v += g->noise_rms * synth_gauss(g);
+    }
+
+    return v;
+}
+
+/**
+ * @brief       產生 n 點量化後的 ADC 原始碼
+ * @param       g  : 訊號源
+ * @param       dst: 輸出
+ * @param       n  : 點數
+ * @retval      無
+ */
+void adc_synth_fill(adc_synth_t *g, uint16_t *dst, uint32_t n)
+{
+    float dt = 1.0f / g->fs;
+    float scale = g->full_scale / g->vref;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        /* 量化並夾在 0 ~ full_scale (與真實 ADC 一樣會削波) */
+        float code = synth_sample(g, dt) * scale + 0.5f;
+
+        if (code < 0.0f)                   code = 0.0f;
+        if (code > (float)g->full_scale)   code = (float)g->full_scale;
+
+        dst[i] = (uint16_t)code;
+    }
+}
+
+/**
+ * @brief       產生 n 點量化前的類比電壓 (V), 不量化也不削波
+ * @note        與 adc_synth_fill() 的同一段訊號: 先複製訊號源, 兩份各產生 n 點即得量化前後的同一幀
+ * @param       g  : 訊號源
+ * @param       dst: 輸出
+ * @param       n  : 點數
+ * @retval      無
+ */
+void adc_synth_fill_volts(adc_synth_t *g, float *dst, uint32_t n)
+{
+    float dt = 1.0f / g->fs;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        dst[i] = synth_sample(g, dt);
+    }
+}
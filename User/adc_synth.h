@@ -0,0 +1,59 @@
+/**
+ ****************************************************************************************************
+ * @file        adc_synth.h
+ * @brief       合成 ADC 訊號源: 正弦波, 高斯雜訊, 線性掃頻, 直流偏壓, 12-bit 量化
+ ****************************************************************************************************
+ * @attention
+ *
+ * 取代 ADValue 作為測試輸入 (板端 ADC_SOURCE_SYNTH 或主機端 Tools/dsp_bench.c).
+ * 相位跨幀連續, 連續呼叫 adc_synth_fill() 得到的是一段不間斷的訊號.
+ * 不依賴 HAL, 雜訊使用內建的 xorshift32, 同樣的設定與種子每次產生相同的資料.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ADC_SYNTH_H
+#define __ADC_SYNTH_H
+
+#include <stdint.h>
+
+
+#define ADC_SYNTH_MAX_TONES     4
+
+typedef struct
+{
+    float freq;                 /* Hz */
+    float amp;                  /* 峰值 (V) */
+    float phase;                /* rad, 內部累加 */
+} adc_synth_tone_t;
+
+typedef struct
+{
+    float    fs;                /* 採樣率 (Hz) */
+    float    dc;                /* 直流偏壓 (V) */
+    float    vref;              /* ADC 參考電壓 (V) */
+    uint16_t full_scale;        /* 量化滿刻度碼 (12-bit: 4095) */
+
+    adc_synth_tone_t tone[ADC_SYNTH_MAX_TONES];
+    uint8_t  tone_count;
+
+    float    noise_rms;         /* 高斯雜訊 RMS (V) */
+    uint32_t rng;               /* xorshift32 狀態, 不可為 0 */
+
+    float    chirp_f0;          /* 掃頻起點 (Hz) */
+    float    chirp_f1;          /* 掃頻終點 (Hz) */
+    float    chirp_amp;         /* 峰值 (V), 0 表示關閉 */
+    float    chirp_period;      /* 一次掃頻的時間 (s), 之後從 f0 重來 */
+    float    chirp_t;           /* 內部: 目前掃頻時間 */
+    float    chirp_phase;       /* 內部: 相位 */
+} adc_synth_t;
+
+
+void adc_synth_init(adc_synth_t *g, float fs);          /* 直流 1.65V, 3.3V/12-bit, 無任何訊號 */
+uint8_t adc_synth_add_tone(adc_synth_t *g, float freq, float amp);     /* 0: 成功; 1: 已滿 */
+void adc_synth_set_noise(adc_synth_t *g, float rms, uint32_t seed);
+void adc_synth_set_chirp(adc_synth_t *g, float f0, float f1, float amp, float period);
+void adc_synth_fill(adc_synth_t *g, uint16_t *dst, uint32_t n);
+void adc_synth_fill_volts(adc_synth_t *g, float *dst, uint32_t n);  /* 量化前的電壓 (V) */
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ ****************************************************************************************************
+ * @file        fft_job.c
+ * @brief       DMA 回呼 => PendSV 的工作佇列
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "fft_job.h"
+
+
+/* 索引更新前後的記憶體屏障 (與 frame_queue.c 相同) */
+#if defined(__CC_ARM)
+#define FJ_BARRIER()    __dmb(0xF)
+#elif defined(__GNUC__) || defined(__clang__)
+#define FJ_BARRIER()    __sync_synchronize()
+#else
+#define FJ_BARRIER()
+#endif
+
+#define FJ_MASK         (FFT_JOB_DEPTH - 1)
+
+
+/**
+ * @brief       初始化 (需在 DMA 啟動之前呼叫)
+ * @param       q: 佇列
+ * @retval      無
+ */
+void fft_job_init(fft_job_queue_t *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+/**
+ * @brief       清空佇列, 序號與計數保留 (DMA 停止時呼叫, 例如切換點數)
+ * @param       q: 佇列
+ * @retval      無
+ */
+void fft_job_reset(fft_job_queue_t *q)
+{
+    q->head = 0;
+    q->tail = 0;
+}
+
+/**
+ * @brief       生產端 (DMA 回呼): 發佈完成的半緩衝
+ * @param       q   : 佇列
+ * @param       data: 完成的那一半
+ * @retval      0: 已發佈; 1: 佇列滿, 本幀丟棄並計入 dropped_full
+ */
+uint8_t fft_job_post(fft_job_queue_t *q, const uint16_t *data)
+{
+    uint32_t head = q->head;
+    uint32_t seq  = q->dma_seq + 1;
+
+    q->dma_seq = seq;
+
+    if (head - q->tail >= FFT_JOB_DEPTH)
+    {
+        q->dropped_full++;
+        return 1;
+    }
+
+    fft_job_t *job = &q->job[head & FJ_MASK];
+    job->data = data;
+    job->seq  = seq;
+    FJ_BARRIER();
+    q->head = head + 1;
+    q->posted++;
+    return 0;
+}
+
+/**
+ * @brief       消費端: 取出最舊的一幀
+ * @note        取出後槽立即歸還; job 是複本, 輸入本身仍在 DMA 緩衝中, 讀完後要 fft_job_check()
+ * @param       q  : 佇列
+ * @param       job: 輸出
+ * @retval      1: 取得一幀; 0: 佇列空
+ */
+uint8_t fft_job_take(fft_job_queue_t *q, fft_job_t *job)
+{
+    uint32_t tail = q->tail;
+
+    if (tail == q->head)
+    {
+        return 0;
+    }
+
+    FJ_BARRIER();   /* 看到 head 之後才讀槽內容 */
+    *job = q->job[tail & FJ_MASK];
+    FJ_BARRIER();
+    q->tail = tail + 1;
+    return 1;
+}
+
+/**
+ * @brief       消費端: 讀完輸入後確認 DMA 還沒回到這一半
+ * @param       q  : 佇列
+ * @param       job: fft_job_take() 取得的幀
+ * @retval      0: 輸入有效; 1: 讀取期間已有下一次回呼 (輸入可能撕裂), 計入 dropped_torn
+ */
+uint8_t fft_job_check(fft_job_queue_t *q, const fft_job_t *job)
+{
+    FJ_BARRIER();   /* 輸入讀完才看序號 */
+
+    if (q->dma_seq != job->seq)
+    {
+        q->dropped_torn++;
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       丟棄的總幀數
+ * @note        兩個計數各由一端寫入, 這裡只讀; 與另一端同時更新時可能少算正在發生的那一幀
+ * @param       q: 佇列
+ * @retval      dropped_full + dropped_torn
+ */
+uint32_t fft_job_dropped(const fft_job_queue_t *q)
+{
+    return q->dropped_full + q->dropped_torn;
+}
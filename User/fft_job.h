@@ -0,0 +1,60 @@
+/**
+ ****************************************************************************************************
+ * @file        fft_job.h
+ * @brief       DMA 回呼 => PendSV 的工作佇列 (只傳半緩衝指標與序號)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 生產端: ADC DMA 半傳輸 / 全傳輸回呼 (fft_job_post(), 之後由呼叫端觸發 PendSV);
+ * 消費端: PendSV (fft_job_take() 取出, 讀完輸入後以 fft_job_check() 確認沒有被 DMA 覆寫).
+ * 兩端各自只寫自己的欄位 (生產端: head / dma_seq / posted / dropped_full;
+ * 消費端: tail / dropped_torn), 不需要關中斷或鎖. 計數在 DMA 中斷打斷 PendSV 時也不會遺失.
+ *
+ * 每次回呼 dma_seq 都 +1 (佇列滿而丟棄時也是), 因此被處理的幀序號不連續即表示有幀遺失,
+ * 遺失的幀一定計入 fft_job_dropped(): 佇列滿 (PendSV 來不及取走, dropped_full) 或讀完輸入時
+ * dma_seq 已變 (DMA 已回到這一半, 輸入可能撕裂, dropped_torn).
+ * 本檔不依賴 HAL, 可直接在 Linux 主機上編譯 (Tools/job_bench.c).
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __FFT_JOB_H
+#define __FFT_JOB_H
+
+#include <stdint.h>
+
+
+#define FFT_JOB_DEPTH           2           /* 只有兩個半緩衝, 必須為 2 的冪 */
+
+typedef struct
+{
+    const uint16_t *data;                   /* 指向 DMA 緩衝的前半或後半 */
+    uint32_t seq;                           /* 發佈時的 DMA 回呼序號 */
+} fft_job_t;
+
+typedef struct
+{
+    fft_job_t job[FFT_JOB_DEPTH];
+    volatile uint32_t head;                 /* 只由生產端遞增 */
+    volatile uint32_t tail;                 /* 只由消費端遞增 */
+    volatile uint32_t dma_seq;              /* 生產端: 每次回呼 +1 */
+    volatile uint32_t posted;               /* 已交給消費端的幀數 */
+    volatile uint32_t dropped_full;         /* 生產端: 佇列滿而丟棄的幀數 */
+    volatile uint32_t dropped_torn;         /* 消費端: 輸入已被覆寫而丟棄的幀數 */
+} fft_job_queue_t;
+
+
+void fft_job_init(fft_job_queue_t *q);                          /* 全部清零 */
+void fft_job_reset(fft_job_queue_t *q);                         /* 清空佇列, 保留計數 (兩端都停止時呼叫) */
+
+/* 生產端 */
+uint8_t fft_job_post(fft_job_queue_t *q, const uint16_t *data); /* 0: 已發佈; 1: 佇列滿, 丟棄 */
+
+/* 消費端 */
+uint8_t fft_job_take(fft_job_queue_t *q, fft_job_t *job);       /* 1: 取得一幀; 0: 佇列空 */
+uint8_t fft_job_check(fft_job_queue_t *q, const fft_job_t *job);    /* 讀完輸入後: 0: 有效; 1: 已被覆寫 (計入 dropped_torn) */
+
+/* 任一端皆可讀 */
+uint32_t fft_job_dropped(const fft_job_queue_t *q);             /* dropped_full + dropped_torn */
+
+#endif
@@ -0,0 +1,716 @@
+/**
+ ****************************************************************************************************
+ * @file        fft_proc.c
+ * @brief       頻譜處理管線
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include <math.h>
+#include "fft_proc.h"
+#include "adc_convert.h"
+#include "profiler.h"
+
+
+/* 餘弦和窗函數係數: w[n] = a0 - a1 cos(2πn/N) + a2 cos(4πn/N) - ... (週期型, 分母為 N) */
+#define FFT_WIN_TERMS   5
+
+#define FFT_PROC_Q15_CHUNK  32      /* 定點管線幅度換成 float 時的分段點數 (堆疊) */
+
+static const float s_win_coef[FFT_WIN_COUNT][FFT_WIN_TERMS] =
+{
+    { 1.0f,        0.0f,        0.0f,         0.0f,         0.0f         },   /* 矩形 */
+    { 0.5f,        0.5f,        0.0f,         0.0f,         0.0f         },   /* Hann */
+    { 0.54f,       0.46f,       0.0f,         0.0f,         0.0f         },   /* Hamming */
+    { 0.35875f,    0.48829f,    0.14128f,     0.01168f,     0.0f         },   /* Blackman-Harris */
+    { 0.21557895f, 0.41663158f, 0.277263158f, 0.083578947f, 0.006947368f },   /* 平頂 */
+};
+
+/* Jacobsen 估計式的窗函數修正倍數 (Tools/interp_bench.c 以最小平方擬合) */
+static const float s_jacobsen_p[FFT_WIN_COUNT] =
+{
+    1.0f, 2.0f, 1.817f, 3.160f, 13.67f,
+};
+
+static const char * const s_interp_name[FFT_INTERP_COUNT] =
+{
+    "none",
+    "parabolic",
+    "gaussian",
+    "jacobsen",
+    "quinn",
+};
+
+static const char * const s_win_name[FFT_WIN_COUNT] =
+{
+    "rect",
+    "hann",
+    "hamming",
+    "blackman-harris",
+    "flattop",
+};
+
+
+/**
+ * @brief       依目前點數與窗函數產生 win[] 及修正係數
+ * @note        win[i] = w[i] / CG * VREF / FULL_SCALE, CG = mean(w);
+ *              定點管線的 win[] 改存 q15 的 w[i] (只用到前半), 換算與修正併入 q15_lsb;
+ *              矩形窗或 win == NULL 時不產生表格, fft_proc_load_u16() 改用常數換算
+ * @param       fp: 管線
+ * @retval      無
+ */
+static void fft_proc_make_window(fft_proc_t *fp)
+{
+    const float *a = s_win_coef[fp->window];
+    int npt = fp->npt;
+    float sum = 0.0f;
+    float sum_sq = 0.0f;
+
+    if (fp->window == FFT_WIN_RECT || fp->win == NULL)
+    {
+        fp->enbw = 1.0f;
+        fp->energy_corr = 1.0f;
+#if FFT_PROC_USE_Q15
+        fp->q15_lsb = FFT_PROC_ADC_VREF / FFT_PROC_ADC_FULL_SCALE / 16.0f;
+#endif
+        return;
+    }
+
+#if FFT_PROC_USE_Q15
+    q15_t *wq = (q15_t *)fp->win;
+#endif
+
+    for (int i = 0; i < npt; i++)
+    {
+        float x = 6.28318530718f * (float)i / (float)npt;
+        float w = a[0] - a[1] * cosf(x) + a[2] * cosf(2.0f * x) - a[3] * cosf(3.0f * x) + a[4] * cosf(4.0f * x);
+
+#if FFT_PROC_USE_Q15
+        wq[i] = (q15_t)(w * 32767.0f + (w >= 0.0f ? 0.5f : -0.5f));    /* 平頂窗兩端略小於 0 */
+#else
+        fp->win[i] = w;
+#endif
+        sum += w;
+        sum_sq += w * w;
+    }
+
+    float cg  = sum / npt;                  /* 相干增益 */
+    float rms = sqrtf(sum_sq / npt);
+
+#if FFT_PROC_USE_Q15
+    /* adc_convert_q15(): (碼 - dc) x 16 x wq[i] / 32768 */
+    fp->q15_lsb = FFT_PROC_ADC_VREF / FFT_PROC_ADC_FULL_SCALE / 16.0f * (32768.0f / 32767.0f) / cg;
+#else
+    float k   = FFT_PROC_ADC_VREF / FFT_PROC_ADC_FULL_SCALE / cg;
+
+    for (int i = 0; i < npt; i++)
+    {
+        fp->win[i] *= k;
+    }
+#endif
+
+    fp->enbw        = npt * sum_sq / (sum * sum);
+    fp->energy_corr = cg / rms;
+}
+
+/**
+ * @brief       窗函數名稱
+ * @param       window: 窗函數
+ * @retval      名稱字串
+ */
+const char *fft_proc_window_name(fft_window_t window)
+{
+    return (window < FFT_WIN_COUNT) ? s_win_name[window] : "?";
+}
+
+/* 點數 => plan[] 索引, 不支援時回傳 -1 */
+static int fft_proc_plan_index(uint16_t npt)
+{
+    for (int i = 0; i < FFT_PROC_PLAN_COUNT; i++)
+    {
+        if ((FFT_PROC_NPT_MIN << i) == npt)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief       初始化處理管線 (矩形窗), 預先規劃 FFT_PROC_NPT_MIN ~ npt 的所有 RFFT 實例
+ * @param       fp : 管線
+ * @param       npt: 初始 FFT 點數, 同時也是緩衝區容量 (FFT_PROC_NPT_MIN ~ FFT_PROC_NPT_MAX 的 2 的冪)
+ * @param       in : 輸入緩衝, npt 點 (4-byte 對齊)
+ * @param       out: 輸出緩衝, npt 點 (定點管線放 2 x npt 個 q15)
+ * @param       win: 窗函數係數緩衝, npt 點 (NULL: 只使用矩形窗)
+ * @retval      0: 成功; 1: 點數不支援
+ */
+uint8_t fft_proc_init(fft_proc_t *fp, uint16_t npt, float *in, float *out, float *win)
+{
+    int last = fft_proc_plan_index(npt);
+
+    memset(fp->plan, 0, sizeof(fp->plan));
+    fp->in        = in;
+    fp->out       = out;
+    fp->mag       = in;
+    fp->win       = win;
+    fp->window    = FFT_WIN_RECT;
+    fp->remove_dc = 1;
+    fp->interp    = FFT_INTERP_NONE;
+    fp->capacity  = npt;
+
+    if (last < 0)
+    {
+        return 1;
+    }
+
+    for (int i = 0; i <= last; i++)
+    {
+#if FFT_PROC_USE_Q15
+        if (arm_rfft_init_q15(&fp->plan[i], FFT_PROC_NPT_MIN << i, 0, 1) != ARM_MATH_SUCCESS)
+#else
+        if (arm_rfft_fast_init_f32(&fp->plan[i], FFT_PROC_NPT_MIN << i) != ARM_MATH_SUCCESS)
+#endif
+        {
+            return 1;
+        }
+    }
+
+    return fft_proc_set_npt(fp, npt);
+}
+
+/**
+ * @brief       切換 FFT 點數 (只換成預先規劃的實例, 可在兩幀之間呼叫)
+ * @param       fp : 管線
+ * @param       npt: 新點數, 不可超過 fp->capacity
+ * @retval      0: 成功; 1: 點數不支援或超過容量
+ */
+uint8_t fft_proc_set_npt(fft_proc_t *fp, uint16_t npt)
+{
+    int idx = fft_proc_plan_index(npt);
+
+    if (idx < 0 || npt > fp->capacity)
+    {
+        return 1;
+    }
+
+    fp->rfft = &fp->plan[idx];
+    fp->npt  = npt;
+    fft_proc_make_window(fp);
+    return 0;
+}
+
+/**
+ * @brief       切換窗函數 (重新產生係數表, 不可與 fft_proc_load_u16() 同時執行)
+ * @param       fp    : 管線
+ * @param       window: 窗函數
+ * @retval      0: 成功; 1: 不支援 (或沒有係數緩衝)
+ */
+uint8_t fft_proc_set_window(fft_proc_t *fp, fft_window_t window)
+{
+    if (window >= FFT_WIN_COUNT || (window != FFT_WIN_RECT && fp->win == NULL))
+    {
+        return 1;
+    }
+
+    fp->window = window;
+    fft_proc_make_window(fp);
+    return 0;
+}
+
+#if FFT_PROC_USE_Q15
+/**
+ * @brief       區塊浮點正規化: 整塊左移到最大絕對值接近滿刻度
+ * @param       x: 資料, 就地改寫
+ * @param       n: 點數
+ * @retval      左移位數 (全為 0 時為 0)
+ */
+static uint8_t fft_proc_q15_normalize(q15_t *x, uint32_t n)
+{
+    q15_t vmax, vmin;
+    uint32_t idx;
+    uint8_t shift = 0;
+
+    arm_max_q15(x, n, &vmax, &idx);
+    arm_min_q15(x, n, &vmin, &idx);
+
+    int32_t peak = (vmax > -vmin) ? vmax : -vmin;
+
+    while (peak != 0 && shift < 15 && (peak << (shift + 1)) <= 32767)
+    {
+        shift++;
+    }
+
+    if (shift != 0)
+    {
+        arm_shift_q15(x, (int8_t)shift, x, n);
+    }
+
+    return shift;
+}
+#endif
+
+/**
+ * @brief       把一幀 ADC 原始碼去直流, 轉成電壓並加窗, 寫入 in[]
+ * @note        定點管線寫入 q15 並做區塊浮點正規化 (見 fft_proc.h)
+ * @param       fp : 管線
+ * @param       src: npt 點 12-bit 原始碼 (4-byte 對齊)
+ * @retval      無
+ */
+void fft_proc_load_u16(fft_proc_t *fp, const uint16_t *src)
+{
+    PROF_BEGIN(PROF_ZONE_CONVERT);
+
+#if FFT_PROC_USE_Q15
+    q15_t *in = (q15_t *)fp->in;
+
+    /* q15 容不下 0~4095 x 16, 不去直流時改扣中點碼 */
+    int32_t dc = fp->remove_dc ? adc_convert_mean(src, fp->npt) : 2048;
+
+    adc_convert_q15(src, fp->npt, dc, (fp->window == FFT_WIN_RECT) ? NULL : (const q15_t *)fp->win, in);
+
+    /* 小訊號才不會被 RFFT 每級的 1/2 縮放吃掉 */
+    fp->q15_shift = fft_proc_q15_normalize(in, fp->npt);
+#else
+    int32_t dc = fp->remove_dc ? adc_convert_mean(src, fp->npt) : 0;
+
+    /* 矩形窗沒有係數表, 12-bit ADC => 0~3.3V 為常數倍; 其他窗的 win[] 已含 ADC 換算與振幅修正 */
+    adc_convert_f32(src, fp->npt, dc, (fp->window == FFT_WIN_RECT) ? NULL : fp->win,
+                    FFT_PROC_ADC_VREF / FFT_PROC_ADC_FULL_SCALE, fp->in);
+#endif
+
+    PROF_END(PROF_ZONE_CONVERT);
+}
+
+/**
+ * @brief       RFFT + 全頻譜幅度 (等同 fft_proc_spectrum_range(fp, 0, npt/2))
+ * @param       fp: 管線
+ * @retval      無
+ */
+void fft_proc_spectrum(fft_proc_t *fp)
+{
+    fft_proc_spectrum_range(fp, 0, fp->npt / 2);
+}
+
+/**
+ * @brief       RFFT + 幅度, 只計算 bin_start ~ bin_end
+ * @note        幅度寫到 mag[] (即 in[], RFFT 之後已用不到), out[] 保留 RFFT 的複數結果供插值使用:
+ *              浮點管線為 CMSIS 格式 (out[0] 直流, out[1] Nyquist 的實部, out[2k], out[2k+1] 為 X[k]);
+ *              定點管線: arm_rfft_q15 輸出完整 npt 個複數 (X / npt); 範圍內再做一次區塊浮點左移,
+ *              因為 arm_cmplx_mag_q15 先把平方和截成 q15, 小於滿刻度約 1/90 的幅度會被截成 0;
+ *              幅度 (2.14) 乘上 2 x npt x q15_lsb / 2^(兩次移位) 換回 float;
+ *              範圍外的 mag[] 內容無意義
+ * @param       fp       : 管線
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含, 不超過 npt/2)
+ * @retval      無
+ */
+void fft_proc_spectrum_range(fft_proc_t *fp, uint16_t bin_start, uint16_t bin_end)
+{
+    float *out = fp->out;
+    float *mag = fp->mag;
+    uint16_t half = fp->npt / 2;
+
+    if (bin_end > half)
+    {
+        bin_end = half;
+    }
+
+#if FFT_PROC_USE_Q15
+    q15_t *spec = (q15_t *)out;
+    q15_t tmp[FFT_PROC_Q15_CHUNK];
+    uint16_t n = bin_end - bin_start + 1;
+
+    PROF_BEGIN(PROF_ZONE_RFFT);
+    arm_rfft_q15(fp->rfft, (q15_t *)fp->in, spec);
+    PROF_END(PROF_ZONE_RFFT);
+
+    PROF_BEGIN(PROF_ZONE_MAG);
+    uint8_t shift = fft_proc_q15_normalize(&spec[2 * bin_start], 2 * n);
+    float k = 2.0f * (float)fp->npt * fp->q15_lsb / (float)(1u << (fp->q15_shift + shift));
+
+    /* mag[] 與 in[] 同一塊, 分段經由堆疊上的 q15 暫存換成 float */
+    for (uint16_t i = 0; i < n; i += FFT_PROC_Q15_CHUNK)
+    {
+        uint16_t c = (n - i < FFT_PROC_Q15_CHUNK) ? (n - i) : FFT_PROC_Q15_CHUNK;
+
+        arm_cmplx_mag_q15(&spec[2 * (bin_start + i)], tmp, c);
+
+        for (uint16_t j = 0; j < c; j++)
+        {
+            mag[bin_start + i + j] = tmp[j] * k;
+        }
+    }
+    PROF_END(PROF_ZONE_MAG);
+#else
+    uint16_t first = bin_start;
+    uint16_t last = (bin_end < half) ? bin_end : (half - 1);
+
+    PROF_BEGIN(PROF_ZONE_RFFT);
+    arm_rfft_fast_f32(fp->rfft, fp->in, out, 0);
+    PROF_END(PROF_ZONE_RFFT);
+
+    PROF_BEGIN(PROF_ZONE_MAG);
+    if (first == 0)
+    {
+        mag[0] = fabsf(out[0]);
+        first = 1;
+    }
+
+    if (last >= first)
+    {
+        arm_cmplx_mag_f32(&out[2 * first], &mag[first], last - first + 1);
+    }
+
+    if (bin_end == half)
+    {
+        mag[half] = fabsf(out[1]);
+    }
+    PROF_END(PROF_ZONE_MAG);
+#endif
+}
+
+/* log2(x), x > 0 且為正規數: 指數位元 + 尾數的 3 次多項式 (最小平方擬合, 誤差 < 1.5e-4, 約 0.001dB) */
+static inline float fft_proc_log2f(float x)
+{
+    union { float f; uint32_t u; } v;
+
+    v.f = x;
+    float e = (float)((int32_t)(v.u >> 23) - 127);
+
+    v.u = (v.u & 0x007FFFFFu) | 0x3F800000u;
+    float t = v.f - 1.0f;
+
+    return e + t + t * (1.0f - t) * (0.43807325f + t * (-0.23669342f + t * 0.080307304f));
+}
+
+/**
+ * @brief       幅度 => dBV (正弦波峰值, 0dB = 1V): 20 log10(mag * 2 / npt)
+ * @note        以 fft_proc_log2f() 近似, 每點只有一次多項式, 沒有 log10f(); 可就地轉換 (src == dst);
+ *              0 或極小的幅度夾在 FFT_PROC_DB_FLOOR
+ * @param       fp : 管線 (決定 npt 的正規化)
+ * @param       src: fft_proc_spectrum*() 的幅度 (或由它抽取的點)
+ * @param       dst: 輸出 (dB)
+ * @param       n  : 點數
+ * @retval      無
+ */
+void fft_proc_to_db(const fft_proc_t *fp, const float *src, float *dst, uint16_t n)
+{
+    fft_proc_mag_to_db(fp->npt, src, dst, n);
+}
+
+/**
+ * @brief       同 fft_proc_to_db(), 但正規化點數由呼叫端指定
+ * @note        給不屬於本管線、但幅度同為 A * npt / 2 的頻譜使用 (例如 zoom_fft.h)
+ * @param       npt: 正規化點數
+ * @param       src: 幅度
+ * @param       dst: 輸出 (dB), 可與 src 相同
+ * @param       n  : 點數
+ * @retval      無
+ */
+void fft_proc_mag_to_db(uint32_t npt, const float *src, float *dst, uint16_t n)
+{
+    const float db_per_oct = 6.0205999f;            /* 20 log10(2) */
+    float offset = 1.0f - fft_proc_log2f((float)npt);   /* log2(2 / npt), 2 的冪時為精確值 */
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        float m = src[i];
+        float db = FFT_PROC_DB_FLOOR;
+
+        if (m > 1e-30f)
+        {
+            db = db_per_oct * (fft_proc_log2f(m) + offset);
+            if (db < FFT_PROC_DB_FLOOR) db = FFT_PROC_DB_FLOOR;
+        }
+
+        dst[i] = db;
+    }
+}
+
+/**
+ * @brief       頻率範圍 => 頻點範圍 (四捨五入, 夾在 0 ~ npt/2; 範圍無效時回傳整個頻譜)
+ * @param       fp       : 管線
+ * @param       samp     : 採樣率 (Hz)
+ * @param       f_low    : 下限 (Hz)
+ * @param       f_high   : 上限 (Hz)
+ * @param       bin_start: 輸出, 第一個頻點
+ * @param       bin_end  : 輸出, 最後一個頻點 (含)
+ * @retval      無
+ */
+void fft_proc_bin_range(const fft_proc_t *fp, float samp, float f_low, float f_high,
+                        uint16_t *bin_start, uint16_t *bin_end)
+{
+    int npt = fp->npt;
+    int start = (int)(f_low * npt / samp + 0.5f);
+    int end   = (int)(f_high * npt / samp + 0.5f);
+
+    if (end > (npt / 2)) end = (npt / 2);
+    if (start < 0)       start = 0;
+    if (start > end)
+    {
+        start = 0;
+        end   = (npt / 2);
+    }
+
+    *bin_start = (uint16_t)start;
+    *bin_end   = (uint16_t)end;
+}
+
+/**
+ * @brief       插值方式名稱
+ * @param       interp: 插值方式
+ * @retval      名稱字串
+ */
+const char *fft_proc_interp_name(fft_interp_t interp)
+{
+    return (interp < FFT_INTERP_COUNT) ? s_interp_name[interp] : "?";
+}
+
+/* RFFT 的複數結果 X[k] (定點管線為範圍內同一縮放的相對值, 只能取比值) */
+static void fft_proc_bin(const fft_proc_t *fp, uint32_t k, float *re, float *im)
+{
+#if FFT_PROC_USE_Q15
+    const q15_t *spec = (const q15_t *)fp->out;
+
+    *re = spec[2 * k];
+    *im = spec[2 * k + 1];
+#else
+    const float *out = fp->out;
+
+    if (k == 0 || k == fp->npt / 2u)
+    {
+        *re = out[(k == 0) ? 0 : 1];
+        *im = 0.0f;
+    }
+    else
+    {
+        *re = out[2 * k];
+        *im = out[2 * k + 1];
+    }
+#endif
+}
+
+/* Re(n / d) */
+static float fft_proc_cdiv_re(float nr, float ni, float dr, float di)
+{
+    float den = dr * dr + di * di;
+
+    return (den > 0.0f) ? (nr * dr + ni * di) / den : 0.0f;
+}
+
+/* Quinn 第二估計式的修正項 */
+static float fft_proc_quinn_tau(float x)
+{
+    const float r = 0.81649658f;                /* sqrt(2/3) */
+
+    return 0.25f * logf(3.0f * x * x + 6.0f * x + 1.0f) -
+           0.10206207f * logf((x + 1.0f - r) / (x + 1.0f + r));    /* sqrt(6)/24 */
+}
+
+/**
+ * @brief       以峰值頻點 k 與左右兩點估計真正峰值的偏移
+ * @note        拋物線 / 高斯只用幅度; Jacobsen / Quinn 用 out[] 的複數值 (Quinn 的推導假設矩形窗)
+ * @param       fp: 管線 (k-1 ~ k+1 需已計算幅度)
+ * @param       k : 峰值頻點
+ * @retval      偏移 (頻點), 夾在 -0.5 ~ 0.5
+ */
+static float fft_proc_interp(const fft_proc_t *fp, uint32_t k)
+{
+    float d = 0.0f;
+
+    switch (fp->interp)
+    {
+        case FFT_INTERP_PARABOLIC:
+        {
+            float a = fp->mag[k - 1], b = fp->mag[k], c = fp->mag[k + 1];
+            float den = a - 2.0f * b + c;
+
+            d = (den != 0.0f) ? 0.5f * (a - c) / den : 0.0f;
+            break;
+        }
+
+        case FFT_INTERP_GAUSSIAN:
+        {
+            float a = fp->mag[k - 1], b = fp->mag[k], c = fp->mag[k + 1];
+
+            if (a > 0.0f && c > 0.0f)
+            {
+                float la = fft_proc_log2f(a), lb = fft_proc_log2f(b), lc = fft_proc_log2f(c);
+                float den = la - 2.0f * lb + lc;
+
+                d = (den != 0.0f) ? 0.5f * (la - lc) / den : 0.0f;
+            }
+            break;
+        }
+
+        case FFT_INTERP_JACOBSEN:
+        {
+            float ar, ai, br, bi, cr, ci;
+
+            fft_proc_bin(fp, k - 1, &ar, &ai);
+            fft_proc_bin(fp, k, &br, &bi);
+            fft_proc_bin(fp, k + 1, &cr, &ci);
+
+            /* Re((X[k-1] - X[k+1]) / (2X[k] - X[k-1] - X[k+1])) x 窗函數修正 */
+            d = s_jacobsen_p[fp->window] *
+                fft_proc_cdiv_re(ar - cr, ai - ci, 2.0f * br - ar - cr, 2.0f * bi - ai - ci);
+            break;
+        }
+
+        case FFT_INTERP_QUINN:
+        {
+            float ar, ai, br, bi, cr, ci;
+
+            fft_proc_bin(fp, k - 1, &ar, &ai);
+            fft_proc_bin(fp, k, &br, &bi);
+            fft_proc_bin(fp, k + 1, &cr, &ci);
+
+            float ap = fft_proc_cdiv_re(cr, ci, br, bi);
+            float am = fft_proc_cdiv_re(ar, ai, br, bi);
+            float dp = -ap / (1.0f - ap);
+            float dm = am / (1.0f - am);
+
+            d = 0.5f * (dp + dm) + fft_proc_quinn_tau(dp * dp) - fft_proc_quinn_tau(dm * dm);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    if (d != d)    d = 0.0f;        /* NaN (三點不像峰值) */
+    if (d > 0.5f)  d = 0.5f;
+    if (d < -0.5f) d = -0.5f;
+
+    return d;
+}
+
+static float fft_proc_sinc(float x)
+{
+    return (x == 0.0f) ? 1.0f : sinf(3.14159265f * x) / (3.14159265f * x);
+}
+
+/**
+ * @brief       目前窗函數在偏離頻點中心 d 時的相對增益 (d = 0 時為 1, 大 npt 近似)
+ * @note        餘弦和窗的頻譜為 a0 sinc(d) + Σ a_m / 2 (sinc(d - m) + sinc(d + m)),
+ *              win[] 已含 1 / a0 (= 1 / 相干增益) 的修正
+ */
+static float fft_proc_window_gain(const fft_proc_t *fp, float d)
+{
+    const float *a = s_win_coef[(fp->win == NULL) ? FFT_WIN_RECT : fp->window];
+    float g = a[0] * fft_proc_sinc(d);
+
+    for (int m = 1; m < FFT_WIN_TERMS; m++)
+    {
+        if (a[m] != 0.0f)
+        {
+            g += 0.5f * a[m] * (fft_proc_sinc(d - m) + fft_proc_sinc(d + m));
+        }
+    }
+
+    return g / a[0];
+}
+
+/**
+ * @brief       在 bin_start ~ bin_end 內找幅度最大的頻點, 再依 fp->interp 插值
+ * @note        峰值在範圍兩端 (沒有左右鄰點) 時不插值; 振幅依偏移修正窗函數的 scalloping loss
+ * @param       fp       : 管線 (fft_proc_spectrum*() 之後, 範圍需已計算幅度)
+ * @param       samp     : 採樣率 (Hz)
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @param       pk       : 輸出
+ * @retval      無
+ */
+void fft_proc_find_peak(const fft_proc_t *fp, float samp, uint16_t bin_start, uint16_t bin_end,
+                        fft_peak_t *pk)
+{
+    uint32_t idx = 0;
+    float value;
+
+    arm_max_f32(&fp->mag[bin_start], bin_end - bin_start + 1, &value, &idx);
+    fft_proc_refine_peak(fp, samp, bin_start, bin_end, bin_start + idx, pk);
+}
+
+/**
+ * @brief       以指定的峰值頻點填入 fft_peak_t (依 fp->interp 插值, 修正振幅)
+ * @note        供 fft_proc_find_peak() 與多峰值檢測 (peak_detect.h) 共用;
+ *              index 在範圍兩端 (沒有左右鄰點) 時不插值
+ * @param       fp       : 管線 (fft_proc_spectrum*() 之後, 範圍需已計算幅度)
+ * @param       samp     : 採樣率 (Hz)
+ * @param       bin_start: 已計算幅度的第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @param       index    : 峰值頻點 (bin_start ~ bin_end)
+ * @param       pk       : 輸出
+ * @retval      無
+ */
+void fft_proc_refine_peak(const fft_proc_t *fp, float samp, uint16_t bin_start, uint16_t bin_end,
+                          uint32_t index, fft_peak_t *pk)
+{
+    pk->index  = index;
+    pk->value  = fp->mag[index];
+    pk->offset = 0.0f;
+
+    if (fp->interp != FFT_INTERP_NONE && index > bin_start && index < bin_end)
+    {
+        pk->offset = fft_proc_interp(fp, index);
+    }
+
+    pk->freq = samp * ((float)index + pk->offset) / (float)fp->npt;
+    pk->amp  = pk->value * 2.0f / (float)fp->npt / fft_proc_window_gain(fp, pk->offset);
+}
+
+/**
+ * @brief       把 bin_start ~ bin_end 的幅度抽取成最多 max_count 點 (每 step 個頻點取最大值, 保留峰值)
+ * @param       fp       : 管線 (fft_proc_spectrum*() 之後, 範圍需已計算幅度)
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @param       dst      : 輸出, 至少 max_count 點
+ * @param       max_count: 輸出點數上限
+ * @param       step     : 輸出, 每點涵蓋的頻點數
+ * @retval      輸出點數
+ */
+uint16_t fft_proc_decimate_max(const fft_proc_t *fp, uint16_t bin_start, uint16_t bin_end,
+                               float *dst, uint16_t max_count, uint16_t *step)
+{
+    return fft_proc_decimate_mag(fp->mag, bin_start, bin_end, dst, max_count, step);
+}
+
+/**
+ * @brief       同 fft_proc_decimate_max(), 但讀呼叫端指定的幅度陣列
+ * @param       mag      : 幅度, 至少 bin_end + 1 點
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @param       dst      : 輸出, 至少 max_count 點
+ * @param       max_count: 輸出點數上限
+ * @param       step     : 輸出, 每點涵蓋的頻點數
+ * @retval      輸出點數
+ */
+uint16_t fft_proc_decimate_mag(const float *mag, uint16_t bin_start, uint16_t bin_end,
+                               float *dst, uint16_t max_count, uint16_t *step)
+{
+    int len = bin_end - bin_start + 1;
+    uint16_t st = (len + max_count - 1) / max_count;
+    uint16_t count = (len + st - 1) / st;
+
+    if (st == 1)
+    {
+        memcpy(dst, &mag[bin_start], len * sizeof(float));
+    }
+    else
+    {
+        for (uint16_t i = 0; i < count; i++)
+        {
+            int first = bin_start + i * st;
+            int n = bin_end - first + 1;
+            if (n > st) n = st;
+
+            uint32_t idx = 0;
+            arm_max_f32((float *)&mag[first], n, &dst[i], &idx);
+        }
+    }
+
+    *step = st;
+    return count;
+}
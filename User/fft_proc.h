@@ -0,0 +1,145 @@
+/**
+ ****************************************************************************************************
+ * @file        fft_proc.h
+ * @brief       頻譜處理管線: ADC 原始碼轉換, RFFT, 幅度, 頻點範圍, 峰值搜尋, 顯示用抽取
+ ****************************************************************************************************
+ * @attention
+ *
+ * 本模組不依賴 HAL, 只使用 CMSIS-DSP (arm_math.h) 與 profiler.h,
+ * 板端與主機端 (Tools/dsp_bench.c) 編譯的是同一份程式碼.
+ * 緩衝區由呼叫端提供, 放在哪一塊記憶體 (CCM / SRAM) 由呼叫端決定.
+ * fft_proc_init() 的點數即緩衝區容量, 不超過容量的每個點數都會預先規劃 RFFT 實例,
+ * 之後 fft_proc_set_npt() 只切換實例, 不重新初始化也不重新配置緩衝.
+ *
+ * 窗函數係數在切換點數或窗函數時產生一次, 並預先乘上 ADC => 電壓與振幅修正 (1 / 相干增益),
+ * fft_proc_load_u16() 只需每點一次乘法, 沒有額外的加窗迴圈.
+ * 振幅修正後, 正弦波峰值頻點的幅度與矩形窗相同 (A * npt / 2);
+ * 雜訊 / 頻帶能量要再乘上 energy_corr (= 相干增益 / RMS(w)), enbw 為等效雜訊頻寬 (頻點數).
+ *
+ * 定點管線 (FFT_PROC_USE_Q15 = 1, 編譯時選擇; 預設 0 為 arm_rfft_fast_f32):
+ *   ADC 原始碼直接轉成 q15 (adc_convert_q15), 以區塊浮點 (block floating point) 左移到接近滿刻度,
+ *   記下移位數 q15_shift, 再做 arm_rfft_q15 與 arm_cmplx_mag_q15; 只有計算範圍內的幅度換回 float,
+ *   因此 out[] 的單位與浮點管線相同, 之後的峰值搜尋 / 抽取 / dB 不需要分兩種.
+ *   緩衝區沿用同一組: in[] 放 q15 輸入, out[] 放 2 x npt 個 q15 的 RFFT 輸出, win[] 放 q15 窗函數.
+ *
+ * RFFT 之後 in[] 就用不到, 幅度寫回 in[] (mag 指向同一塊), out[] 的複數頻譜保留給峰值插值.
+ *   兩種管線的精度與耗時可用 Tools/q15_compare.sh 比較; q15 的運算 SNR 約 20 ~ 45dB,
+ *   低於 12-bit ADC 的量化 SNR (1V 約 70dB), 只在動態範圍夠用而耗時 / RAM 較重要時選用.
+ *
+ * 處理順序:
+ *   fft_proc_load_u16()  ADC 原始碼 => 去直流, 電壓 x 窗函數, 寫入 in[] (adc_convert.h)
+ *   fft_proc_bin_range() 頻率範圍 => 頻點範圍
+ *   fft_proc_spectrum_range()
+ *                        RFFT + 範圍內的幅度 (arm_cmplx_mag_f32), in[] 會被 RFFT 改寫;
+ *                        fft_proc_spectrum() 為整個頻譜 mag[0..npt/2]
+ *   fft_proc_find_peak() 範圍內的最大值, 依 interp 以左右鄰點插值出小於一個頻點的頻率與修正後的振幅;
+ *                        多個峰值由 peak_detect.h 挑出頻點, 再以 fft_proc_refine_peak() 插值
+ *   fft_proc_decimate_max() / fft_proc_to_db()
+ *                        抽取成顯示點數, 再轉成 dBV (快速 log2, 不呼叫 log10f)
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __FFT_PROC_H
+#define __FFT_PROC_H
+
+#include <stdint.h>
+#include "arm_math.h"
+
+
+#define FFT_PROC_ADC_VREF       3.3f        /* ADC 參考電壓 (V) */
+#define FFT_PROC_ADC_FULL_SCALE 4095.0f     /* 12-bit ADC 滿刻度 */
+
+#define FFT_PROC_NPT_MIN        64          /* 支援的點數: 64, 128, ..., 4096 */
+#define FFT_PROC_NPT_MAX        4096
+#define FFT_PROC_PLAN_COUNT     7
+
+#ifndef FFT_PROC_USE_Q15
+#define FFT_PROC_USE_Q15        0           /* 1: q15 定點管線 (arm_rfft_q15) */
+#endif
+
+#define FFT_PROC_DB_FLOOR       -160.0f     /* fft_proc_to_db() 的下限 (dBV) */
+
+typedef enum
+{
+    FFT_WIN_RECT = 0,           /* 矩形 (不加窗) */
+    FFT_WIN_HANN,
+    FFT_WIN_HAMMING,
+    FFT_WIN_BLACKMAN_HARRIS,    /* 4 項, 旁瓣 -92dB */
+    FFT_WIN_FLATTOP,            /* 5 項, 振幅誤差 < 0.01dB */
+    FFT_WIN_COUNT
+} fft_window_t;
+
+/* 峰值插值 (誤差與耗時見 Tools/interp_bench.c) */
+typedef enum
+{
+    FFT_INTERP_NONE = 0,        /* 只取最大的頻點 */
+    FFT_INTERP_PARABOLIC,       /* 三點幅度拋物線 */
+    FFT_INTERP_GAUSSIAN,        /* 三點對數幅度拋物線 */
+    FFT_INTERP_JACOBSEN,        /* 三點複數, 依窗函數修正 */
+    FFT_INTERP_QUINN,           /* Quinn 第二估計式, 三點複數 (只適用矩形窗) */
+    FFT_INTERP_COUNT
+} fft_interp_t;
+
+#if FFT_PROC_USE_Q15
+typedef arm_rfft_instance_q15       fft_proc_plan_t;
+#else
+typedef arm_rfft_fast_instance_f32  fft_proc_plan_t;
+#endif
+
+typedef struct
+{
+    fft_proc_plan_t plan[FFT_PROC_PLAN_COUNT];  /* plan[i] 為 FFT_PROC_NPT_MIN << i 點 */
+    fft_proc_plan_t *rfft;                      /* 目前使用的實例 */
+    float   *in;                /* capacity 點輸入 */
+    float   *out;               /* capacity 點 RFFT 輸出 (複數, CMSIS 格式) */
+    float   *mag;               /* = in, fft_proc_spectrum*() 後計算範圍內的 mag[k] 為幅度 */
+    uint16_t npt;               /* FFT 點數 */
+    uint16_t capacity;          /* in[] / out[] 的點數, 也是 npt 的上限 */
+
+    fft_window_t window;        /* 目前的窗函數 */
+    float   *win;               /* capacity 點, 窗函數 x 振幅修正 x ADC 換算; NULL 時只能用矩形窗 */
+    float    enbw;              /* 等效雜訊頻寬 (頻點數) */
+    float    energy_corr;       /* 能量修正倍數 (相對於振幅修正後的頻譜) */
+    uint8_t  remove_dc;         /* 1: 轉換時扣除本幀平均 (預設), out[0] 只剩 < 0.5 LSB 的殘留 */
+    fft_interp_t interp;        /* fft_proc_find_peak() 的插值方式 (預設 FFT_INTERP_NONE) */
+#if FFT_PROC_USE_Q15
+    uint8_t  q15_shift;         /* 本幀區塊浮點左移位數 */
+    float    q15_lsb;           /* 移位前 in[] 的 1 LSB 對應的電壓 (含振幅修正) */
+#endif
+} fft_proc_t;
+
+typedef struct
+{
+    uint32_t index;             /* 峰值頻點 */
+    float    value;             /* 峰值頻點的幅度 */
+    float    offset;            /* 插值偏移 (頻點, -0.5 ~ 0.5) */
+    float    freq;              /* 峰值頻率 (Hz), 含插值偏移 */
+    float    amp;               /* 正弦波振幅 (V 峰值), 已依偏移修正窗函數的 scalloping loss */
+} fft_peak_t;
+
+
+uint8_t fft_proc_init(fft_proc_t *fp, uint16_t npt, float *in, float *out, float *win);  /* 0: 成功; 1: 點數不支援 */
+uint8_t fft_proc_set_npt(fft_proc_t *fp, uint16_t npt);                         /* 0: 成功; 1: 不支援或超過容量 */
+uint8_t fft_proc_set_window(fft_proc_t *fp, fft_window_t window);               /* 0: 成功; 1: 不支援 */
+const char *fft_proc_window_name(fft_window_t window);
+const char *fft_proc_interp_name(fft_interp_t interp);
+void fft_proc_load_u16(fft_proc_t *fp, const uint16_t *src);
+void fft_proc_spectrum(fft_proc_t *fp);
+void fft_proc_spectrum_range(fft_proc_t *fp, uint16_t bin_start, uint16_t bin_end);
+void fft_proc_bin_range(const fft_proc_t *fp, float samp, float f_low, float f_high,
+                        uint16_t *bin_start, uint16_t *bin_end);
+void fft_proc_find_peak(const fft_proc_t *fp, float samp, uint16_t bin_start, uint16_t bin_end,
+                        fft_peak_t *pk);
+void fft_proc_refine_peak(const fft_proc_t *fp, float samp, uint16_t bin_start, uint16_t bin_end,
+                          uint32_t index, fft_peak_t *pk);
+uint16_t fft_proc_decimate_max(const fft_proc_t *fp, uint16_t bin_start, uint16_t bin_end,
+                               float *dst, uint16_t max_count, uint16_t *step);
+void fft_proc_to_db(const fft_proc_t *fp, const float *src, float *dst, uint16_t n);
+
+/* 不經管線的幅度陣列 (幅度同為 A * npt / 2, 例如 zoom_fft.h) */
+uint16_t fft_proc_decimate_mag(const float *mag, uint16_t bin_start, uint16_t bin_end,
+                               float *dst, uint16_t max_count, uint16_t *step);
+void fft_proc_mag_to_db(uint32_t npt, const float *src, float *dst, uint16_t n);
+
+#endif
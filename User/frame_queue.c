@@ -0,0 +1,104 @@
+/**
+ ****************************************************************************************************
+ * @file        frame_queue.c
+ * @brief       頻譜幀 SPSC 無鎖環形佇列
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "frame_queue.h"
+
+
+/* 索引更新前後的記憶體屏障: 確保槽內容先寫完/讀完, 才讓另一端看到新的索引 */
+#if defined(__CC_ARM)
+#define FQ_BARRIER()    __dmb(0xF)
+#elif defined(__GNUC__) || defined(__clang__)
+#define FQ_BARRIER()    __sync_synchronize()
+#else
+#define FQ_BARRIER()
+#endif
+
+#define FQ_MASK         (FRAME_QUEUE_DEPTH - 1)
+
+
+/**
+ * @brief       初始化佇列 (需在生產端/消費端開始工作之前呼叫)
+ * @param       q: 佇列
+ * @retval      無
+ */
+void frame_queue_init(frame_queue_t *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+/**
+ * @brief       生產端: 取得下一個可寫入的槽
+ * @param       q: 佇列
+ * @retval      可寫入的槽; 佇列已滿時回傳 NULL 並累計 dropped
+ */
+spec_frame_t *frame_queue_begin_write(frame_queue_t *q)
+{
+    uint32_t head = q->head;
+
+    if (head - q->tail >= FRAME_QUEUE_DEPTH)
+    {
+        q->dropped++;
+        return NULL;
+    }
+
+    FQ_BARRIER();   /* 讀到 tail 之後才能覆寫該槽 */
+    return &q->slot[head & FQ_MASK];
+}
+
+/**
+ * @brief       生產端: 發佈 frame_queue_begin_write() 取得的槽
+ * @param       q: 佇列
+ * @retval      無
+ */
+void frame_queue_commit(frame_queue_t *q)
+{
+    uint32_t head = q->head;
+
+    q->slot[head & FQ_MASK].seq = q->next_seq++;
+    FQ_BARRIER();
+    q->head = head + 1;
+}
+
+/**
+ * @brief       消費端: 略過所有較舊的幀, 取得最新一幀
+ * @note        回傳的幀在呼叫 frame_queue_release() 前不會被生產端覆寫
+ * @param       q: 佇列
+ * @retval      最新一幀; 佇列為空時回傳 NULL
+ */
+const spec_frame_t *frame_queue_read_latest(frame_queue_t *q)
+{
+    uint32_t tail = q->tail;
+    uint32_t head = q->head;
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+
+    if (head - tail > 1)
+    {
+        q->skipped += head - tail - 1;
+        tail = head - 1;
+        FQ_BARRIER();
+        q->tail = tail;
+    }
+
+    FQ_BARRIER();   /* 看到 head 之後才讀槽內容 */
+    return &q->slot[tail & FQ_MASK];
+}
+
+/**
+ * @brief       消費端: 釋放 frame_queue_read_latest() 取得的幀
+ * @param       q: 佇列
+ * @retval      無
+ */
+void frame_queue_release(frame_queue_t *q)
+{
+    FQ_BARRIER();   /* 讀完槽內容才歸還 */
+    q->tail = q->tail + 1;
+}
@@ -0,0 +1,74 @@
+/**
+ ****************************************************************************************************
+ * @file        frame_queue.h
+ * @brief       頻譜幀 SPSC 無鎖環形佇列
+ *              生產端: PendSV 中的 FFT_Calc()；消費端: LVGL timer 的 update_lvgl_charts()
+ ****************************************************************************************************
+ * @attention
+ *
+ * 只允許「一個生產者 + 一個消費者」，兩端各自只寫自己的索引 (head / tail)，
+ * 因此不需要關中斷或鎖。本檔不依賴 HAL，可直接在 Linux 主機上編譯。
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __FRAME_QUEUE_H
+#define __FRAME_QUEUE_H
+
+#include <stdint.h>
+
+
+#define FRAME_QUEUE_DEPTH       8       /* 佇列深度, 必須為 2 的冪 */
+#define SPEC_FRAME_MAX_BINS     256     /* 每幀最多保存的頻點數, 超過時以最大值抽取 */
+#define SPEC_FRAME_MAX_PEAKS    8       /* 每幀最多保存的峰值標記數 (與 PEAK_DETECT_MAX 相同) */
+
+/* 峰值標記 (多峰值檢測的結果) */
+typedef struct
+{
+    float    pos;                       /* 相對 bin_start 的頻點位置 (含插值偏移) */
+    float    freq;                      /* 頻率 (Hz) */
+    float    db;                        /* 峰值頻點的 dBV, 與 db[] 相同刻度 */
+} spec_peak_t;
+
+/* 一幀頻譜結果 (只保存 bin_start..bin_end 顯示範圍) */
+typedef struct
+{
+    uint32_t seq;                       /* 幀序號 (由佇列在 commit 時填入) */
+    uint8_t  channel;                   /* ADC 掃描通道 (見 adc_scan.h), 單通道時為 0 */
+    uint16_t bin_start;                 /* 第一個頻點 */
+    uint16_t bin_end;                   /* 最後一個頻點 */
+    uint16_t bin_step;                  /* db[i] 涵蓋的頻點數 (>1 表示已抽取) */
+    float    freq_start;                /* db[0] 的頻率 (Hz) */
+    float    freq_step;                 /* db[i] 與 db[i + 1] 的頻率間距 (Hz), 隨點數與 bin_step 改變 */
+    uint16_t count;                     /* db[] 有效長度 */
+    float    max_val;                   /* 峰值幅度 */
+    float    max_freq;                  /* 峰值頻率 (Hz) */
+    uint8_t  avg_mode;                  /* db[] 的平均模式 (spec_avg_mode_t) */
+    uint16_t avg_count;                 /* 已平均的幀數 */
+    uint16_t peak_count;                /* peaks[] 有效個數 */
+    spec_peak_t peaks[SPEC_FRAME_MAX_PEAKS];    /* 依幅度由大到小 */
+    float    db[SPEC_FRAME_MAX_BINS];   /* dBV (正弦波峰值), db[0] 對應 bin_start */
+} spec_frame_t;
+
+typedef struct
+{
+    spec_frame_t slot[FRAME_QUEUE_DEPTH];
+    volatile uint32_t head;             /* 只由生產端寫入 */
+    volatile uint32_t tail;             /* 只由消費端寫入 */
+    volatile uint32_t dropped;          /* 生產端: 佇列滿而丟棄的幀數 */
+    volatile uint32_t skipped;          /* 消費端: 只取最新幀時略過的舊幀數 */
+    uint32_t next_seq;                  /* 生產端: 下一個幀序號 */
+} frame_queue_t;
+
+
+void frame_queue_init(frame_queue_t *q);
+
+/* 生產端 */
+spec_frame_t *frame_queue_begin_write(frame_queue_t *q);        /* 取得可寫入的槽, 佇列滿時回傳 NULL */
+void frame_queue_commit(frame_queue_t *q);                      /* 發佈 begin_write 取得的槽 */
+
+/* 消費端 */
+const spec_frame_t *frame_queue_read_latest(frame_queue_t *q);  /* 略過舊幀, 回傳最新一幀, 空時回傳 NULL */
+void frame_queue_release(frame_queue_t *q);                     /* 釋放 read_latest 取得的幀 */
+
+#endif
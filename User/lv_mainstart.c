@@ -0,0 +1,885 @@
+/**
+ ****************************************************************************************************
+ * @file        lv_mainstart.c
+ * @brief       LVGL 介面: Wave / FFT 圖表, 刻度, 模式選擇與點數滑桿
+ ****************************************************************************************************
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "lvgl.h"
+#include "lv_port_indev_template.h"
+#include "lv_port_disp_template.h"
+#include "lv_mainstart.h"
+#include "profiler.h"
+#include "wave_decim.h"
+#include "spec_avg.h"
+#include "waterfall.h"
+
+
+static const ui_source_t *s_src;
+
+/* --- 與波形有關的全域變數 --- */
+/* 原本 wave_chart_low & wave_chart_high 由滑桿動態調整；現在改成程式自動偵測*/
+static int32_t wave_chart_low  = 600;
+static int32_t wave_chart_high = 1800;
+
+#define WAVE_RANGE_QUANT    50      /* Y 軸範圍對齊單位 (12-bit 原始碼) */
+#define WAVE_RANGE_SHRINK   200     /* 兩端空白超過此值才縮小範圍 */
+
+/* Wave Chart 欄數、FFT Chart 點數 (由底部滑塊控制) */
+static uint16_t wave_points = 250;
+static uint16_t fft_points = 206;
+
+/* fft_chart 的頻率軸: 滑塊最右 (FFT_POINTS_MAX 點) 時整幀 db[0 .. count-1] 鋪滿圖表, 點數較少時只顯示前段.
+ * 第 i 點對應 db[] 的位置 i * step, step = (count - 1) / (FFT_POINTS_MAX - 1) 可有小數,
+ * 因此與 FFT 點數無關 (1024 點 2kHz 時 count = 206, step = 1). 曲線, 峰值標記, 瀑布圖與底部刻度都用這個對應 */
+#define FFT_POINTS_MAX      206
+static float fft_view_step  = 1.0f;                                     /* 通道 0 最近一幀的 step */
+static float fft_freq_start = 250.0f;                                   /* 通道 0 最近一幀的 freq_start / freq_step */
+static float fft_freq_step  = (650.0f - 250.0f) / (FFT_POINTS_MAX - 1);
+static float fft_view_db[FFT_POINTS_MAX];                               /* 取樣到圖表各點的一幀 (dBV), 圖表與瀑布圖共用 */
+
+/* FFT 圖縱軸: dBV (正弦波峰值), 圖表內部以 0.1dB 為單位, 避免整數 dB 造成階梯 */
+#define FFT_DB_MIN          -100
+#define FFT_DB_MAX          0
+#define FFT_DB_UNIT         10
+
+/* 波形包絡: 整幀取樣抽取成每欄一組 min / max (見 wave_decim.h) */
+#define WAVE_COLS_MAX       250
+static uint16_t wave_env_min[WAVE_COLS_MAX];
+static uint16_t wave_env_max[WAVE_COLS_MAX];
+static uint16_t wave_env_cols = 0;              /* 0: 尚無資料 */
+
+/* 峰值標記: update_fft_chart() 由頻譜幀換算成圖表座標, fft_chart_draw_event_cb() 繪製 */
+#define FFT_MARKER_LABELS   3       /* 只有最大的幾個標上頻率, 其餘只畫點 (避免文字重疊) */
+static uint16_t fft_marker_count = 0;
+static float    fft_marker_x[SPEC_FRAME_MAX_PEAKS];         /* 圖表點索引 (含小數) */
+static int32_t  fft_marker_y[SPEC_FRAME_MAX_PEAKS];         /* 圖表單位 (0.1dB) */
+static char     fft_marker_text[FFT_MARKER_LABELS][16];
+
+/* 多通道: 每通道一條曲線疊在 fft_chart 上 (峰值標記避開橘色, 波形避開紅色) */
+static const lv_palette_t fft_ser_palette[UI_SPEC_CHANNELS_MAX] =
+{
+    LV_PALETTE_BLUE, LV_PALETTE_GREEN, LV_PALETTE_PURPLE, LV_PALETTE_CYAN
+};
+static lv_chart_series_t * fft_ser[UI_SPEC_CHANNELS_MAX];
+static uint8_t fft_channels = 1;
+
+/* LVGL 物件 */
+static lv_style_t style_large_text;
+static lv_obj_t * wave_chart = NULL;
+static lv_obj_t * fft_chart  = NULL;
+static lv_obj_t * freq_label = NULL;
+static lv_obj_t * avg_label  = NULL;
+static lv_obj_t * scale_container = NULL;
+static lv_obj_t * scale = NULL;
+
+static lv_obj_t * left_scale_container = NULL;
+static lv_obj_t * left_scale = NULL;
+static lv_obj_t * right_scale_container = NULL;
+static lv_obj_t * right_scale = NULL;
+
+static uint8_t  display_mode = 2; /* 0=只顯FFT,1=只顯Wave,2=Both,3=FFT+瀑布圖 */
+
+/* Radio (FFT/Wave/Both) */
+static lv_style_t style_radio;
+static lv_style_t style_radio_chk;
+static lv_style_t style_cb_text;
+static lv_style_t style_cb_enlarge; /* 用來放大 CheckBox 可點擊區域 */
+static lv_style_t style_slider_pad;
+static lv_style_t style_knob_small;
+static uint32_t active_index = 2;
+
+static void init_scale_container(void);
+static void create_freq_scale(int start, int end);
+static void create_wave_scale(int start, int end);
+static void scale_update_range(lv_obj_t * obj, int32_t start, int32_t end);
+static void wave_auto_range(int32_t wave_min, int32_t wave_max);
+static void create_left_scale(void);
+static void create_right_scale(void);
+static void radio_event_handler(lv_event_t * e);
+static void apply_display_mode(void);
+static void slider_event_cb(lv_event_t * e);
+/* ======= 已移除 wave_offset_slider_event_cb ======= */
+
+static void fft_chart_draw_event_cb(lv_event_t * e);
+static void wave_chart_draw_event_cb(lv_event_t * e);
+static void radiobutton_create(lv_obj_t * parent, const char * txt);
+static void create_mode_selector(void);
+static void update_lvgl_charts(lv_timer_t * t);
+static void update_fft_chart(uint8_t ch, const spec_frame_t *frame, const float *db, uint16_t point_count, float step);
+static float fft_frame_step(const spec_frame_t *frame);
+static void fft_view_resample(const spec_frame_t *frame, uint16_t points, float step, float *out);
+static void fft_scale_update(void);
+
+/* ---------------------------------------
+   LVGL 初始化，建立各式介面元件
+   --------------------------------------- */
+void lv_mainstart_init(const ui_source_t *src)
+{
+    s_src = src;
+
+    lv_init();
+    lv_port_disp_init();
+    lv_port_indev_init();
+    
+    /* 建立左邊/右邊的刻度容器 (垂直) */
+    create_left_scale();
+    create_right_scale();
+
+    /*=== 建立 wave_chart (min/max 包絡, 由 wave_chart_draw_event_cb 繪製) ===*/
+    wave_chart = lv_chart_create(lv_scr_act());
+    lv_chart_set_type(wave_chart, LV_CHART_TYPE_NONE);
+    lv_obj_set_style_size(wave_chart, 0, 0, LV_PART_INDICATOR);
+    lv_obj_set_style_pad_all(wave_chart, 0, LV_PART_MAIN);
+    
+    /* 背景、邊框透明 => 以便覆蓋在 FFT 上面但不遮擋 */
+    lv_obj_set_style_bg_opa(wave_chart, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(wave_chart, LV_OPA_TRANSP, LV_PART_MAIN);
+
+    /* 先給一個初始範圍; 之後會自動更新 */
+    lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_Y, wave_chart_low, wave_chart_high);
+    lv_obj_add_event_cb(wave_chart, wave_chart_draw_event_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+
+    /*=== 建立 fft_chart (柱狀圖/線圖) ===*/
+    fft_chart = lv_chart_create(lv_scr_act());
+    lv_chart_set_type(fft_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(fft_chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_obj_set_style_size(fft_chart, 0, 0, LV_PART_INDICATOR);
+    lv_obj_set_style_pad_all(fft_chart, 0, LV_PART_MAIN);
+    
+    lv_obj_set_style_bg_opa(fft_chart, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(fft_chart, LV_OPA_TRANSP, LV_PART_MAIN);
+
+    lv_chart_set_point_count(fft_chart, fft_points);
+    lv_chart_set_range(fft_chart, LV_CHART_AXIS_PRIMARY_Y, FFT_DB_MIN * FFT_DB_UNIT, FFT_DB_MAX * FFT_DB_UNIT);
+
+    lv_obj_add_event_cb(fft_chart, fft_chart_draw_event_cb, LV_EVENT_DRAW_MAIN_END, NULL);
+
+    fft_channels = src->spec_channels;
+    if (fft_channels < 1) fft_channels = 1;
+    if (fft_channels > UI_SPEC_CHANNELS_MAX) fft_channels = UI_SPEC_CHANNELS_MAX;
+
+    for (uint8_t ch = 0; ch < fft_channels; ch++)
+    {
+        fft_ser[ch] = lv_chart_add_series(fft_chart, lv_palette_main(fft_ser_palette[ch]), LV_CHART_AXIS_PRIMARY_Y);
+        int32_t * fft_arr = lv_chart_get_y_array(fft_chart, fft_ser[ch]);
+        for (uint16_t i = 0; i < fft_points; i++)
+        {
+            fft_arr[i] = FFT_DB_MIN * FFT_DB_UNIT;
+        }
+    }
+    lv_chart_refresh(fft_chart);
+
+    /*=== 瀑布圖 (緩衝由 src 提供, 沒有時不建立) ===*/
+    if (src->waterfall_index != NULL && src->waterfall_rgb != NULL)
+    {
+        lv_obj_t * wf = waterfall_create(lv_scr_act(), src->waterfall_index, src->waterfall_rgb,
+                                         FFT_DB_MIN, FFT_DB_MAX);
+        lv_obj_set_pos(wf, 0, 400 - WATERFALL_ROWS);
+    }
+
+    /*=== 根據 display_mode 分配大小位置 ===*/
+    apply_display_mode();
+
+    /*=== 大字體標籤 (顯示 FFT 頻率) ===*/
+    lv_style_init(&style_large_text);
+    lv_style_set_text_font(&style_large_text, &lv_font_montserrat_26);
+    freq_label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(freq_label, 550, 10);
+    lv_label_set_text(freq_label, "Freq: 0.00Hz");
+    lv_obj_add_style(freq_label, &style_large_text, 0);
+
+    /* 頻譜平均模式 (freq_label 下方, 關閉時為空) */
+    avg_label = lv_label_create(lv_scr_act());
+    lv_obj_set_pos(avg_label, 550, 45);
+    lv_label_set_text(avg_label, "");
+
+    /*=== 建立一個定時器 => 每 300ms 更新 Wave/FFT ===*/
+    lv_timer_create(update_lvgl_charts, 300, NULL);
+
+    /*=== 建立模式選擇 (CheckBox Radio) ===*/
+    create_mode_selector();
+
+    /*=== 建立底部 slider => 控制 Wave/FFT 點數 (0~100) ===*/
+    lv_obj_t * slider = lv_slider_create(lv_scr_act());
+    lv_slider_set_range(slider, 0, 100);
+    lv_slider_set_value(slider, 100, LV_ANIM_OFF);
+    lv_obj_set_width(slider, 700);
+    lv_obj_align(slider, LV_ALIGN_BOTTOM_MID, 0, -23);
+    lv_obj_move_foreground(slider);
+    lv_obj_add_event_cb(slider, slider_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
+
+    /*=== 美化一下 slider 外觀 ===*/
+    lv_style_init(&style_knob_small);
+    lv_style_set_bg_opa(&style_knob_small, LV_OPA_TRANSP);
+    lv_style_set_border_opa(&style_knob_small, LV_OPA_TRANSP);
+    lv_style_set_outline_opa(&style_knob_small, LV_OPA_TRANSP);
+    lv_obj_add_style(slider, &style_knob_small, LV_PART_KNOB);
+
+    lv_style_init(&style_slider_pad);
+    lv_style_set_pad_all(&style_slider_pad, 12);
+    lv_style_set_border_opa(&style_slider_pad, LV_OPA_TRANSP);
+    lv_style_set_outline_opa(&style_slider_pad, LV_OPA_TRANSP);
+    lv_obj_add_style(slider, &style_slider_pad, LV_PART_MAIN);
+
+    /*=== 底部的頻率刻度 (水平) ===*/
+    init_scale_container();
+    create_freq_scale(250, 650);  // 預設顯示 250..650Hz
+
+    /*
+     * ==【注意】==
+     * 右邊調整波形高低的 slider 已被移除，
+     * 不再需要手動改 wave_chart_low / wave_chart_high。
+     * 下面這段原本用來建立 wave_offset_slider 的程式已刪除。
+     */
+}
+
+/* ---------------------------------------
+   底部容器/刻度
+   --------------------------------------- */
+static void init_scale_container()
+{
+    scale_container = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(scale_container, 800, 80);
+    lv_obj_set_pos(scale_container, 0, 395);
+    lv_obj_set_style_bg_opa(scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_move_background(scale_container);
+    lv_obj_clear_flag(scale_container, LV_OBJ_FLAG_SCROLLABLE);
+}
+
+/* 底部頻率刻度 (只建立一次, 之後以 scale_update_range() 更新) */
+static void create_freq_scale(int start, int end)
+{
+    scale = lv_scale_create(scale_container);
+    lv_obj_set_size(scale, lv_pct(110), 70);
+    lv_obj_center(scale);
+    lv_scale_set_label_show(scale, true);
+    lv_scale_set_mode(scale, LV_SCALE_MODE_HORIZONTAL_BOTTOM);
+    lv_scale_set_range(scale, start, end);
+    lv_scale_set_total_tick_count(scale, 9);
+    lv_scale_set_major_tick_every(scale, 1);
+    lv_obj_set_style_length(scale, 0, LV_PART_ITEMS);
+    lv_obj_set_style_length(scale, 8, LV_PART_INDICATOR);
+}
+
+/* ---------------------------------------
+   左側/右側的刻度容器 (顯示波形或其他量測值)
+   --------------------------------------- */
+static void create_wave_scale(int start, int end)
+{
+    left_scale = lv_scale_create(left_scale_container);
+
+    lv_obj_set_size(left_scale, 40, 400);
+    lv_obj_align(left_scale, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    lv_scale_set_mode(left_scale, LV_SCALE_MODE_VERTICAL_LEFT);
+    lv_scale_set_range(left_scale, start, end);
+    lv_scale_set_total_tick_count(left_scale, 5);
+    lv_scale_set_major_tick_every(left_scale, 1);
+    lv_scale_set_label_show(left_scale, true);
+
+    lv_obj_set_style_length(left_scale, 0, LV_PART_ITEMS);
+    lv_obj_set_style_length(left_scale, 8, LV_PART_INDICATOR);
+
+    lv_obj_set_style_line_color(left_scale, lv_color_black(), LV_PART_INDICATOR);
+    lv_obj_set_style_line_width(left_scale, 2, LV_PART_INDICATOR);
+    lv_obj_set_style_text_color(left_scale, lv_color_black(), LV_PART_MAIN);
+}
+
+/**
+ * @brief       更新刻度範圍; 範圍沒變時不動作 (lv_scale_set_range 每次都會讓整個刻度重繪)
+ * @param       obj  : lv_scale 物件
+ * @param       start: 下限
+ * @param       end  : 上限
+ * @retval      無
+ */
+static void scale_update_range(lv_obj_t * obj, int32_t start, int32_t end)
+{
+    if (lv_scale_get_range_min_value(obj) == start && lv_scale_get_range_max_value(obj) == end)
+    {
+        return;
+    }
+
+    lv_scale_set_range(obj, start, end);
+}
+
+static void create_left_scale(void)
+{
+    left_scale_container = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(left_scale_container, 70, 400);
+    lv_obj_set_pos(left_scale_container, 730, 0);
+
+    lv_obj_set_style_bg_opa(left_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(left_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(left_scale_container, 2, 0);
+    lv_obj_set_style_border_color(left_scale_container, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_clear_flag(left_scale_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    /* 一開始先用預設 600..1800，稍後會自動調整 */
+    create_wave_scale(wave_chart_low, wave_chart_high);
+}
+
+static void create_right_scale(void)
+{
+    right_scale_container = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(right_scale_container, 70, 400);
+    lv_obj_set_pos(right_scale_container, 0, 0);
+
+    lv_obj_set_style_bg_opa(right_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_opa(right_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(right_scale_container, 2, 0);
+    lv_obj_set_style_border_color(right_scale_container, lv_palette_main(LV_PALETTE_RED), 0);
+    lv_obj_clear_flag(right_scale_container, LV_OBJ_FLAG_SCROLLABLE);
+
+    right_scale = lv_scale_create(right_scale_container);
+    lv_obj_set_size(right_scale, 40, 400);
+    lv_obj_align(right_scale, LV_ALIGN_TOP_RIGHT, 0, 0);
+
+    lv_scale_set_mode(right_scale, LV_SCALE_MODE_VERTICAL_RIGHT);
+    lv_scale_set_range(right_scale, FFT_DB_MIN, FFT_DB_MAX);       /* dBV, 與 fft_chart 相同 */
+    lv_scale_set_total_tick_count(right_scale, 5);
+    lv_scale_set_major_tick_every(right_scale, 1);
+    lv_scale_set_label_show(right_scale, true);
+
+    lv_obj_set_style_length(right_scale, 0, LV_PART_ITEMS);
+    lv_obj_set_style_length(right_scale, 8, LV_PART_INDICATOR);
+
+    lv_obj_set_style_line_color(right_scale, lv_color_black(), LV_PART_INDICATOR);
+    lv_obj_set_style_line_width(right_scale, 2, LV_PART_INDICATOR);
+    lv_obj_set_style_text_color(right_scale, lv_color_black(), LV_PART_MAIN);
+}
+
+/* ---------------------------------------
+   模式選擇 (FFT / Wave / Both)
+   --------------------------------------- */
+static void radio_event_handler(lv_event_t * e)
+{
+    uint32_t *active_id = (uint32_t *)lv_event_get_user_data(e);
+    lv_obj_t *cont = lv_event_get_current_target(e);
+    lv_obj_t *act_cb = lv_event_get_target_obj(e);
+    lv_obj_t *old_cb = lv_obj_get_child(cont, *active_id);
+
+    if (act_cb == cont) {
+        return;
+    }
+
+    lv_obj_remove_state(old_cb, LV_STATE_CHECKED);
+    lv_obj_add_state(act_cb, LV_STATE_CHECKED);
+    *active_id   = lv_obj_get_index(act_cb);
+    display_mode = (uint8_t)(*active_id);
+
+    apply_display_mode();
+}
+
+/**
+ * @brief       依 display_mode 顯示 / 隱藏各圖表並分配位置
+ * @note        瀑布圖模式: fft_chart 縮到上方 400 - WATERFALL_ROWS 列, 右側 dB 刻度跟著縮,
+ *              瀑布圖在下方與 fft_chart 同寬 (欄與頻率刻度對齊)
+ * @param       無
+ * @retval      無
+ */
+static void apply_display_mode(void)
+{
+    int32_t fft_h = (display_mode == 3) ? 400 - WATERFALL_ROWS : 400;
+
+    if (display_mode == 1)
+    {
+        lv_obj_add_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
+    }
+    else
+    {
+        lv_obj_clear_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_pos(fft_chart, 0, 0);
+        lv_obj_set_size(fft_chart, 800, fft_h);
+        lv_obj_set_height(right_scale, fft_h);
+    }
+
+    if (display_mode == 1 || display_mode == 2)
+    {
+        lv_obj_clear_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
+        lv_obj_set_pos(wave_chart, 0, 0);
+        lv_obj_set_size(wave_chart, 800, 400);
+    }
+    else
+    {
+        lv_obj_add_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    waterfall_set_visible(display_mode == 3);
+}
+
+static void slider_event_cb(lv_event_t * e)
+{
+    lv_obj_t * slider = lv_event_get_target(e);
+    int16_t val = lv_slider_get_value(slider);
+
+    /* 改變 Wave/FFT 的點數 (範圍: wave=50~250, fft=110~206) */
+    uint16_t newWavePoints = 50 + (200 * val) / 100;
+    if (newWavePoints < 50)  newWavePoints = 50;
+    if (newWavePoints > 250) newWavePoints = 250;
+    wave_points = newWavePoints;
+
+    uint16_t newFftPoints = 110 + (176 * val) / 100;
+    if (newFftPoints < 110) newFftPoints = 110;
+    if (newFftPoints > 206) newFftPoints = 206;
+    fft_points = newFftPoints;
+
+    fft_scale_update();
+
+    /* wave 欄數在下一次 update_lvgl_charts() 生效 */
+
+    lv_chart_set_point_count(fft_chart, fft_points);
+    lv_chart_set_range(fft_chart, LV_CHART_AXIS_PRIMARY_X, 0, fft_points - 1);
+    lv_chart_refresh(fft_chart);
+}
+
+static void radiobutton_create(lv_obj_t * parent, const char * txt)
+{
+    lv_obj_t * obj = lv_checkbox_create(parent);
+    lv_checkbox_set_text(obj, txt);
+    lv_obj_add_style(obj, &style_cb_enlarge, LV_PART_MAIN);
+
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_EVENT_BUBBLE);
+
+    lv_obj_add_style(obj, &style_cb_text,   LV_PART_MAIN);
+    lv_obj_add_style(obj, &style_radio,     LV_PART_INDICATOR);
+    lv_obj_add_style(obj, &style_radio_chk, LV_PART_INDICATOR | LV_STATE_CHECKED);
+}
+
+static void create_mode_selector(void)
+{
+    lv_style_init(&style_radio);
+    lv_style_set_radius(&style_radio, LV_RADIUS_CIRCLE);
+    lv_style_set_border_width(&style_radio, 3);
+    lv_style_set_border_color(&style_radio, lv_color_black());
+    lv_style_set_width(&style_radio, 30);
+    lv_style_set_height(&style_radio, 30);
+
+    lv_style_init(&style_radio_chk);
+    lv_style_set_bg_color(&style_radio_chk, lv_palette_main(LV_PALETTE_BLUE));
+    lv_style_set_border_width(&style_radio_chk, 3);
+    lv_style_set_border_color(&style_radio_chk, lv_palette_darken(LV_PALETTE_BLUE, 3));
+
+    lv_style_init(&style_cb_text);
+    lv_style_set_text_font(&style_cb_text, &lv_font_montserrat_26);
+
+    lv_style_init(&style_cb_enlarge);
+    lv_style_set_pad_all(&style_cb_enlarge, 10);
+
+    lv_obj_t * cont = lv_obj_create(lv_scr_act());
+    lv_obj_set_size(cont, 300, 300);
+    lv_obj_set_pos(cont, 0, 0);
+
+    lv_obj_set_style_bg_opa(cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_opa(cont, LV_OPA_TRANSP, 0);
+
+    lv_obj_add_event_cb(cont, radio_event_handler, LV_EVENT_CLICKED, &active_index);
+
+    radiobutton_create(cont, "FFT");
+    lv_obj_set_pos(lv_obj_get_child(cont, 0), 10, 10);
+
+    radiobutton_create(cont, "WAVE");
+    lv_obj_set_pos(lv_obj_get_child(cont, 1), 10, 50);
+
+    radiobutton_create(cont, "BOTH");
+    lv_obj_set_pos(lv_obj_get_child(cont, 2), 10, 90);
+
+    radiobutton_create(cont, "WFALL");
+    lv_obj_set_pos(lv_obj_get_child(cont, 3), 10, 130);
+
+    lv_obj_add_state(lv_obj_get_child(cont, 2), LV_STATE_CHECKED);
+    lv_obj_move_foreground(cont);
+}
+
+/* --------------------------------------------------
+   周期性 Timer 回呼 => 更新 Wave / FFT 顯示
+   -------------------------------------------------- */
+static void update_lvgl_charts(lv_timer_t * t)
+{
+    LV_UNUSED(t);
+
+    PROF_BEGIN(PROF_ZONE_UI_UPDATE);
+
+    /* --- (A) 更新波形顯示 --- */
+    if (!lv_obj_has_flag(wave_chart, LV_OBJ_FLAG_HIDDEN))
+    {
+        /* 整幀取樣 => 每欄一組 min / max (窄脈衝也不會漏掉) */
+        uint16_t wave_len;
+        const uint16_t *wave_src = s_src->wave_frame(&wave_len);
+
+        wave_env_cols = wave_points;
+        wave_decim_minmax(wave_src, wave_len, wave_env_cols, wave_env_min, wave_env_max);
+
+        /* >>>>>> 自動校準 (Auto-Scaling) : 找出波形最小 / 最大值，動態調整 Y 軸範圍 <<<<<< */
+        int32_t wave_min_i32 = INT32_MAX;
+        int32_t wave_max_i32 = INT32_MIN;
+
+        for (uint16_t i = 0; i < wave_env_cols; i++)
+        {
+            if (wave_env_min[i] < wave_min_i32) wave_min_i32 = wave_env_min[i];
+            if (wave_env_max[i] > wave_max_i32) wave_max_i32 = wave_env_max[i];
+        }
+
+        wave_auto_range(wave_min_i32, wave_max_i32);
+
+        lv_obj_invalidate(wave_chart);
+    }
+
+    /* --- (B) 更新 FFT 顯示 (每通道只取最新一幀，較舊的幀由佇列計入 skipped) --- */
+    for (uint8_t ch = 0; ch < fft_channels; ch++)
+    {
+        frame_queue_t *queue = &s_src->spec_queue[ch];
+        const spec_frame_t *frame = frame_queue_read_latest(queue);
+        if (frame == NULL)
+        {
+            continue;
+        }
+
+        uint8_t chart_visible = !lv_obj_has_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
+        if (frame->count == 0 || (ch != 0 && !chart_visible))
+        {
+            frame_queue_release(queue);
+            continue;
+        }
+
+        /* 圖表與瀑布圖用同一份取樣, 頻率軸跟著通道 0 (點數或頻帶改變時刻度一起更新) */
+        uint16_t points = lv_chart_get_point_count(fft_chart);
+        float step = fft_frame_step(frame);
+        fft_view_resample(frame, points, step, fft_view_db);
+
+        if (ch == 0)
+        {
+            fft_view_step  = step;
+            fft_freq_start = frame->freq_start;
+            fft_freq_step  = frame->freq_step;
+            fft_scale_update();
+        }
+
+        if (chart_visible)
+        {
+            update_fft_chart(ch, frame, fft_view_db, points, step);
+        }
+
+        /* 瀑布圖隱藏時也加入 (只寫索引), 切回瀑布圖模式時歷史是連續的 */
+        if (ch == 0)
+        {
+            waterfall_add_frame(fft_view_db, points);
+        }
+        frame_queue_release(queue);
+    }
+
+    PROF_END(PROF_ZONE_UI_UPDATE);
+}
+
+/**
+ * @brief       依波形的最小 / 最大值調整 Y 軸與刻度 (有遲滯)
+ * @note        範圍以 WAVE_RANGE_QUANT 對齊; 波形超出目前範圍時立即放大,
+ *              兩端都留有超過 WAVE_RANGE_SHRINK 的空白時才縮小, 避免刻度隨雜訊每次跳動
+ * @param       wave_min: 最小值 (12-bit 原始碼)
+ * @param       wave_max: 最大值
+ * @retval      無
+ */
+static void wave_auto_range(int32_t wave_min, int32_t wave_max)
+{
+    int32_t low, high;
+
+    /* 避免全都是 NONE 或者怪異數值時失效 */
+    if (wave_min >= wave_max)
+    {
+        low  = 0;
+        high = 4095;  // 12-bit ADC 的最大值
+    }
+    else
+    {
+        /* 給一點餘裕，避免貼到邊緣 */
+        low  = (wave_min - 150) / WAVE_RANGE_QUANT * WAVE_RANGE_QUANT;
+        high = (wave_max + 100 + WAVE_RANGE_QUANT - 1) / WAVE_RANGE_QUANT * WAVE_RANGE_QUANT;
+        if (low < 0)      low = 0;
+        if (high > 4095)  high = 4095;
+    }
+
+    int grow   = (low < wave_chart_low) || (high > wave_chart_high);
+    int shrink = (low - wave_chart_low > WAVE_RANGE_SHRINK) || (wave_chart_high - high > WAVE_RANGE_SHRINK);
+
+    if (!grow && !shrink)
+    {
+        return;
+    }
+
+    /* 只放大一端時另一端保持不動 */
+    if (grow && !shrink)
+    {
+        if (low > wave_chart_low)   low = wave_chart_low;
+        if (high < wave_chart_high) high = wave_chart_high;
+    }
+
+    wave_chart_low  = low;
+    wave_chart_high = high;
+
+    lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_Y, wave_chart_low, wave_chart_high);
+    scale_update_range(left_scale, wave_chart_low, wave_chart_high);  // 順便更新左邊刻度
+}
+
+/* 12-bit 原始碼 => 螢幕 y (依目前 Y 軸範圍, 超出範圍時夾在邊緣) */
+static int32_t wave_value_to_y(const lv_area_t * area, int32_t v)
+{
+    int32_t h = lv_area_get_height(area) - 1;
+    int32_t y = area->y2 - (v - wave_chart_low) * h / (wave_chart_high - wave_chart_low);
+
+    if (y < area->y1) y = area->y1;
+    if (y > area->y2) y = area->y2;
+    return y;
+}
+
+/**
+ * @brief       wave_chart 繪製完背景與格線後, 以每欄一個矩形畫出 min/max 包絡
+ * @note        繪製量只與欄數 (wave_points) 有關, 與取樣數無關
+ * @param       e: LV_EVENT_DRAW_MAIN_END
+ * @retval      無
+ */
+static void wave_chart_draw_event_cb(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    lv_layer_t * layer = lv_event_get_layer(e);
+    lv_area_t area;
+    lv_draw_rect_dsc_t dsc;
+
+    if (wave_env_cols == 0)
+    {
+        return;
+    }
+
+    lv_obj_get_content_coords(obj, &area);
+    int32_t w = lv_area_get_width(&area);
+
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_color = lv_palette_main(LV_PALETTE_RED);
+    dsc.bg_opa   = LV_OPA_COVER;
+    dsc.radius   = 0;
+
+    for (uint16_t i = 0; i < wave_env_cols; i++)
+    {
+        lv_area_t col;
+
+        col.x1 = area.x1 + (int32_t)i * w / wave_env_cols;
+        col.x2 = area.x1 + (int32_t)(i + 1) * w / wave_env_cols - 1;
+        col.y1 = wave_value_to_y(&area, wave_env_max[i]);
+        col.y2 = wave_value_to_y(&area, wave_env_min[i]);
+        if (col.x2 < col.x1) col.x2 = col.x1;
+
+        lv_draw_rect(layer, &dsc, &col);
+    }
+}
+
+/**
+ * @brief       一幀頻譜的 step: 圖表每點跨過的 db[] 數 (見 fft_view_step)
+ * @param       frame: 頻譜幀 (count > 0)
+ * @retval      step
+ */
+static float fft_frame_step(const spec_frame_t *frame)
+{
+    return (frame->count > 1) ? (frame->count - 1) / (float)(FFT_POINTS_MAX - 1) : 1.0f;
+}
+
+/**
+ * @brief       一幀頻譜 => 圖表各點的 dBV (第 i 點對應 db[i * step])
+ * @note        step < 1 (頻點比圖表點少, 例如 512 點以下) 時線性內插;
+ *              step > 1 時取該點跨過的 db[i * step .. (i+1) * step) 的最大值, 窄峰不會被跳過
+ * @param       frame : 頻譜幀 (count > 0)
+ * @param       points: 圖表點數 (<= FFT_POINTS_MAX)
+ * @param       step  : fft_frame_step()
+ * @param       out   : 輸出, points 點
+ * @retval      無
+ */
+static void fft_view_resample(const spec_frame_t *frame, uint16_t points, float step, float *out)
+{
+    const float *db = frame->db;
+    uint16_t last = frame->count - 1;
+
+    for (uint16_t i = 0; i < points; i++)
+    {
+        float x = i * step;
+        uint16_t j = (uint16_t)x;
+
+        if (j >= last)
+        {
+            out[i] = db[last];
+        }
+        else if (step <= 1.0f)
+        {
+            out[i] = db[j] + (x - j) * (db[j + 1] - db[j]);
+        }
+        else
+        {
+            uint16_t end = (uint16_t)(x + step);
+            float v = db[j];
+
+            if (end > last) end = last;
+            for (uint16_t k = j + 1; k < end; k++)
+            {
+                if (db[k] > v) v = db[k];
+            }
+            out[i] = v;
+        }
+    }
+}
+
+/* 底部頻率刻度 = 圖表第 0 點 ~ 第 fft_points-1 點的頻率 (通道 0 最近一幀) */
+static void fft_scale_update(void)
+{
+    float freq_e = fft_freq_start + (fft_points - 1) * fft_view_step * fft_freq_step;
+
+    scale_update_range(scale, (int32_t)(fft_freq_start + 0.5f), (int32_t)(freq_e + 0.5f));
+}
+
+/**
+ * @brief       一幀頻譜 => 該通道的曲線; 通道 0 另外更新峰值標記與頻率 / 平均文字
+ * @param       ch         : 通道 (< fft_channels)
+ * @param       frame      : 頻譜幀
+ * @param       db         : fft_view_resample() 取樣到圖表各點的 dBV
+ * @param       point_count: 圖表點數
+ * @param       step       : fft_frame_step()
+ * @retval      無
+ */
+static void update_fft_chart(uint8_t ch, const spec_frame_t *frame, const float *db, uint16_t point_count, float step)
+{
+    int32_t * arr = lv_chart_get_y_array(fft_chart, fft_ser[ch]);
+
+    for (uint16_t i = 0; i < point_count; i++)
+    {
+        arr[i] = 0;
+        if (i < 3 || i >= point_count - 3)
+        {
+            arr[i] = LV_CHART_POINT_NONE;
+        }
+        else
+        {
+            /* db[] 已是 dBV, 只需換成圖表單位並夾在縱軸範圍內 */
+            float val_f = db[i] * FFT_DB_UNIT;
+            if (val_f > FFT_DB_MAX * FFT_DB_UNIT) val_f = FFT_DB_MAX * FFT_DB_UNIT;
+            if (val_f < FFT_DB_MIN * FFT_DB_UNIT) val_f = FFT_DB_MIN * FFT_DB_UNIT;
+            arr[i] = (int32_t) val_f;
+        }
+    }
+
+    if (ch != 0)
+    {
+        lv_chart_refresh(fft_chart);
+        return;
+    }
+
+    /* 峰值標記: 幀內頻點位置 => db[] 位置 (/ bin_step) => 圖表點索引 (第 i 點對應 db[i * step]) */
+    fft_marker_count = 0;
+    for (uint16_t i = 0; i < frame->peak_count && i < SPEC_FRAME_MAX_PEAKS; i++)
+    {
+        const spec_peak_t *pk = &frame->peaks[i];
+        float x = pk->pos / (frame->bin_step * step);
+
+        if (x < 0.0f || x > (float)(point_count - 1))
+        {
+            continue;
+        }
+
+        float val_f = pk->db * FFT_DB_UNIT;
+        if (val_f > FFT_DB_MAX * FFT_DB_UNIT) val_f = FFT_DB_MAX * FFT_DB_UNIT;
+        if (val_f < FFT_DB_MIN * FFT_DB_UNIT) val_f = FFT_DB_MIN * FFT_DB_UNIT;
+
+        if (fft_marker_count < FFT_MARKER_LABELS)
+        {
+            snprintf(fft_marker_text[fft_marker_count], sizeof(fft_marker_text[0]), "%.1f", pk->freq);
+        }
+
+        fft_marker_x[fft_marker_count] = x;
+        fft_marker_y[fft_marker_count] = (int32_t)val_f;
+        fft_marker_count++;
+    }
+
+    lv_chart_refresh(fft_chart);
+
+    static char freq_text[32];
+    snprintf(freq_text, sizeof(freq_text), "Freq: %.2fHz", frame->max_freq);
+    lv_label_set_text(freq_label, freq_text);
+
+    /* 文字沒變時不呼叫 lv_label_set_text (避免每次更新都重繪標籤) */
+    static char avg_text[32];
+    char text[32] = "";
+
+    if (frame->avg_mode != SPEC_AVG_OFF)
+    {
+        snprintf(text, sizeof(text), "avg: %s (%u)", spec_avg_mode_name((spec_avg_mode_t)frame->avg_mode),
+                 frame->avg_count);
+    }
+
+    if (strcmp(text, avg_text) != 0)
+    {
+        strcpy(avg_text, text);
+        lv_label_set_text(avg_label, avg_text);
+    }
+}
+
+/**
+ * @brief       fft_chart 畫完曲線後, 在多峰值檢測的位置畫上標記 (最大的幾個附頻率)
+ * @note        座標換算與 lv_chart 的折線相同: 第 i 點 x = x1 + i * w / (點數 - 1)
+ * @param       e: LV_EVENT_DRAW_MAIN_END
+ * @retval      無
+ */
+static void fft_chart_draw_event_cb(lv_event_t * e)
+{
+    lv_obj_t * obj = lv_event_get_target(e);
+    lv_layer_t * layer = lv_event_get_layer(e);
+    lv_area_t area;
+    lv_draw_rect_dsc_t dot;
+    lv_draw_label_dsc_t txt;
+
+    if (fft_marker_count == 0)
+    {
+        return;
+    }
+
+    lv_obj_get_content_coords(obj, &area);
+    int32_t w = lv_area_get_width(&area);
+    int32_t h = lv_area_get_height(&area);
+    uint16_t point_count = lv_chart_get_point_count(obj);
+    int32_t y_range = (FFT_DB_MAX - FFT_DB_MIN) * FFT_DB_UNIT;
+
+    if (point_count < 2)
+    {
+        return;
+    }
+
+    lv_draw_rect_dsc_init(&dot);
+    dot.bg_color = lv_palette_main(LV_PALETTE_ORANGE);
+    dot.bg_opa   = LV_OPA_COVER;
+    dot.radius   = LV_RADIUS_CIRCLE;
+
+    lv_draw_label_dsc_init(&txt);
+    txt.color = lv_palette_darken(LV_PALETTE_ORANGE, 2);
+    txt.align = LV_TEXT_ALIGN_CENTER;
+    int32_t line_h = lv_font_get_line_height(txt.font);
+
+    for (uint16_t i = 0; i < fft_marker_count; i++)
+    {
+        int32_t x = area.x1 + (int32_t)(fft_marker_x[i] * w / (point_count - 1));
+        int32_t y = area.y1 + h - (fft_marker_y[i] - FFT_DB_MIN * FFT_DB_UNIT) * h / y_range;
+        lv_area_t a;
+
+        a.x1 = x - 4;
+        a.x2 = x + 4;
+        a.y1 = y - 4;
+        a.y2 = y + 4;
+        lv_draw_rect(layer, &dot, &a);
+
+        if (i < FFT_MARKER_LABELS)
+        {
+            txt.text = fft_marker_text[i];
+            a.x1 = x - 40;
+            a.x2 = x + 40;
+            a.y2 = y - 6;
+            a.y1 = a.y2 - line_h + 1;
+            lv_draw_label(layer, &txt, &a);
+        }
+    }
+}
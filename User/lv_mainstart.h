@@ -0,0 +1,38 @@
+/**
+ ****************************************************************************************************
+ * @file        lv_mainstart.h
+ * @brief       LVGL 介面: Wave / FFT 圖表, 刻度, 模式選擇與點數滑桿
+ ****************************************************************************************************
+ * @attention
+ *
+ * 介面只透過 ui_source_t 取得資料, 不直接接觸 ADC / DMA / PendSV,
+ * 板端 (main.c) 與主機端模擬器 (Tools/sim) 使用同一份程式碼.
+ * lv_mainstart_init() 內呼叫 lv_init(), lv_port_disp_init(), lv_port_indev_init(),
+ * 顯示與觸控由各自的 port 檔提供.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __LV_MAINSTART_H
+#define __LV_MAINSTART_H
+
+#include <stdint.h>
+#include "frame_queue.h"
+
+
+#define UI_SPEC_CHANNELS_MAX    4           /* fft_chart 上最多疊加的通道數 (每通道一條曲線) */
+
+/* 介面的資料來源 */
+typedef struct
+{
+    frame_queue_t *spec_queue;              /* 頻譜幀, 每通道一個佇列 (spec_channels 個), 介面為消費端 */
+    const uint16_t *(*wave_frame)(uint16_t *len);   /* 最近一幀 12-bit 原始波形, *len 為取樣數 */
+    uint8_t  *waterfall_index;              /* 瀑布圖索引歷史, WATERFALL_ROWS x WATERFALL_COLS byte (NULL: 不建立瀑布圖) */
+    uint16_t *waterfall_rgb;                /* 瀑布圖畫面, WATERFALL_ROWS x WATERFALL_COLS 個 RGB565 */
+    uint8_t   spec_channels;                /* spec_queue[] 的通道數 (0 視為 1); 標記, 文字與瀑布圖只跟通道 0 */
+} ui_source_t;
+
+
+void lv_mainstart_init(const ui_source_t *src);     /* src 需在整個執行期間有效 */
+
+#endif
@@ -8,27 +8,132 @@
 
 /* LVGL */
 #include "lvgl.h"
-#include "lv_port_indev_template.h"
-#include "lv_port_disp_template.h"
+#include "lv_mainstart.h"
 
 #include <stdio.h>
 #include <string.h>
 #include "arm_math.h"
 #include "arm_const_structs.h"
+#include "frame_queue.h"
+#include "fft_job.h"
+#include "telemetry.h"
+#include "mem_map.h"
+#include "profiler.h"
+#include "fft_proc.h"
+#include "peak_detect.h"
+#include "spec_avg.h"
+#include "waterfall.h"
+#include "tone_bank.h"
+#include "zoom_fft.h"
+#include "adc_scan.h"
+#include "adc_synth.h"
 
 /* HAL Handles */
 ADC_HandleTypeDef hadc1;
 TIM_HandleTypeDef htim2;
 DMA_HandleTypeDef hdma_adc1;
 
-/* FFT 參數 */
-#define NPT 1024
+/* ADC 掃描的通道數 (1 ~ ADC_SCAN_MAX_CH，接腳見 s_adc_channel[])：每個通道有自己的 FFT 管線、平均與頻譜佇列，
+ * fft_chart 上每通道一條曲線。DMA 緩衝與 DSP 暫存區的總量不變，由各通道平分 (每通道點數上限為 NPT_MAX)；
+ * 峰值標記、固定頻率追蹤與 PEAK / TONE 封包只處理通道 0。採樣率與耗時如何隨通道數變化見 adc_scan.h */
+#ifndef ADC_SCAN_CHANNELS
+#define ADC_SCAN_CHANNELS 1
+#endif
+
+#if ADC_SCAN_CHANNELS < 1 || ADC_SCAN_CHANNELS > ADC_SCAN_MAX_CH || ADC_SCAN_CHANNELS > UI_SPEC_CHANNELS_MAX
+#error "ADC_SCAN_CHANNELS out of range"
+#endif
+
+/* FFT 參數：點數可在執行期間切換 (FFT_PROC_NPT_MIN ~ NPT_MAX，KEY0 加倍 / KEY1 減半)，
+ * 窗函數以 KEY2 輪流切換 (見 fft_proc.h 的 fft_window_t)，
+ * 所有緩衝都以 NPT_BUF 配置一次，切換時只改用量，見 fft_set_npt() */
+#define NPT_DEFAULT 1024
+#define NPT_BUF     FFT_PROC_NPT_MAX                                // 所有通道合計的緩衝點數
+#define NPT_MAX     ADC_SCAN_NPT_MAX(NPT_BUF, ADC_SCAN_CHANNELS)    // 每通道的點數上限
+
+#define FRAME_LEN(npt)  ((npt) * ADC_SCAN_CHANNELS)     // 一幀的原始點數 (所有通道)
+
+#define FFT_WINDOW_DEFAULT  FFT_WIN_HANN
+#define FFT_INTERP_DEFAULT  FFT_INTERP_JACOBSEN     // 峰值頻率的次頻點內插 (見 fft_interp_t)
+
+static volatile uint16_t s_npt = NPT_DEFAULT;   // 目前的 FFT 點數 (只在 ADC DMA 停止時改寫)
+
+/* 1: 以合成訊號取代 ADC 資料 (ADC/DMA 照常運作，只用來提供時序)，見 adc_synth.h */
+#ifndef ADC_SOURCE_SYNTH
+#define ADC_SOURCE_SYNTH 0
+#endif
+
+/* 1: g_fft_low ~ g_fft_high 的頻譜改由 zoom FFT 計算 (複數降頻 + FIR 抽取 + ZOOM_FFT_NPT 點複數 FFT，見 zoom_fft.h)，
+ * 預設 ZOOM_FFT_NPT = 1024 時預設範圍的解析度為 1024 點 RFFT 的 4 倍，但每幀耗時也較高 (以耗時換解析度，
+ * 不是省時的選項)。平均、峰值、標記與 PEAK 封包都改用 zoom 頻譜
+ * (bin_start / bin_end 為 zoom 頻譜的索引)；窗函數固定為 Hann，KEY2 只影響 RFFT 與固定頻率追蹤 */
+#ifndef FFT_ZOOM_ENABLE
+#define FFT_ZOOM_ENABLE 0
+#endif
+
+#if FFT_ZOOM_ENABLE && ADC_SCAN_CHANNELS > 1
+#error "FFT_ZOOM_ENABLE supports a single ADC channel only"
+#endif
+
+/* 頻譜幅度的正規化點數 (幅度 = A x 點數 / 2，轉 dBV 用) */
+#if FFT_ZOOM_ENABLE
+#define FFT_MAG_NPT ZOOM_FFT_NPT
+#else
+#define FFT_MAG_NPT s_dsp.fft[0].npt
+#endif
+
+/* ADC DMA 乒乓緩衝：前半 / 後半各為一整幀 (每半 FRAME_LEN(s_npt) 點，多通道時依掃描順序交錯)。
+ * DMA 寫後半時前半保持穩定 (反之亦然)，處理端直接讀取完成的那一半，不需要再複製 */
+__ALIGNED(4) uint16_t ADValue[2 * NPT_BUF];    // ADC DMA 原始數據 (adc_pair.h 一次讀兩點，需 4-byte 對齊)
+
+/* DSP 暫存區只有 CPU 存取 => 整塊放在 CCM (讓出一般 SRAM；速度差異未量測，見 mem_map.h)，以 NPT_BUF 配置；
+ * 通道 ch 的 in / out / win 為各自從 ch * NPT_MAX 起的 NPT_MAX 點。
+ * 以 FFT_PROC_USE_Q15=1 編譯時三個緩衝改放 q15 資料，大小不變 (見 fft_proc.h) */
+typedef struct
+{
+    float      in[NPT_BUF];     // FFT 輸入緩衝
+    float      out[NPT_BUF];    // FFT 輸出緩衝
+    float      win[NPT_BUF];    // 窗函數係數 (已含 ADC 換算與振幅修正，切換點數/窗函數時重新產生)
+    float      avg[NPT_BUF / 2 + ADC_SCAN_CHANNELS];    // 頻譜平均累加器 (每通道 NPT_MAX/2 + 1 點)
+    fft_proc_t fft[ADC_SCAN_CHANNELS];  // 每通道一條頻譜處理管線 (含各點數預先規劃的 RFFT 實例)
+} dsp_arena_t;
+
+static dsp_arena_t s_dsp CCM_RAM_AT(0);
+
+/* 編譯期檢查 CCM 放得下 (約 56KB) */
+typedef char dsp_arena_fits_ccm[(sizeof(dsp_arena_t) <= CCM_RAM_SIZE) ? 1 : -1];
+
+#if FFT_ZOOM_ENABLE
+static zoom_fft_t s_zoom;   // ZOOM_FFT_NPT = 1024 時約 33KB，放在一般 SRAM (CCM 已由 s_dsp 用掉大半)
+static uint32_t s_zoom_seq; // 最後推入 s_zoom 的幀序號 (只在 PendSV 中讀寫)
+#endif
+
+/* 頻譜平均 (WK_UP 輪流切換模式，所有通道相同)，見 spec_avg.h */
+static spec_avg_t s_avg[ADC_SCAN_CHANNELS];
+
+/* 多峰值檢測參數 (顯示在 fft_chart 上的標記)，見 peak_detect.h */
+static peak_detect_cfg_t s_peak_cfg;
+
+#if SPEC_FRAME_MAX_PEAKS < PEAK_DETECT_MAX
+#error "SPEC_FRAME_MAX_PEAKS must hold PEAK_DETECT_MAX peaks"
+#endif
+
+/* 固定頻率追蹤 (Goertzel)：每幀在 RFFT 改寫 in[] 之前計算，結果以 TONE 封包送出，見 tone_bank.h。
+ * 輸入是浮點管線的 in[]，q15 管線 (FFT_PROC_USE_Q15=1) 不追蹤 */
+static const float s_tone_freq[] = { 440.0f, 600.0f };     // Hz，最多 TONE_BANK_MAX 個
+static tone_bank_t s_tones;
+
+#if TONE_BANK_MAX > TELEM_TONE_MAX
+#error "TELEM_TONE_MAX must hold TONE_BANK_MAX tones"
+#endif
+
+#if ADC_SOURCE_SYNTH
+static adc_synth_t s_synth;
+#endif
 
-uint16_t ADValue[NPT];       // ADC DMA 原始數據
-uint16_t copyADValue[NPT];   // 複製給 Wave/FFT
-float fft_inputbuf[NPT];     // FFT 輸入緩衝
-float fft_outputbuf[NPT];    // FFT 輸出緩衝
-arm_rfft_fast_instance_f32 rfft_instance;  // RFFT 實例
+/* 各階段耗時見 profiler.h (PROF_ZONE_xxx)；修改 mem_map.h 的 DSP_SCRATCH_IN_CCM
+ * 即可比較 DSP 暫存區放在 CCM 與一般 SRAM 時 fft_total 的週期數 (尚未在板上量測，見 mem_map.h) */
+#define PROF_REPORT_MS  2000    // 經遙測送出 profiler 統計的間隔
 
 static float Samples;  // ADC 採樣率
 
@@ -36,72 +141,79 @@ static float Samples;  // ADC 採樣率
 static float g_fft_low  = 250.0f;
 static float g_fft_high = 650.0f;
 
-/* 由 FFT_Calc() 決定的 binStart..binEnd，update_fft_chart() 會用到 */
-static int s_binStart = 0;
-static int s_binEnd   = 0;
-
-/* FFT 計算結果 */
-volatile float fft_max_val  = 0.0f;
-volatile float fft_max_freq = 0.0f;
-volatile uint8_t fft_ready  = 0;  // FFT 計算完成旗標
-
-/* --- 與波形有關的全域變數 --- */
-/* 原本 wave_chart_low & wave_chart_high 由滑桿動態調整；現在改成程式自動偵測*/
-static int32_t wave_chart_low  = 600;
-static int32_t wave_chart_high = 1800;
-
-/* Wave Chart 點數、FFT Chart 點數 (由底部滑塊控制) */
-static uint16_t wave_points = 250;
-static uint16_t fft_points = 206;
-
-/* LVGL 物件 */
-static lv_style_t style_large_text;
-static lv_obj_t * wave_chart = NULL;
-static lv_obj_t * fft_chart  = NULL;
-static lv_obj_t * freq_label = NULL;
-static lv_obj_t * scale_container = NULL;
-static lv_obj_t * scale = NULL;
-
-static lv_obj_t * left_scale_container = NULL;
-static lv_obj_t * left_scale = NULL;
-static lv_obj_t * right_scale_container = NULL;
-static lv_obj_t * right_scale = NULL;
-
-static uint8_t  display_mode = 2; /* 0=只顯FFT,1=只顯Wave,2=Both */
-
-/* Radio (FFT/Wave/Both) */
-static lv_style_t style_radio;
-static lv_style_t style_radio_chk;
-static lv_style_t style_cb_text;
-static lv_style_t style_cb_enlarge; /* 用來放大 CheckBox 可點擊區域 */
-static lv_style_t style_slider_pad;
-static lv_style_t style_knob_small;
-static uint32_t active_index = 2;
+/* FFT 計算結果：PendSV 中的 FFT_Calc() 寫入，LVGL timer 的 update_lvgl_charts() 讀出。
+ * 每幀自帶 binStart..binEnd、峰值與序號，兩端不再共用任何會被半途改寫的全域變數；
+ * 每個通道一個佇列 (UI 各自只取最新一幀，通道之間不會互相擠掉) */
+static frame_queue_t s_spec_queue[ADC_SCAN_CHANNELS];
+
+/* --- FFT 延後處理 (PendSV) ---
+ * DMA 半傳輸/全傳輸中斷只把「完成的那一半」的指標交給 PendSV，FFT 在最低優先權的
+ * PendSV 中執行，不再阻塞 SysTick / 觸控 / UART。
+ * 某一半在下一次 DMA 回呼之前都不會被改寫，因此 PendSV 必須在一幀時間內讀完輸入：
+ * 1024 點 2kHz 時每幀 512ms，10 倍 (20kHz) 時每幀 51.2ms，最短 (64 點 20kHz) 為 3.2ms，FFT_Calc 只需數 ms
+ * (多通道時乘上通道數)。
+ * 若 PendSV 被延遲太久，輸入讀完後序號已變 => 該幀視為撕裂並丟棄。
+ * 佇列本身見 fft_job.h (不依賴 HAL，主機端以 Tools/job_bench.c 驗證 2kHz / 20kHz 不掉幀)；
+ * 已處理 / 丟棄的幀數為 s_jobs.posted / fft_job_dropped(&s_jobs) */
+static fft_job_queue_t s_jobs;
+
+/* 原始幀歷史：外部 SRAM 中的環形緩衝 (位址見 mem_map.h)，PendSV 每接受一幀就複製一份。
+ * 之後的轉換與 Wave Chart 都讀這份複本，不再直接讀 DMA 仍在使用的 ADValue。
+ * 每槽固定 NPT_BUF 點，只用前 FRAME_LEN(s_npt) 點；複製時已解交錯，通道 ch 在 ch * s_npt 起。
+ * 切換點數時歷史清空 */
+#define CAPTURE_HIST_FRAMES (EXT_SRAM_CAPTURE_SIZE / (NPT_BUF * sizeof(uint16_t)))
+
+static uint16_t (* const s_capture_hist)[NPT_BUF] = (uint16_t (*)[NPT_BUF])EXT_SRAM_CAPTURE_ADDR;
+static volatile uint32_t s_capture_count = 0;   // 已寫入歷史的幀數 (只由 PendSV 遞增)
+
+/* 最近一次完成 FFT 的原始波形 (給 Wave Chart 使用，多通道時為通道 0) */
+static const uint16_t * volatile s_wave_view = ADValue;
+
+/* 取得 age 幀之前的原始幀 (0 = 最新)；超出歷史範圍回傳 NULL */
+static inline const uint16_t *capture_history_frame(uint32_t age)
+{
+    uint32_t count = s_capture_count;
+
+    if (age >= count || age >= CAPTURE_HIST_FRAMES)
+    {
+        return NULL;
+    }
+
+    return s_capture_hist[(count - 1 - age) % CAPTURE_HIST_FRAMES];
+}
+
 
 static void MX_GPIO_Init(void);
 static void MX_DMA_Init(void);
 static void MX_ADC1_Init(void);
 static void MX_TIM2_Init(void);
 
-static void CopyDataToWaveBuff(void);
-static void FFT_Calc(float samp);
-
-void lv_mainstart_init(void);
+static void fft_post_frame(const uint16_t *src);
+static void FFT_Calc(uint8_t ch, float samp, uint32_t seq);
+static uint8_t fft_set_npt(uint16_t npt);
+static uint8_t fft_set_window(fft_window_t window);
+static void fft_set_avg(spec_avg_mode_t mode);
+static void fft_send_tones(uint32_t seq);
+#if FFT_ZOOM_ENABLE
+static void fft_zoom_push(const uint16_t *frame, uint32_t seq);
+static void fft_zoom_restart(void);
+#endif
+static const uint16_t *wave_frame(uint16_t *len);
+
+/* 介面的資料來源 (見 lv_mainstart.h)；瀑布圖緩衝在外部 SRAM，lv_mainstart_init() 在 sram_init() 之後才呼叫 */
+static const ui_source_t s_ui_source =
+{
+    s_spec_queue,
+    wave_frame,
+    (uint8_t *)EXT_SRAM_WATERFALL_IDX_ADDR,
+    (uint16_t *)EXT_SRAM_WATERFALL_RGB_ADDR,
+    ADC_SCAN_CHANNELS,
+};
 
-static void init_scale_container(void);
-static void remake_scale(int start, int end);
-static void remake_right_scale(int start, int end);
-static void create_left_scale(void);
-static void create_right_scale(void);
-static void radio_event_handler(lv_event_t * e);
-static void slider_event_cb(lv_event_t * e);
-/* ======= 已移除 wave_offset_slider_event_cb ======= */
+#if EXT_SRAM_WATERFALL_COLS != WATERFALL_COLS || EXT_SRAM_WATERFALL_ROWS != WATERFALL_ROWS
+#error "mem_map.h waterfall region does not match waterfall.h"
+#endif
 
-static void fft_chart_draw_event_cb(lv_event_t * e);
-static void radiobutton_create(lv_obj_t * parent, const char * txt);
-static void create_mode_selector(void);
-static void update_lvgl_charts(lv_timer_t * t);
-static void update_fft_chart(void);
 
 /* ----------- 程式進入點 ----------- */
 int main(void)
@@ -110,6 +222,7 @@ int main(void)
     sys_stm32_clock_init(336, 8, 2, 7);
     delay_init(168);
     usart_init(115200);
+    telemetry_init();
     led_init();
     key_init();
     sram_init();
@@ -122,587 +235,454 @@ int main(void)
     MX_ADC1_Init();
     MX_TIM2_Init();
 
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        fft_proc_t *fp = &s_dsp.fft[ch];
+
+        fft_proc_init(fp, NPT_MAX, s_dsp.in + ch * NPT_MAX, s_dsp.out + ch * NPT_MAX,
+                      s_dsp.win + ch * NPT_MAX);    // 預先規劃所有點數
+        fft_proc_set_npt(fp, s_npt);
+        fft_proc_set_window(fp, FFT_WINDOW_DEFAULT);
+        fp->interp = FFT_INTERP_DEFAULT;
+        spec_avg_init(&s_avg[ch], s_dsp.avg + ch * (NPT_MAX / 2 + 1), NPT_MAX / 2 + 1);
+        frame_queue_init(&s_spec_queue[ch]);
+    }
+    peak_detect_default(&s_peak_cfg);
+    fft_job_init(&s_jobs);
+    tone_bank_init(&s_tones, Samples, s_npt);
+    for (uint8_t i = 0; i < sizeof(s_tone_freq) / sizeof(s_tone_freq[0]); i++)
+    {
+        tone_bank_add(&s_tones, s_tone_freq[i]);
+    }
+#if FFT_ZOOM_ENABLE
+    zoom_fft_set_band(&s_zoom, Samples, g_fft_low, g_fft_high);
+#endif
+
+#if ADC_SOURCE_SYNTH
+    /* 兩個落在預設搜尋範圍 (250~650Hz) 內的正弦波 + 少量雜訊 */
+    adc_synth_init(&s_synth, Samples);
+    adc_synth_add_tone(&s_synth, 440.0f, 0.8f);
+    adc_synth_add_tone(&s_synth, 600.0f, 0.3f);
+    adc_synth_set_noise(&s_synth, 0.01f, 1);
+#endif
+
+    /* 開啟 DWT 週期計數器 (各階段耗時統計) */
+    prof_init();
+
+    /* PendSV 設為最低優先權 => FFT 可被其他所有中斷搶佔 */
+    HAL_NVIC_SetPriority(PendSV_IRQn, 15, 0);
+
     HAL_TIM_Base_Start(&htim2);
-    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, NPT);
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, 2 * FRAME_LEN(s_npt));
 
-    arm_rfft_fast_init_f32(&rfft_instance, NPT);
+    lv_mainstart_init(&s_ui_source);
 
-    lv_mainstart_init();
+    uint32_t prof_last = HAL_GetTick();
 
     while (1)
     {
+        PROF_BEGIN(PROF_ZONE_LV_HANDLER);
         lv_task_handler();
+        PROF_END(PROF_ZONE_LV_HANDLER);
         delay_ms(5);
-    }
-}
 
-/* ---------------------------------------
-   LVGL 初始化，建立各式介面元件
-   --------------------------------------- */
-void lv_mainstart_init(void)
-{
-    lv_init();
-    lv_port_disp_init();
-    lv_port_indev_init();
-    
-    /* 建立左邊/右邊的刻度容器 (垂直) */
-    create_left_scale();
-    create_right_scale();
-
-    /*=== 建立 wave_chart (線圖) ===*/
-    wave_chart = lv_chart_create(lv_scr_act());
-    lv_chart_set_type(wave_chart, LV_CHART_TYPE_LINE);
-    lv_chart_set_update_mode(wave_chart, LV_CHART_UPDATE_MODE_SHIFT);
-    lv_obj_set_style_size(wave_chart, 0, 0, LV_PART_INDICATOR);
-    lv_obj_set_style_pad_all(wave_chart, 0, LV_PART_MAIN);
-    
-    /* 背景、邊框透明 => 以便覆蓋在 FFT 上面但不遮擋 */
-    lv_obj_set_style_bg_opa(wave_chart, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(wave_chart, LV_OPA_TRANSP, LV_PART_MAIN);
-
-    lv_chart_set_point_count(wave_chart, wave_points);
-    lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_X, 0, wave_points - 1);
-    /* 先給一個初始範圍; 之後會自動更新 */
-    lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_Y, wave_chart_low, wave_chart_high);
-
-    lv_chart_series_t * wave_ser = lv_chart_add_series(wave_chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
-    int32_t * wave_arr = lv_chart_get_y_array(wave_chart, wave_ser);
-    for (uint16_t i = 0; i < wave_points; i++)
-    {
-        wave_arr[i] = 0;
-    }
-    lv_chart_refresh(wave_chart);
-
-    /*=== 建立 fft_chart (柱狀圖/線圖) ===*/
-    fft_chart = lv_chart_create(lv_scr_act());
-    lv_chart_set_type(fft_chart, LV_CHART_TYPE_LINE);
-    lv_chart_set_update_mode(fft_chart, LV_CHART_UPDATE_MODE_SHIFT);
-    lv_obj_set_style_size(fft_chart, 0, 0, LV_PART_INDICATOR);
-    lv_obj_set_style_pad_all(fft_chart, 0, LV_PART_MAIN);
-    
-    lv_obj_set_style_bg_opa(fft_chart, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(fft_chart, LV_OPA_TRANSP, LV_PART_MAIN);
-
-    lv_chart_set_point_count(fft_chart, fft_points);
-    lv_chart_set_range(fft_chart, LV_CHART_AXIS_PRIMARY_Y, 0, 255);
-
-    lv_chart_series_t * fft_ser = lv_chart_add_series(fft_chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
-    int32_t * fft_arr = lv_chart_get_y_array(fft_chart, fft_ser);
-    for (uint16_t i = 0; i < fft_points; i++)
-    {
-        fft_arr[i] = 0;
-    }
-    lv_chart_refresh(fft_chart);
+        /* KEY0 / KEY1 切換 FFT 點數 (解析度 <=> 每幀延遲) */
+        switch (key_scan(0))
+        {
+            case KEY0_PRES:
+                fft_set_npt(s_npt < NPT_MAX ? s_npt * 2 : FFT_PROC_NPT_MIN);
+                break;
 
-    /*=== 根據 display_mode=0/1/2 分配大小位置 ===*/
-    if (display_mode == 0)
-    {
-        lv_obj_add_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_set_pos(fft_chart, 0, 0);
-        lv_obj_set_size(fft_chart, 800, 400);
-    }
-    else if (display_mode == 1)
-    {
-        lv_obj_add_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_set_pos(wave_chart, 0, 0);
-        lv_obj_set_size(wave_chart, 800, 400);
-    }
-    else
-    {
-        lv_obj_clear_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
+            case KEY1_PRES:
+                fft_set_npt(s_npt > FFT_PROC_NPT_MIN ? s_npt / 2 : NPT_MAX);
+                break;
 
-        lv_obj_set_pos(fft_chart, 0, 0);
-        lv_obj_set_size(fft_chart, 800, 400);
+            case KEY2_PRES:
+                fft_set_window((fft_window_t)((s_dsp.fft[0].window + 1) % FFT_WIN_COUNT));
+                break;
 
-        lv_obj_set_pos(wave_chart, 0, 0);
-        lv_obj_set_size(wave_chart, 800, 400);
-    }
+            case WKUP_PRES:
+                fft_set_avg((spec_avg_mode_t)((s_avg[0].mode + 1) % SPEC_AVG_COUNT));
+                break;
 
-    /*=== 大字體標籤 (顯示 FFT 頻率) ===*/
-    lv_style_init(&style_large_text);
-    lv_style_set_text_font(&style_large_text, &lv_font_montserrat_26);
-    freq_label = lv_label_create(lv_scr_act());
-    lv_obj_set_pos(freq_label, 550, 10);
-    lv_label_set_text(freq_label, "Freq: 0.00Hz");
-    lv_obj_add_style(freq_label, &style_large_text, 0);
-
-    /*=== 建立一個定時器 => 每 300ms 更新 Wave/FFT ===*/
-    lv_timer_create(update_lvgl_charts, 300, NULL);
-
-    /*=== 建立模式選擇 (CheckBox Radio) ===*/
-    create_mode_selector();
-
-    /*=== 建立底部 slider => 控制 Wave/FFT 點數 (0~100) ===*/
-    lv_obj_t * slider = lv_slider_create(lv_scr_act());
-    lv_slider_set_range(slider, 0, 100);
-    lv_slider_set_value(slider, 100, LV_ANIM_OFF);
-    lv_obj_set_width(slider, 700);
-    lv_obj_align(slider, LV_ALIGN_BOTTOM_MID, 0, -23);
-    lv_obj_move_foreground(slider);
-    lv_obj_add_event_cb(slider, slider_event_cb, LV_EVENT_VALUE_CHANGED, NULL);
-
-    /*=== 美化一下 slider 外觀 ===*/
-    lv_style_init(&style_knob_small);
-    lv_style_set_bg_opa(&style_knob_small, LV_OPA_TRANSP);
-    lv_style_set_border_opa(&style_knob_small, LV_OPA_TRANSP);
-    lv_style_set_outline_opa(&style_knob_small, LV_OPA_TRANSP);
-    lv_obj_add_style(slider, &style_knob_small, LV_PART_KNOB);
-
-    lv_style_init(&style_slider_pad);
-    lv_style_set_pad_all(&style_slider_pad, 12);
-    lv_style_set_border_opa(&style_slider_pad, LV_OPA_TRANSP);
-    lv_style_set_outline_opa(&style_slider_pad, LV_OPA_TRANSP);
-    lv_obj_add_style(slider, &style_slider_pad, LV_PART_MAIN);
-
-    /*=== 底部的頻率刻度 (水平) ===*/
-    init_scale_container();
-    remake_scale(250, 650);  // 預設顯示 250..650Hz
-
-    /*
-     * ==【注意】==
-     * 右邊調整波形高低的 slider 已被移除，
-     * 不再需要手動改 wave_chart_low / wave_chart_high。
-     * 下面這段原本用來建立 wave_offset_slider 的程式已刪除。
-     */
-}
+            default:
+                break;
+        }
 
-/* ---------------------------------------
-   底部容器/刻度
-   --------------------------------------- */
-static void init_scale_container()
-{
-    scale_container = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(scale_container, 800, 80);
-    lv_obj_set_pos(scale_container, 0, 395);
-    lv_obj_set_style_bg_opa(scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_move_background(scale_container);
-    lv_obj_clear_flag(scale_container, LV_OBJ_FLAG_SCROLLABLE);
+        if (HAL_GetTick() - prof_last >= PROF_REPORT_MS)
+        {
+            prof_last = HAL_GetTick();
+            telemetry_send_profile();
+        }
+    }
 }
 
-/* 底部頻率刻度 */
-static void remake_scale(int start, int end)
+/* --------------------------------------------------
+   ADC DMA 半傳輸/全傳輸完成時，只把完成的那一半交給 PendSV
+   -------------------------------------------------- */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
 {
-    if(scale)
+    if(hadc->Instance == ADC1)
     {
-        lv_obj_del(scale);
-        scale = NULL;
+        fft_post_frame(ADValue);
     }
-
-    scale = lv_scale_create(scale_container);
-    lv_obj_set_size(scale, lv_pct(110), 70);
-    lv_obj_center(scale);
-    lv_scale_set_label_show(scale, true);
-    lv_scale_set_mode(scale, LV_SCALE_MODE_HORIZONTAL_BOTTOM);
-    lv_scale_set_range(scale, start, end);
-    lv_scale_set_total_tick_count(scale, 9);
-    lv_scale_set_major_tick_every(scale, 1);
-    lv_obj_set_style_length(scale, 0, LV_PART_ITEMS);
-    lv_obj_set_style_length(scale, 8, LV_PART_INDICATOR);
 }
 
-/* ---------------------------------------
-   左側/右側的刻度容器 (顯示波形或其他量測值)
-   --------------------------------------- */
-static void remake_right_scale(int start, int end)
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
-    if(left_scale)
+    if(hadc->Instance == ADC1)
     {
-        lv_obj_del(left_scale);
-        left_scale = NULL;
+        fft_post_frame(ADValue + FRAME_LEN(s_npt));
     }
-
-    left_scale = lv_scale_create(left_scale_container);
-
-    lv_obj_set_size(left_scale, 40, 400);
-    lv_obj_align(left_scale, LV_ALIGN_TOP_LEFT, 0, 0);
-
-    lv_scale_set_mode(left_scale, LV_SCALE_MODE_VERTICAL_LEFT);
-    lv_scale_set_range(left_scale, start, end);
-    lv_scale_set_total_tick_count(left_scale, 5);
-    lv_scale_set_major_tick_every(left_scale, 1);
-    lv_scale_set_label_show(left_scale, true);
-
-    lv_obj_set_style_length(left_scale, 0, LV_PART_ITEMS);
-    lv_obj_set_style_length(left_scale, 8, LV_PART_INDICATOR);
-
-    lv_obj_set_style_line_color(left_scale, lv_color_black(), LV_PART_INDICATOR);
-    lv_obj_set_style_line_width(left_scale, 2, LV_PART_INDICATOR);
-    lv_obj_set_style_text_color(left_scale, lv_color_black(), LV_PART_MAIN);
 }
 
-static void create_left_scale(void)
+/* 於中斷中呼叫：發佈一幀的指標並觸發 PendSV；佇列滿時丟棄並計數 */
+static void fft_post_frame(const uint16_t *src)
 {
-    left_scale_container = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(left_scale_container, 70, 400);
-    lv_obj_set_pos(left_scale_container, 730, 0);
-
-    lv_obj_set_style_bg_opa(left_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(left_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_width(left_scale_container, 2, 0);
-    lv_obj_set_style_border_color(left_scale_container, lv_palette_main(LV_PALETTE_RED), 0);
-    lv_obj_clear_flag(left_scale_container, LV_OBJ_FLAG_SCROLLABLE);
-
-    /* 一開始先用預設 600..1800，稍後會自動調整 */
-    remake_right_scale(wave_chart_low, wave_chart_high);
+    fft_job_post(&s_jobs, src);
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
 }
 
-static void create_right_scale(void)
+/* --------------------------------------------------
+   PendSV (最低優先權) => 依序處理佇列中的每一幀
+   -------------------------------------------------- */
+void PendSV_Handler(void)
 {
-    right_scale_container = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(right_scale_container, 70, 400);
-    lv_obj_set_pos(right_scale_container, 0, 0);
-
-    lv_obj_set_style_bg_opa(right_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_opa(right_scale_container, LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_set_style_border_width(right_scale_container, 2, 0);
-    lv_obj_set_style_border_color(right_scale_container, lv_palette_main(LV_PALETTE_RED), 0);
-    lv_obj_clear_flag(right_scale_container, LV_OBJ_FLAG_SCROLLABLE);
-
-    right_scale = lv_scale_create(right_scale_container);
-    lv_obj_set_size(right_scale, 40, 400);
-    lv_obj_align(right_scale, LV_ALIGN_TOP_RIGHT, 0, 0);
-
-    lv_scale_set_mode(right_scale, LV_SCALE_MODE_VERTICAL_RIGHT);
-    lv_scale_set_range(right_scale, 0, 80);
-    lv_scale_set_total_tick_count(right_scale, 5);
-    lv_scale_set_major_tick_every(right_scale, 1);
-    lv_scale_set_label_show(right_scale, true);
-
-    lv_obj_set_style_length(right_scale, 0, LV_PART_ITEMS);
-    lv_obj_set_style_length(right_scale, 8, LV_PART_INDICATOR);
-
-    lv_obj_set_style_line_color(right_scale, lv_color_black(), LV_PART_INDICATOR);
-    lv_obj_set_style_line_width(right_scale, 2, LV_PART_INDICATOR);
-    lv_obj_set_style_text_color(right_scale, lv_color_black(), LV_PART_MAIN);
-}
+    fft_job_t job;
 
-/* ---------------------------------------
-   模式選擇 (FFT / Wave / Both)
-   --------------------------------------- */
-static void radio_event_handler(lv_event_t * e)
-{
-    uint32_t *active_id = (uint32_t *)lv_event_get_user_data(e);
-    lv_obj_t *cont = lv_event_get_current_target(e);
-    lv_obj_t *act_cb = lv_event_get_target_obj(e);
-    lv_obj_t *old_cb = lv_obj_get_child(cont, *active_id);
+    while (fft_job_take(&s_jobs, &job))
+    {
+        const uint16_t *src = job.data;
+        uint32_t seq = job.seq;
+        uint16_t *frame = s_capture_hist[s_capture_count % CAPTURE_HIST_FRAMES];
+
+        PROF_BEGIN(PROF_ZONE_FFT_TOTAL);
+        PROF_BEGIN(PROF_ZONE_ACQ_COPY);
+#if ADC_SOURCE_SYNTH
+        adc_synth_fill(&s_synth, frame, FRAME_LEN(s_npt));     // 多通道時每通道各取一段
+#else
+        adc_scan_deinterleave(src, s_npt, ADC_SCAN_CHANNELS, frame);   // 單通道時即 memcpy
+#endif
+        PROF_END(PROF_ZONE_ACQ_COPY);
+
+        /* 複製期間 DMA 已回到這一半 => 輸入可能撕裂，丟棄本幀 (歷史槽留給下一幀覆寫) */
+        if (fft_job_check(&s_jobs, &job) != 0)
+        {
+#if FFT_ZOOM_ENABLE
+            fft_zoom_restart();         // zoom 的輸入少了一整幀，不能接著上一幀繼續抽取
+#endif
+            continue;
+        }
 
-    if (act_cb == cont) {
-        return;
-    }
+        s_capture_count++;
 
-    lv_obj_remove_state(old_cb, LV_STATE_CHECKED);
-    lv_obj_add_state(act_cb, LV_STATE_CHECKED);
-    *active_id   = lv_obj_get_index(act_cb);
-    display_mode = (uint8_t)(*active_id);
+#if FFT_ZOOM_ENABLE
+        fft_zoom_push(frame, seq);
+#endif
+        for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+        {
+            fft_proc_load_u16(&s_dsp.fft[ch], frame + ch * s_npt);
+            FFT_Calc(ch, Samples, seq);
+        }
+        PROF_END(PROF_ZONE_FFT_TOTAL);
 
-    if (display_mode == 0)
-    {
-        lv_obj_add_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_set_pos(fft_chart, 0, 0);
-        lv_obj_set_size(fft_chart, 800, 400);
+        s_wave_view = frame;
     }
-    else if (display_mode == 1)
-    {
-        lv_obj_add_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_set_pos(wave_chart, 0, 0);
-        lv_obj_set_size(wave_chart, 800, 400);
-    }
-    else
-    {
-        lv_obj_clear_flag(wave_chart, LV_OBJ_FLAG_HIDDEN);
-        lv_obj_clear_flag(fft_chart, LV_OBJ_FLAG_HIDDEN);
-
-        lv_obj_set_pos(fft_chart, 0, 0);
-        lv_obj_set_size(fft_chart, 800, 400);
+}
 
-        lv_obj_set_pos(wave_chart, 0, 0);
-        lv_obj_set_size(wave_chart, 800, 400);
-    }
+/* 最近一次完成 FFT 的原始波形 (與 fft_set_npt() 同在主迴圈執行，點數不會在中途改變) */
+static const uint16_t *wave_frame(uint16_t *len)
+{
+    *len = s_npt;
+    return s_wave_view;
 }
 
-static void slider_event_cb(lv_event_t * e)
+/**
+ * @brief       切換 FFT 點數 (主迴圈呼叫)
+ * @note        先停止 ADC DMA；PendSV 的優先權高於主迴圈，HAL_ADC_Stop_DMA() 回傳時
+ *              已發佈的幀都處理完了，之後才改點數、清空工作佇列與歷史，再以新長度重新啟動 DMA。
+ *              RFFT 實例在 fft_proc_init() 時已全部規劃好，這裡不做任何配置
+ * @param       npt: 新點數 (FFT_PROC_NPT_MIN ~ NPT_MAX 的 2 的冪)
+ * @retval      0: 成功; 1: 點數不支援
+ */
+static uint8_t fft_set_npt(uint16_t npt)
 {
-    lv_obj_t * slider = lv_event_get_target(e);
-    int16_t val = lv_slider_get_value(slider);
-
-    /* 改變 Wave/FFT 的點數 (範圍: wave=50~250, fft=110~206) */
-    uint16_t newWavePoints = 50 + (200 * val) / 100;
-    if (newWavePoints < 50)  newWavePoints = 50;
-    if (newWavePoints > 250) newWavePoints = 250;
-    wave_points = newWavePoints;
-
-    uint16_t newFftPoints = 110 + (176 * val) / 100;
-    if (newFftPoints < 110) newFftPoints = 110;
-    if (newFftPoints > 206) newFftPoints = 206;
-    fft_points = newFftPoints;
-
-    uint16_t bin_start = 128;
-    uint16_t bin_end = bin_start + fft_points - 1;
-    if (bin_end > 333) {
-        bin_end = 333;
+    if (npt == s_npt)
+    {
+        return 0;
     }
 
-    float freq_per_bin = (650.0f - 250.0f) / (333 - 128);
-    float freq_s = 250.0f + (bin_start - 128) * freq_per_bin;
-    float freq_e = 250.0f + (bin_end - 128) * freq_per_bin;
-    remake_scale((int)freq_s, (int)freq_e);
+    HAL_ADC_Stop_DMA(&hadc1);
 
-    lv_chart_set_point_count(wave_chart, wave_points);
-    lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_X, 0, wave_points - 1);
-    lv_chart_refresh(wave_chart);
+    /* 各通道容量相同，通道 0 接受的點數其他通道也接受 */
+    if (fft_proc_set_npt(&s_dsp.fft[0], npt) != 0)
+    {
+        HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, 2 * FRAME_LEN(s_npt));
+        return 1;
+    }
 
-    lv_chart_set_point_count(fft_chart, fft_points);
-    lv_chart_set_range(fft_chart, LV_CHART_AXIS_PRIMARY_X, 0, fft_points - 1);
-    lv_chart_refresh(fft_chart);
+    s_npt = npt;
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        if (ch > 0)
+        {
+            fft_proc_set_npt(&s_dsp.fft[ch], npt);
+        }
+        spec_avg_reset(&s_avg[ch]);     // 頻點間距改變，舊的平均不再適用
+    }
+    tone_bank_set_rate(&s_tones, Samples, npt);
+#if FFT_ZOOM_ENABLE
+    zoom_fft_reset(&s_zoom);            // DMA 重新啟動 => 輸入在時間上不連續
+#endif
+    fft_job_reset(&s_jobs);
+    s_capture_count = 0;
+    s_wave_view = s_capture_hist[0];
+    memset(s_capture_hist[0], 0, NPT_BUF * sizeof(uint16_t));
+
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, 2 * FRAME_LEN(s_npt));
+    return 0;
 }
 
-static void radiobutton_create(lv_obj_t * parent, const char * txt)
+/**
+ * @brief       切換窗函數 (主迴圈呼叫)
+ * @note        與 fft_set_npt() 相同先停止 ADC DMA，避免 PendSV 讀到產生到一半的係數表
+ * @param       window: 窗函數
+ * @retval      0: 成功; 1: 不支援
+ */
+static uint8_t fft_set_window(fft_window_t window)
 {
-    lv_obj_t * obj = lv_checkbox_create(parent);
-    lv_checkbox_set_text(obj, txt);
-    lv_obj_add_style(obj, &style_cb_enlarge, LV_PART_MAIN);
+    uint8_t res = 0;
 
-    lv_obj_add_flag(obj, LV_OBJ_FLAG_EVENT_BUBBLE);
+    HAL_ADC_Stop_DMA(&hadc1);
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        res |= fft_proc_set_window(&s_dsp.fft[ch], window);
+        spec_avg_reset(&s_avg[ch]);
+    }
+#if FFT_ZOOM_ENABLE
+    zoom_fft_reset(&s_zoom);
+#endif
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, 2 * FRAME_LEN(s_npt));
 
-    lv_obj_add_style(obj, &style_cb_text,   LV_PART_MAIN);
-    lv_obj_add_style(obj, &style_radio,     LV_PART_INDICATOR);
-    lv_obj_add_style(obj, &style_radio_chk, LV_PART_INDICATOR | LV_STATE_CHECKED);
+    return res;
 }
 
-static void create_mode_selector(void)
+/**
+ * @brief       切換頻譜平均模式 (主迴圈呼叫)
+ * @note        與 fft_set_window() 相同先停止 ADC DMA，PendSV 不會在累加器重設到一半時使用它
+ * @param       mode: 平均模式
+ * @retval      無
+ */
+static void fft_set_avg(spec_avg_mode_t mode)
 {
-    lv_style_init(&style_radio);
-    lv_style_set_radius(&style_radio, LV_RADIUS_CIRCLE);
-    lv_style_set_border_width(&style_radio, 3);
-    lv_style_set_border_color(&style_radio, lv_color_black());
-    lv_style_set_width(&style_radio, 30);
-    lv_style_set_height(&style_radio, 30);
-
-    lv_style_init(&style_radio_chk);
-    lv_style_set_bg_color(&style_radio_chk, lv_palette_main(LV_PALETTE_BLUE));
-    lv_style_set_border_width(&style_radio_chk, 3);
-    lv_style_set_border_color(&style_radio_chk, lv_palette_darken(LV_PALETTE_BLUE, 3));
-
-    lv_style_init(&style_cb_text);
-    lv_style_set_text_font(&style_cb_text, &lv_font_montserrat_26);
-
-    lv_style_init(&style_cb_enlarge);
-    lv_style_set_pad_all(&style_cb_enlarge, 10);
-
-    lv_obj_t * cont = lv_obj_create(lv_scr_act());
-    lv_obj_set_size(cont, 300, 300);
-    lv_obj_set_pos(cont, 0, 0);
-
-    lv_obj_set_style_bg_opa(cont, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_border_opa(cont, LV_OPA_TRANSP, 0);
-
-    lv_obj_add_event_cb(cont, radio_event_handler, LV_EVENT_CLICKED, &active_index);
-
-    radiobutton_create(cont, "FFT");
-    lv_obj_set_pos(lv_obj_get_child(cont, 0), 10, 10);
-
-    radiobutton_create(cont, "WAVE");
-    lv_obj_set_pos(lv_obj_get_child(cont, 1), 10, 50);
-
-    radiobutton_create(cont, "BOTH");
-    lv_obj_set_pos(lv_obj_get_child(cont, 2), 10, 90);
-
-    lv_obj_add_state(lv_obj_get_child(cont, 2), LV_STATE_CHECKED);
-    lv_obj_move_foreground(cont);
+    HAL_ADC_Stop_DMA(&hadc1);
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        spec_avg_set_mode(&s_avg[ch], mode);
+    }
+#if FFT_ZOOM_ENABLE
+    zoom_fft_reset(&s_zoom);
+#endif
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)ADValue, 2 * FRAME_LEN(s_npt));
 }
 
-/* --------------------------------------------------
-   周期性 Timer 回呼 => 更新 Wave / FFT 顯示
-   -------------------------------------------------- */
-static void update_lvgl_charts(lv_timer_t * t)
+/**
+ * @brief       多峰值檢測 => 頻譜幀的峰值標記
+ * @note        標記的 dBV 取峰值頻點的幅度 (不含 scalloping 修正)，與 frame->db[] 的曲線對齊
+ * @param       frame   : 要寫入的頻譜幀
+ * @param       fp      : 本幀通道的管線 (RFFT 插值用)
+ * @param       samp    : 採樣率 (Hz)
+ * @param       mag     : 幅度 (RFFT 或 zoom 頻譜)
+ * @param       binStart: 第一個頻點
+ * @param       binEnd  : 最後一個頻點 (含)
+ * @retval      無
+ */
+static void fft_fill_peaks(spec_frame_t *frame, const fft_proc_t *fp, float samp, const float *mag,
+                           uint16_t binStart, uint16_t binEnd)
 {
-    LV_UNUSED(t);
-
-    /* --- (A) 更新波形顯示 --- */
-    if (!lv_obj_has_flag(wave_chart, LV_OBJ_FLAG_HIDDEN))
+    peak_detect_t found[PEAK_DETECT_MAX];
+    float db[PEAK_DETECT_MAX];
+    fft_peak_t pk;
+
+    PROF_BEGIN(PROF_ZONE_PEAKS);
+    uint8_t n = peak_detect_run(&s_peak_cfg, mag, binStart, binEnd, found);
+
+#if FFT_ZOOM_ENABLE
+    (void)fp;
+    (void)samp;
+#endif
+    for (uint8_t i = 0; i < n; i++)
     {
-        lv_chart_series_t * wave_ser = lv_chart_get_series_next(wave_chart, NULL);
-        int32_t * wave_arr = lv_chart_get_y_array(wave_chart, wave_ser);
-
-        /* 填入最新 ADC 資料 */
-        for (uint16_t i = 0; i < wave_points; i++)
-        {
-            if (i < 3 || i >= wave_points - 3)
-            {
-                wave_arr[i] = LV_CHART_POINT_NONE;
-            }
-            else
-            {
-                wave_arr[i] = (int32_t)copyADValue[i];
-            }
-        }
-
-        /* >>>>>> 自動校準 (Auto-Scaling) : 找出波形最小 / 最大值，動態調整 Y 軸範圍 <<<<<< */
-        int32_t wave_min_i32 = INT32_MAX;
-        int32_t wave_max_i32 = INT32_MIN;
-
-        for(uint16_t i = 3; i < wave_points - 3; i++)
-        {
-            if (wave_arr[i] != LV_CHART_POINT_NONE)
-            {
-                if (wave_arr[i] < wave_min_i32) wave_min_i32 = wave_arr[i];
-                if (wave_arr[i] > wave_max_i32) wave_max_i32 = wave_arr[i];
-            }
-        }
-
-        /* 避免全都是 NONE 或者怪異數值時失效 */
-        if (wave_min_i32 >= wave_max_i32)
-        {
-            wave_min_i32 = 0;
-            wave_max_i32 = 4095;  // 12-bit ADC 的最大值
-        }
-        else
-        {
-            /* 給一點餘裕，避免貼到邊緣 */
-            wave_min_i32 -= 150;
-            wave_max_i32 += 100;
-            if (wave_min_i32 < 0)      wave_min_i32 = 0;
-            if (wave_max_i32 > 4095)  wave_max_i32 = 4095;
-        }
-
-        wave_chart_low  = wave_min_i32;
-        wave_chart_high = wave_max_i32;
-
-        lv_chart_set_range(wave_chart, LV_CHART_AXIS_PRIMARY_Y, wave_chart_low, wave_chart_high);
-        remake_right_scale(wave_chart_low, wave_chart_high);  // 順便更新左邊刻度
-
-        lv_chart_refresh(wave_chart);
+#if FFT_ZOOM_ENABLE
+        zoom_fft_refine_peak(&s_zoom, binStart, binEnd, found[i].bin, &pk);
+#else
+        fft_proc_refine_peak(fp, samp, binStart, binEnd, found[i].bin, &pk);
+#endif
+        frame->peaks[i].pos  = (float)(pk.index - binStart) + pk.offset;
+        frame->peaks[i].freq = pk.freq;
+        db[i] = pk.value;
     }
 
-    /* --- (B) 更新 FFT 顯示 --- */
-    if (fft_ready && !lv_obj_has_flag(fft_chart, LV_OBJ_FLAG_HIDDEN))
+    fft_proc_mag_to_db(FFT_MAG_NPT, db, db, n);
+    for (uint8_t i = 0; i < n; i++)
     {
-        update_fft_chart();
-        fft_ready = 0;
+        frame->peaks[i].db = db[i];
     }
+    frame->peak_count = n;
+    PROF_END(PROF_ZONE_PEAKS);
 }
 
-static void update_fft_chart(void)
+/**
+ * @brief       固定頻率追蹤 => TONE 封包
+ * @note        讀通道 0 的 in[] (已加窗)，必須在 fft_proc_spectrum*() 之前呼叫
+ * @param       seq: 幀序號 (與同一幀的 PEAK 封包相同)
+ * @retval      無
+ */
+static void fft_send_tones(uint32_t seq)
 {
-    lv_chart_series_t * fft_ser = lv_chart_get_series_next(fft_chart, NULL);
-    uint16_t point_count = lv_chart_get_point_count(fft_chart);
+#if !FFT_PROC_USE_Q15
+    tone_result_t res[TONE_BANK_MAX];
+    telem_tone_t tn;
 
-    uint16_t real_bins = s_binEnd - s_binStart + 1;
-    if (real_bins < 1)
+    if (s_tones.count == 0)
     {
-        real_bins = 1;
+        return;
     }
 
-    uint16_t step = real_bins / point_count;
-    if (step < 1) step = 1;
-
-    float scale_factor = 255.0f / 50.0f;
-    int32_t * arr = lv_chart_get_y_array(fft_chart, fft_ser);
+    PROF_BEGIN(PROF_ZONE_TONES);
+    tone_bank_run(&s_tones, s_dsp.fft[0].in, res);
 
-    for (uint16_t i = 0; i < point_count; i++)
+    tn.seq          = seq;
+    tn.timestamp_ms = HAL_GetTick();
+    tn.count        = s_tones.count;
+    for (uint8_t i = 0; i < s_tones.count; i++)
     {
-        arr[i] = 0;
-        if (i < 3 || i >= point_count - 3)
-        {
-            arr[i] = LV_CHART_POINT_NONE;
-        }
-        else
-        {
-            uint16_t bin_index = s_binStart + i * step;
-            if (bin_index > s_binEnd)
-            {
-                bin_index = s_binEnd;
-            }
-
-            float val_f = fft_outputbuf[bin_index] * scale_factor;
-            if (val_f > 255.0f)
-            {
-                val_f = 255.0f;
-            }
-            arr[i] = (int32_t) val_f;
-        }
+        tn.freq[i]  = res[i].freq;
+        tn.amp[i]   = res[i].amp;
+        tn.phase[i] = res[i].phase;
     }
+    telemetry_send_tone(&tn);
+    PROF_END(PROF_ZONE_TONES);
+#else
+    (void)seq;
+#endif
+}
 
-    lv_chart_refresh(fft_chart);
-
-    static char freq_text[32];
-    snprintf(freq_text, sizeof(freq_text), "Freq: %.2fHz", fft_max_freq);
-    lv_label_set_text(freq_label, freq_text);
+#if FFT_ZOOM_ENABLE
+/**
+ * @brief       zoom FFT 的輸入不連續 (丟幀) => 清空 NCO / 濾波器 / 環形緩衝並重新開始平均 (PendSV 呼叫)
+ * @note        否則之後 ZOOM_FFT_NPT x 抽取倍數 點內的 zoom 頻譜都跨過缺口而被抹開
+ * @retval      無
+ */
+static void fft_zoom_restart(void)
+{
+    zoom_fft_reset(&s_zoom);
+    spec_avg_reset(&s_avg[0]);
 }
 
-/* --------------------------------------------------
-   ADC DMA 完成時，複製資料 + 做一次 FFT
-   -------------------------------------------------- */
-void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+/**
+ * @brief       一幀原始碼 => zoom FFT 的降頻與抽取 (PendSV 呼叫，每幀都要，時間上才連續)
+ * @note        頻帶跟著 g_fft_low / g_fft_high；改變時重新設計濾波器並重新開始平均。
+ *              序號不接續 (佇列滿而丟幀) 時先 fft_zoom_restart()
+ * @param       frame: 原始幀 (s_npt 點)
+ * @param       seq  : 該幀的 DMA 回呼序號
+ * @retval      無
+ */
+static void fft_zoom_push(const uint16_t *frame, uint32_t seq)
 {
-    if(hadc->Instance == ADC1)
+    if (s_zoom.f_low != g_fft_low || s_zoom.f_high != g_fft_high)
     {
-        CopyDataToWaveBuff();
-        FFT_Calc(Samples);
+        zoom_fft_set_band(&s_zoom, Samples, g_fft_low, g_fft_high);
+        spec_avg_reset(&s_avg[0]);
     }
-}
+    else if (seq != s_zoom_seq + 1)
+    {
+        fft_zoom_restart();
+    }
+    s_zoom_seq = seq;
 
-static void CopyDataToWaveBuff(void)
-{
-    memcpy(copyADValue, ADValue, NPT * sizeof(uint16_t));
+    zoom_fft_push_u16(&s_zoom, frame, s_npt);
 }
+#endif
 
-static void FFT_Calc(float samp)
+/* 一個通道的固定頻率 + 頻譜 + 峰值 => 遙測與該通道的頻譜佇列 (in[] 已由 fft_proc_load_u16() 填好) */
+static void FFT_Calc(uint8_t ch, float samp, uint32_t seq)
 {
-    for (int i = 0; i < NPT; i++)
-    {
-        float v = copyADValue[i] * 3.3f / 4095.0f;  // 12-bit ADC => 0~3.3V
-        fft_inputbuf[i] = v;
-    }
+    fft_proc_t *fp = &s_dsp.fft[ch];
+    spec_avg_t *avg = &s_avg[ch];
+    uint16_t binStart, binEnd;
+    fft_peak_t peak;
+    float *mag;
 
-    arm_rfft_fast_f32(&rfft_instance, fft_inputbuf, fft_outputbuf, 0);
-
-    fft_outputbuf[0] = fabsf(fft_outputbuf[0]);
-    if ((NPT & 1) == 0)
+    if (ch == 0)
     {
-        fft_outputbuf[NPT / 2] = fabsf(fft_outputbuf[1]);
+        fft_send_tones(seq);
     }
 
-    for (int i = 1; i < NPT / 2; i++)
+    /* 只有顯示 / 搜尋範圍內的頻點需要幅度 */
+#if FFT_ZOOM_ENABLE
+    zoom_fft_bin_range(&s_zoom, g_fft_low, g_fft_high, &binStart, &binEnd);
+    zoom_fft_spectrum(&s_zoom, binStart, binEnd);
+    mag = s_zoom.mag;
+#else
+    fft_proc_bin_range(fp, samp, g_fft_low, g_fft_high, &binStart, &binEnd);
+    fft_proc_spectrum_range(fp, binStart, binEnd);
+    mag = fp->mag;
+#endif
+
+    /* 平均後的幅度取代本幀 (峰值、標記與顯示都用平均後的曲線) */
+    PROF_BEGIN(PROF_ZONE_AVG);
+    spec_avg_apply(avg, mag, binStart, binEnd);
+    PROF_END(PROF_ZONE_AVG);
+
+    PROF_BEGIN(PROF_ZONE_PEAK);
+#if FFT_ZOOM_ENABLE
+    zoom_fft_find_peak(&s_zoom, binStart, binEnd, &peak);
+#else
+    fft_proc_find_peak(fp, samp, binStart, binEnd, &peak);
+#endif
+
+    /* 峰值以二進位封包經 UART DMA 送出 (取代 printf，不阻塞 PendSV)；封包沒有通道欄位，只送通道 0 */
+    if (ch == 0)
     {
-        float re = fft_outputbuf[2 * i];
-        float im = fft_outputbuf[2 * i + 1];
-        fft_outputbuf[i] = sqrtf(re * re + im * im);
+        telem_peak_t pk;
+        pk.seq          = seq;
+        pk.timestamp_ms = HAL_GetTick();
+        pk.peak_freq    = peak.freq;
+        pk.peak_amp     = peak.value;
+        pk.bin_start    = binStart;
+        pk.bin_end      = binEnd;
+        telemetry_send_peak(&pk);
     }
+    PROF_END(PROF_ZONE_PEAK);
 
-    int binStart = (int)(g_fft_low * NPT / samp + 0.5f);
-    int binEnd   = (int)(g_fft_high * NPT / samp + 0.5f);
-    if (binEnd > (NPT / 2)) binEnd = (NPT / 2);
-    if (binStart < 0)       binStart = 0;
-    if (binStart > binEnd)
+    /* 發佈到該通道的頻譜佇列；佇列滿時本幀只計入 dropped，不覆寫 UI 正在讀的資料 */
+    spec_frame_t *frame = frame_queue_begin_write(&s_spec_queue[ch]);
+    if (frame == NULL)
     {
-        binStart = 0;
-        binEnd   = (NPT / 2);
+        return;
     }
 
-    s_binStart = binStart;
-    s_binEnd   = binEnd;
-
-    int subLen = binEnd - binStart + 1;
-    if (subLen < 1) subLen = 1;
-
-    float maxVal = 0.0f;
-    uint32_t maxIndexLocal = 0;
-    arm_max_f32(&fft_outputbuf[binStart], subLen, &maxVal, &maxIndexLocal);
-    uint32_t maxIndex = binStart + maxIndexLocal;
-
-    fft_max_val = maxVal;
-    fft_max_freq = samp * (float)maxIndex / (float)NPT;
-    fft_ready = 1;
-
-    printf("%.1f..%.1fHz => bin[%d..%d], peak=%lu, freq=%.2fHz, amp=%.2f\r\n",
-           g_fft_low, g_fft_high, binStart, binEnd, maxIndex, fft_max_freq, fft_max_val);
+    /* 範圍超過 SPEC_FRAME_MAX_BINS => 每 step 個頻點取最大值，保留峰值；抽取後才轉 dB，最多 256 點 */
+    frame->count     = fft_proc_decimate_mag(mag, binStart, binEnd, frame->db,
+                                             SPEC_FRAME_MAX_BINS, &frame->bin_step);
+    fft_proc_mag_to_db(FFT_MAG_NPT, frame->db, frame->db, frame->count);
+    frame->channel   = ch;
+    frame->bin_start = binStart;
+    frame->bin_end   = binEnd;
+#if FFT_ZOOM_ENABLE
+    frame->freq_start = s_zoom.fc + ((int32_t)binStart - ZOOM_FFT_NPT / 2) * s_zoom.samp_d / ZOOM_FFT_NPT;
+    frame->freq_step  = s_zoom.samp_d / ZOOM_FFT_NPT * frame->bin_step;
+#else
+    frame->freq_start = binStart * samp / fp->npt;
+    frame->freq_step  = samp / fp->npt * frame->bin_step;
+#endif
+    frame->max_val   = peak.value;
+    frame->max_freq  = peak.freq;
+    fft_fill_peaks(frame, fp, samp, mag, binStart, binEnd);
+    frame->avg_mode  = (uint8_t)avg->mode;
+    frame->avg_count = avg->count;
+    frame_queue_commit(&s_spec_queue[ch]);
 }
 
 /* --------------------------------------------------
@@ -713,30 +693,39 @@ void DMA2_Stream0_IRQHandler(void)
     HAL_DMA_IRQHandler(&hdma_adc1);
 }
 
+/* 掃描順序 (rank 1 ~ ADC_SCAN_CHANNELS)：通道 0 沿用 PA7 => ADC_IN7，其餘依序為 PA6 / PA5 / PA4；
+ * 改接線時兩個表一起修改 */
+static const uint32_t s_adc_channel[ADC_SCAN_MAX_CH] = { ADC_CHANNEL_7, ADC_CHANNEL_6, ADC_CHANNEL_5, ADC_CHANNEL_4 };
+static const uint16_t s_adc_pin[ADC_SCAN_MAX_CH]     = { GPIO_PIN_7, GPIO_PIN_6, GPIO_PIN_5, GPIO_PIN_4 };
+
 /* --------------------------------------------------
    ADC 初始化 (F4 不需手動 Calibration)
+   多通道時為掃描模式：每次 TIM2 觸發依 rank 轉換全部通道，DMA 交錯寫入
    -------------------------------------------------- */
 static void MX_ADC1_Init(void)
 {
     __HAL_RCC_ADC1_CLK_ENABLE();
     hadc1.Instance = ADC1;
     hadc1.Init.Resolution            = ADC_RESOLUTION_12B;
-    hadc1.Init.ScanConvMode          = DISABLE;
+    hadc1.Init.ScanConvMode          = (ADC_SCAN_CHANNELS > 1) ? ENABLE : DISABLE;
     hadc1.Init.ContinuousConvMode    = DISABLE;
     hadc1.Init.DiscontinuousConvMode = DISABLE;
     hadc1.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
-    hadc1.Init.NbrOfConversion       = 1;
+    hadc1.Init.NbrOfConversion       = ADC_SCAN_CHANNELS;
     hadc1.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T2_TRGO;
     hadc1.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
     hadc1.Init.DMAContinuousRequests = ENABLE;
     HAL_ADC_Init(&hadc1);
 
     ADC_ChannelConfTypeDef sConfig = {0};
-    sConfig.Channel      = ADC_CHANNEL_7;
-    sConfig.Rank         = 1;
-    sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
-    sConfig.Offset       = 0;
-    HAL_ADC_ConfigChannel(&hadc1, &sConfig);
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        sConfig.Channel      = s_adc_channel[ch];
+        sConfig.Rank         = ch + 1;
+        sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
+        sConfig.Offset       = 0;
+        HAL_ADC_ConfigChannel(&hadc1, &sConfig);
+    }
 }
 
 /* --------------------------------------------------
@@ -792,13 +781,20 @@ static void MX_DMA_Init(void)
 }
 
 /* --------------------------------------------------
-   GPIO 初始化 (此範例用到 PA7 => ADC_IN7)
+   GPIO 初始化 (PA7 => ADC_IN7，多通道時再加上 s_adc_pin[] 的其他腳位)
    -------------------------------------------------- */
 static void MX_GPIO_Init(void)
 {
+    uint32_t pins = 0;
+
+    for (uint8_t ch = 0; ch < ADC_SCAN_CHANNELS; ch++)
+    {
+        pins |= s_adc_pin[ch];
+    }
+
     __HAL_RCC_GPIOA_CLK_ENABLE();
     GPIO_InitTypeDef GPIO_InitStruct;
-    GPIO_InitStruct.Pin  = GPIO_PIN_7;
+    GPIO_InitStruct.Pin  = pins;
     GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
@@ -0,0 +1,91 @@
+/**
+ ****************************************************************************************************
+ * @file        mem_map.h
+ * @brief       外部 SRAM (IS62WV51216, 1MB, FSMC_NE3) 與 CCM RAM (64KB) 的位址分配
+ ****************************************************************************************************
+ * @attention
+ *
+ * 外部 SRAM 在 main() 呼叫 sram_init() 之後才能存取, 而 __attribute__((at()))
+ * 或自訂 section 的 ZI 變數會在 __main 的 scatter loading 階段 (進 main 之前) 被清零,
+ * 此時 FSMC 尚未初始化. 因此這裡不使用連結器 section, 而是以固定位址劃分區塊,
+ * 使用者直接以指標存取, 內容在使用前需自行初始化.
+ *
+ *   EXT_SRAM_LV_MEM   LVGL 內建 allocator 的記憶體池 (lv_conf_cmsis.h: LV_MEM_ADR / LV_MEM_SIZE)
+ *   EXT_SRAM_DISP_BUF LVGL 兩個 partial draw buffer (lv_port_disp_template.c)
+ *   EXT_SRAM_CAPTURE  ADC 原始幀歷史 (main.c)
+ *   EXT_SRAM_WATERFALL 瀑布圖的索引歷史與 RGB565 畫面 (waterfall.h)
+ *   EXT_SRAM_FREE     尚未分配
+ *
+ * 修改各區大小只需改本檔的 _SIZE / _ROWS, 後面的位址自動順延;
+ * LVGL 記憶體池的位址與大小需同步修改 lv_conf_cmsis.h (lv_port_disp_template.c 會檢查).
+ *
+ * CCM RAM (0x10000000, 64KB) 只有 CPU (D-bus) 能存取, DMA 無法存取, 因此只放 CPU 專用的
+ * DSP 暫存區. CCM 上電即可用, 可直接用 __attribute__((at())) 放置 (scatter loading 會清零).
+ *
+ * DSP 暫存區放在 CCM 的速度效益尚未量測: CCM 不與 DMA2 (ADC/LCD/UART) 搶匯流排, 理論上
+ * LCD DMA 忙碌時 FFT 較穩定, 但一般 SRAM 在 168MHz 同樣零等待, 沒有匯流排競爭時兩者應相同.
+ * 目前確定的好處只有讓出約 56KB 一般 SRAM. 量測方法: DSP_SCRATCH_IN_CCM 分別設 0 / 1 編譯,
+ * 在相同畫面 (瀑布圖開啟, LCD DMA 持續刷新) 下擷取 UART1 遙測, 以 Tools/telem_decode
+ * 比較 fft_total 區段 (PROF zone) 的 min / mean / max 週期數; 有數據前不應視為最佳化.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __MEM_MAP_H
+#define __MEM_MAP_H
+
+#include "./BSP/SRAM/sram.h"
+
+
+#define EXT_SRAM_SIZE               (1024 * 1024)
+
+/* LVGL 記憶體池 */
+#define EXT_SRAM_LV_MEM_ADDR        (SRAM_BASE_ADDR)
+#define EXT_SRAM_LV_MEM_SIZE        (256 * 1024)
+
+/* LVGL draw buffer: 兩個 partial buffer, 每個 EXT_SRAM_DISP_BUF_ROWS 行 (RGB565) */
+#define EXT_SRAM_DISP_HOR_RES       800
+#define EXT_SRAM_DISP_BUF_ROWS      120
+#define EXT_SRAM_DISP_BUF_SIZE      (EXT_SRAM_DISP_HOR_RES * EXT_SRAM_DISP_BUF_ROWS * 2)
+#define EXT_SRAM_DISP_BUF1_ADDR     (EXT_SRAM_LV_MEM_ADDR + EXT_SRAM_LV_MEM_SIZE)
+#define EXT_SRAM_DISP_BUF2_ADDR     (EXT_SRAM_DISP_BUF1_ADDR + EXT_SRAM_DISP_BUF_SIZE)
+
+/* ADC 原始幀歷史 */
+#define EXT_SRAM_CAPTURE_ADDR       (EXT_SRAM_DISP_BUF2_ADDR + EXT_SRAM_DISP_BUF_SIZE)
+#define EXT_SRAM_CAPTURE_SIZE       (128 * 1024)    /* NPT_MAX = 4096 時 16 幀 */
+
+/* 瀑布圖: 每列 COLS 個 8-bit 索引 + 每列 COLS 個 RGB565, 各 ROWS 列 (與 waterfall.h 相同, main.c 會檢查) */
+#define EXT_SRAM_WATERFALL_COLS     800
+#define EXT_SRAM_WATERFALL_ROWS     100
+#define EXT_SRAM_WATERFALL_IDX_ADDR (EXT_SRAM_CAPTURE_ADDR + EXT_SRAM_CAPTURE_SIZE)
+#define EXT_SRAM_WATERFALL_IDX_SIZE (EXT_SRAM_WATERFALL_COLS * EXT_SRAM_WATERFALL_ROWS)
+#define EXT_SRAM_WATERFALL_RGB_ADDR (EXT_SRAM_WATERFALL_IDX_ADDR + EXT_SRAM_WATERFALL_IDX_SIZE)
+#define EXT_SRAM_WATERFALL_RGB_SIZE (EXT_SRAM_WATERFALL_COLS * EXT_SRAM_WATERFALL_ROWS * 2)
+
+/* 剩餘空間 */
+#define EXT_SRAM_FREE_ADDR          (EXT_SRAM_WATERFALL_RGB_ADDR + EXT_SRAM_WATERFALL_RGB_SIZE)
+#define EXT_SRAM_FREE_SIZE          (SRAM_BASE_ADDR + EXT_SRAM_SIZE - EXT_SRAM_FREE_ADDR)
+
+#if (EXT_SRAM_FREE_ADDR > SRAM_BASE_ADDR + EXT_SRAM_SIZE)
+#error "mem_map.h: external SRAM regions exceed 1MB"
+#endif
+
+
+/* CCM RAM */
+#define CCM_RAM_ADDR                0x10000000
+#define CCM_RAM_SIZE                (64 * 1024)
+
+#define DSP_SCRATCH_IN_CCM          1       /* 1: DSP 暫存區放在 CCM; 0: 放在一般 SRAM (用來比較 FFT 週期數, 見上方說明) */
+
+/* CCM_RAM_AT(offset): 把變數放在 CCM 的 offset 處, offset 由使用者自行排列不重疊.
+ * 只支援 ARMCC (Keil MDK) 的 at(); 本專案沒有 GNU linker script, 自訂 section 會成為孤立 section,
+ * 位置由 ld 決定且不會像 .bss 清零, 因此其他編譯器需把 DSP_SCRATCH_IN_CCM 設為 0 */
+#if DSP_SCRATCH_IN_CCM && defined(__CC_ARM)
+#define CCM_RAM_AT(offset)          __attribute__((at(CCM_RAM_ADDR + (offset))))
+#elif DSP_SCRATCH_IN_CCM
+#error "mem_map.h: CCM placement needs ARMCC __attribute__((at())); set DSP_SCRATCH_IN_CCM to 0 for other toolchains"
+#else
+#define CCM_RAM_AT(offset)
+#endif
+
+#endif
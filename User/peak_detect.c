@@ -0,0 +1,194 @@
+/**
+ ****************************************************************************************************
+ * @file        peak_detect.c
+ * @brief       多峰值檢測: CA-CFAR 門檻 + 最小間距 + 突出度
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include <math.h>
+#include "peak_detect.h"
+
+
+/**
+ * @brief       預設參數 (保護頻點涵蓋到 flattop 的主瓣, 各種窗函數都可以用; 最多 PEAK_DETECT_MAX 個)
+ * @param       cfg: 輸出
+ * @retval      無
+ */
+void peak_detect_default(peak_detect_cfg_t *cfg)
+{
+    cfg->guard         = 5;
+    cfg->train         = 16;
+    cfg->threshold_db  = 12.0f;
+    cfg->prominence_db = 6.0f;
+    cfg->min_sep       = 5;
+    cfg->max_peaks     = PEAK_DETECT_MAX;
+}
+
+/* 從 k 往 dir (+1 / -1) 走最多 span 點, 遇到比 mag[k] 高的頻點即停, 回傳途中的最低點 */
+static float peak_detect_valley(const float *mag, int k, int dir, int span, int lo, int hi)
+{
+    float v = mag[k];
+    float low = v;
+
+    for (int i = k + dir, s = 0; s < span && i >= lo && i <= hi; i += dir, s++)
+    {
+        if (mag[i] > v)
+        {
+            break;
+        }
+
+        if (mag[i] < low) low = mag[i];
+    }
+
+    return low;
+}
+
+/**
+ * @brief       把候選峰值放進依幅度排序的結果陣列
+ * @note        候選由低頻往高頻送入, 已選出的峰值頻點都比較小, 彼此又相距 min_sep 以上,
+ *              所以最多只會與一個峰值衝突
+ * @param       peaks  : 結果陣列 (由大到小)
+ * @param       n      : 目前個數
+ * @param       cap    : 容量
+ * @param       min_sep: 最小間距
+ * @param       p      : 候選
+ * @retval      新的個數
+ */
+static uint8_t peak_detect_insert(peak_detect_t *peaks, uint8_t n, uint8_t cap, uint16_t min_sep,
+                                  const peak_detect_t *p)
+{
+    for (uint8_t i = 0; i < n; i++)
+    {
+        if (p->bin - peaks[i].bin < min_sep)
+        {
+            if (peaks[i].value >= p->value)
+            {
+                return n;
+            }
+
+            memmove(&peaks[i], &peaks[i + 1], (n - i - 1) * sizeof(peak_detect_t));
+            n--;
+            break;
+        }
+    }
+
+    if (n == cap)
+    {
+        if (p->value <= peaks[n - 1].value)
+        {
+            return n;
+        }
+
+        n--;                            /* 擠掉最小的 */
+    }
+
+    uint8_t j = n;
+    while (j > 0 && peaks[j - 1].value < p->value)
+    {
+        peaks[j] = peaks[j - 1];
+        j--;
+    }
+    peaks[j] = *p;
+
+    return n + 1;
+}
+
+/**
+ * @brief       在 bin_start ~ bin_end 內找出最多 cfg->max_peaks 個峰值 (條件見 peak_detect.h)
+ * @param       cfg      : 參數
+ * @param       mag      : 幅度頻譜 (只讀取 bin_start ~ bin_end)
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @param       peaks    : 輸出, 依幅度由大到小
+ * @retval      峰值數
+ */
+uint8_t peak_detect_run(const peak_detect_cfg_t *cfg, const float *mag, uint16_t bin_start, uint16_t bin_end,
+                        peak_detect_t *peaks)
+{
+    int lo = bin_start;
+    int hi = bin_end;
+    int guard = cfg->guard;
+    int span = cfg->guard + cfg->train;
+    uint8_t cap = (cfg->max_peaks < PEAK_DETECT_MAX) ? cfg->max_peaks : PEAK_DETECT_MAX;
+    uint8_t n = 0;
+
+    if (cap == 0 || hi - lo < 2)
+    {
+        return 0;
+    }
+
+    /* dB => 幅度比, 每次呼叫只算一次 */
+    float th = powf(10.0f, cfg->threshold_db / 20.0f);
+    float pr = powf(10.0f, cfg->prominence_db / 20.0f);
+
+    /* 左右訓練頻點的滑動和; k = lo 時左側為空 */
+    float sum_l = 0.0f, sum_r = 0.0f;
+    int cnt_l = 0, cnt_r = 0;
+
+    for (int i = lo + guard + 1; i <= lo + span && i <= hi; i++)
+    {
+        sum_r += mag[i];
+        cnt_r++;
+    }
+
+    for (int k = lo; k <= hi; k++)
+    {
+        if (k > lo)
+        {
+            /* 左側 [k-span, k-guard-1], 右側 [k+guard+1, k+span], 每次各進一點出一點 */
+            int i;
+
+            i = k - guard - 1;  if (i >= lo) { sum_l += mag[i]; cnt_l++; }
+            i = k - span - 1;   if (i >= lo) { sum_l -= mag[i]; cnt_l--; }
+            i = k + guard;      if (i <= hi) { sum_r -= mag[i]; cnt_r--; }
+            i = k + span;       if (i <= hi) { sum_r += mag[i]; cnt_r++; }
+        }
+
+        if (k == lo || k == hi)
+        {
+            continue;
+        }
+
+        float v = mag[k];
+
+        if (!(v > mag[k - 1] && v >= mag[k + 1]))
+        {
+            continue;
+        }
+
+        int cnt = cnt_l + cnt_r;
+        float noise = (cnt > 0) ? (sum_l + sum_r) / (float)cnt : 0.0f;
+
+        if (noise < 0.0f) noise = 0.0f;         /* 滑動和的捨入誤差 */
+
+        if (!(v > noise * th))
+        {
+            continue;
+        }
+
+        /* 放不進結果陣列的候選不必再算突出度 */
+        if (n == cap && v <= peaks[n - 1].value)
+        {
+            continue;
+        }
+
+        float base_l = peak_detect_valley(mag, k, -1, span, lo, hi);
+        float base_r = peak_detect_valley(mag, k, +1, span, lo, hi);
+        float base = (base_l > base_r) ? base_l : base_r;
+
+        if (!(v > base * pr))
+        {
+            continue;
+        }
+
+        peak_detect_t p;
+        p.bin   = (uint16_t)k;
+        p.value = v;
+        p.noise = noise;
+
+        n = peak_detect_insert(peaks, n, cap, cfg->min_sep, &p);
+    }
+
+    return n;
+}
@@ -0,0 +1,58 @@
+/**
+ ****************************************************************************************************
+ * @file        peak_detect.h
+ * @brief       多峰值檢測: CA-CFAR 門檻 + 最小間距 + 突出度, 取最大的前 N 個
+ ****************************************************************************************************
+ * @attention
+ *
+ * 輸入為幅度頻譜 (fft_proc_t.mag) 的 bin_start ~ bin_end, 輸出固定容量的陣列, 依幅度由大到小.
+ * 頻點 k 要成為峰值需同時滿足:
+ *   1. 局部最大: mag[k-1] < mag[k] >= mag[k+1] (範圍兩端的頻點不算)
+ *   2. CA-CFAR: mag[k] > 雜訊估計 x 10^(threshold_db/20), 雜訊估計為 k 左右兩側
+ *      各 train 個訓練頻點的平均 (跳過緊鄰的 guard 個保護頻點, 主瓣應落在保護頻點內);
+ *      靠近範圍兩端時只用範圍內的訓練頻點
+ *   3. 突出度: 往左右各走最多 guard + train 個頻點 (遇到更高的頻點即停), 兩側最低點中
+ *      較高者為基準, mag[k] 需高於基準 prominence_db 以上
+ *   4. 與已選出的峰值相距 min_sep 個頻點以上; 相距太近時保留較大者
+ *
+ * 耗時上限: 雜訊估計以滑動和逐點更新 (每點常數次加減), 突出度只對通過 1, 2 且
+ * 大於目前第 N 名的候選計算 (每個最多 2 x (guard + train) 點), 結果陣列插入每次最多 N 步.
+ * 最壞情況為 O(n x (guard + train + N)), 與訊號內容無關, 不配置記憶體. 不依賴 HAL / LVGL.
+ *
+ * 掃描由低頻往高頻; 與已選出的峰值衝突時只比較該峰值, 因此結果不一定與「先排序再挑選」完全相同
+ * (被較大峰值取代的峰值原本擋掉的候選不會再回來), 對顯示用的標記沒有影響.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __PEAK_DETECT_H
+#define __PEAK_DETECT_H
+
+#include <stdint.h>
+
+
+#define PEAK_DETECT_MAX         8           /* 結果陣列容量 */
+
+typedef struct
+{
+    uint16_t guard;             /* 每側保護頻點數 (涵蓋窗函數主瓣, Hann 2, Blackman-Harris 4, flattop 5) */
+    uint16_t train;             /* 每側訓練頻點數 */
+    float    threshold_db;      /* 高於雜訊估計的門檻 (dB) */
+    float    prominence_db;     /* 最小突出度 (dB) */
+    uint16_t min_sep;           /* 峰值最小間距 (頻點) */
+    uint8_t  max_peaks;         /* 最多輸出幾個 (<= PEAK_DETECT_MAX) */
+} peak_detect_cfg_t;
+
+typedef struct
+{
+    uint16_t bin;               /* 頻點 */
+    float    value;             /* 幅度 */
+    float    noise;             /* CFAR 雜訊估計 (同幅度單位) */
+} peak_detect_t;
+
+
+void peak_detect_default(peak_detect_cfg_t *cfg);
+uint8_t peak_detect_run(const peak_detect_cfg_t *cfg, const float *mag, uint16_t bin_start, uint16_t bin_end,
+                        peak_detect_t *peaks);     /* 回傳峰值數, peaks[] 至少 cfg->max_peaks 個 */
+
+#endif
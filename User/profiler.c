@@ -0,0 +1,162 @@
+/**
+ ****************************************************************************************************
+ * @file        profiler.c
+ * @brief       各處理階段的耗時統計
+ ****************************************************************************************************
+ */
+
+#if !(defined(__arm__) && !defined(PROFILE_HOST))
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+
+
+static prof_stat_t s_stat[PROF_ZONE_COUNT];
+
+static const char * const s_zone_name[PROF_ZONE_COUNT] =
+{
+    "acq_copy",
+    "convert",
+    "rfft",
+    "mag",
+    "peak",
+    "fft_total",
+    "ui_update",
+    "disp_flush",
+    "lv_handler",
+    "peaks",
+    "avg",
+    "tones",
+    "zoom_ddc",
+    "zoom_fft",
+};
+
+
+#if defined(__arm__) && !defined(PROFILE_HOST)
+
+/**
+ * @brief       開啟 DWT 週期計數器並清除統計
+ * @retval      無
+ */
+void prof_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    prof_reset();
+}
+
+uint32_t prof_tick_hz(void)
+{
+    return SystemCoreClock;
+}
+
+#else
+
+void prof_init(void)
+{
+    prof_reset();
+}
+
+/**
+ * @brief       主機端時間戳 (ns, 32 位元回繞, 只用來計算差值)
+ * @retval      目前時間
+ */
+uint32_t prof_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t prof_tick_hz(void)
+{
+    return 1000000000u;
+}
+
+#endif
+
+/**
+ * @brief       清除所有區段的統計
+ * @retval      無
+ */
+void prof_reset(void)
+{
+    memset(s_stat, 0, sizeof(s_stat));
+
+    for (int i = 0; i < PROF_ZONE_COUNT; i++)
+    {
+        s_stat[i].min = UINT32_MAX;
+    }
+}
+
+/**
+ * @brief       記錄一次量測
+ * @param       zone : 區段
+ * @param       ticks: 耗時
+ * @retval      無
+ */
+void prof_record(prof_zone_t zone, uint32_t ticks)
+{
+    prof_stat_t *st = &s_stat[zone];
+    uint32_t bin = 0;
+    uint32_t v = ticks >> (PROF_HIST_MIN_LOG2 + 1);
+
+    while (v != 0 && bin < PROF_HIST_BINS - 1)
+    {
+        v >>= 1;
+        bin++;
+    }
+
+    st->count++;
+    st->sum += ticks;
+    if (ticks < st->min) st->min = ticks;
+    if (ticks > st->max) st->max = ticks;
+    if (st->hist[bin] != 0xFFFF) st->hist[bin]++;
+}
+
+/**
+ * @brief       取得區段統計
+ * @param       zone: 區段
+ * @retval      統計資料 (可能在讀取時被更新, 僅供顯示)
+ */
+const prof_stat_t *prof_get(prof_zone_t zone)
+{
+    return &s_stat[zone];
+}
+
+const char *prof_zone_name(prof_zone_t zone)
+{
+    return s_zone_name[zone];
+}
+
+/**
+ * @brief       以 printf 輸出所有區段 (時間換算成 us)
+ * @note        板端的 printf 為阻塞式且與遙測共用 UART1, 板端請改用 telemetry_send_profile()
+ * @retval      無
+ */
+void prof_print(void)
+{
+    float us_per_tick = 1e6f / (float)prof_tick_hz();
+
+    printf("%-12s %8s %10s %10s %10s\n", "zone", "count", "min(us)", "mean(us)", "max(us)");
+
+    for (int i = 0; i < PROF_ZONE_COUNT; i++)
+    {
+        const prof_stat_t *st = &s_stat[i];
+
+        if (st->count == 0)
+        {
+            continue;
+        }
+
+        printf("%-12s %8lu %10.2f %10.2f %10.2f\n", s_zone_name[i], (unsigned long)st->count,
+               st->min * us_per_tick, (float)(st->sum / st->count) * us_per_tick, st->max * us_per_tick);
+    }
+}
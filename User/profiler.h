@@ -0,0 +1,99 @@
+/**
+ ****************************************************************************************************
+ * @file        profiler.h
+ * @brief       各處理階段的耗時統計 (板端: DWT CYCCNT; 主機端: clock_gettime)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 用法:
+ *   PROF_BEGIN(PROF_ZONE_RFFT);
+ *   arm_rfft_fast_f32(...);
+ *   PROF_END(PROF_ZONE_RFFT);
+ *
+ * 或自行取得時間戳: t0 = prof_now(); ... prof_record(zone, prof_now() - t0);
+ *
+ * 每個區段記錄次數, 最小/最大/平均值, 以及以 2 的冪分組的直方圖.
+ * 單位為 tick: 板端為 CPU 週期 (prof_tick_hz() = SystemCoreClock), 主機端為 ns.
+ * PROFILE_ENABLE 設為 0 時 PROF_BEGIN/PROF_END 展開為空, 不佔任何時間.
+ *
+ * prof_record() 非可重入: 同一區段只能在同一個執行環境 (同一中斷或主迴圈) 中記錄.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <stdint.h>
+
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE          1
+#endif
+
+#define PROF_HIST_BINS          20      /* 直方圖分組數 */
+#define PROF_HIST_MIN_LOG2      8       /* 第 0 組: < 2^9 tick; 第 i 組: [2^(i+8), 2^(i+9)); 最後一組含更大的值 */
+
+/* 區段 (新增時同步修改 profiler.c 的 s_zone_name) */
+typedef enum
+{
+    PROF_ZONE_ACQ_COPY = 0,     /* DMA 半緩衝 => 歷史緩衝 (多通道時同時解交錯, adc_scan.h) */
+    PROF_ZONE_CONVERT,          /* ADC 原始碼 => float */
+    PROF_ZONE_RFFT,             /* arm_rfft_fast_f32 */
+    PROF_ZONE_MAG,              /* 幅度計算 */
+    PROF_ZONE_PEAK,             /* 頻點範圍 + 峰值搜尋 + 遙測 */
+    PROF_ZONE_FFT_TOTAL,        /* 一幀的完整處理 */
+    PROF_ZONE_UI_UPDATE,        /* update_lvgl_charts */
+    PROF_ZONE_DISP_FLUSH,       /* disp_flush 到 flush_ready (含 DMA 傳輸) */
+    PROF_ZONE_LV_HANDLER,       /* lv_task_handler (含繪製) */
+    PROF_ZONE_PEAKS,            /* 多峰值檢測 + 插值 (peak_detect.h) */
+    PROF_ZONE_AVG,              /* 頻譜平均 (spec_avg.h) */
+    PROF_ZONE_TONES,            /* 固定頻率追蹤 + 遙測 (tone_bank.h) */
+    PROF_ZONE_ZOOM_DDC,         /* zoom FFT 混頻 + 抽取濾波 (zoom_fft.h) */
+    PROF_ZONE_ZOOM_FFT,         /* zoom FFT 加窗 + 複數 FFT + 幅度 */
+    PROF_ZONE_COUNT
+} prof_zone_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t hist[PROF_HIST_BINS];      /* 飽和於 0xFFFF */
+} prof_stat_t;
+
+
+#if defined(__arm__) && !defined(PROFILE_HOST)
+
+#include "./SYSTEM/sys/sys.h"
+
+static inline uint32_t prof_now(void)
+{
+    return DWT->CYCCNT;
+}
+
+#else
+
+uint32_t prof_now(void);
+
+#endif
+
+#if PROFILE_ENABLE
+#define PROF_BEGIN(zone)        uint32_t prof_t0_##zone = prof_now()
+#define PROF_END(zone)          prof_record((zone), prof_now() - prof_t0_##zone)
+#else
+#define PROF_BEGIN(zone)
+#define PROF_END(zone)
+#endif
+
+
+void prof_init(void);                                   /* 開啟計數器並清除統計 */
+void prof_reset(void);                                  /* 清除統計 */
+void prof_record(prof_zone_t zone, uint32_t ticks);
+uint32_t prof_tick_hz(void);
+const prof_stat_t *prof_get(prof_zone_t zone);
+const char *prof_zone_name(prof_zone_t zone);
+void prof_print(void);                                  /* 以 printf 輸出文字表格 (主機端/除錯用) */
+
+#endif
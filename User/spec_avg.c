@@ -0,0 +1,160 @@
+/**
+ ****************************************************************************************************
+ * @file        spec_avg.c
+ * @brief       頻譜平均
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "spec_avg.h"
+
+
+static const char * const s_mode_name[SPEC_AVG_COUNT] =
+{
+    "off",
+    "linear",
+    "exp",
+    "max-hold",
+    "min-hold",
+};
+
+
+/**
+ * @brief       初始化 (關閉平均)
+ * @param       a       : 平均器
+ * @param       acc     : 累加器
+ * @param       capacity: 累加器點數 (最大頻點範圍)
+ * @retval      無
+ */
+void spec_avg_init(spec_avg_t *a, float *acc, uint16_t capacity)
+{
+    a->mode     = SPEC_AVG_OFF;
+    a->n        = 16;
+    a->alpha    = 0.1f;
+    a->decay    = 0.94406088f;          /* 10^(-0.5/20) */
+    a->acc      = acc;
+    a->capacity = capacity;
+    spec_avg_reset(a);
+}
+
+/**
+ * @brief       切換模式並重新開始
+ * @param       a   : 平均器
+ * @param       mode: 模式
+ * @retval      無
+ */
+void spec_avg_set_mode(spec_avg_t *a, spec_avg_mode_t mode)
+{
+    a->mode = (mode < SPEC_AVG_COUNT) ? mode : SPEC_AVG_OFF;
+    spec_avg_reset(a);
+}
+
+/**
+ * @brief       重新開始 (下一幀直接成為累加器的初值)
+ * @param       a: 平均器
+ * @retval      無
+ */
+void spec_avg_reset(spec_avg_t *a)
+{
+    a->count     = 0;
+    a->bin_start = 0;
+    a->bin_end   = 0;
+}
+
+/**
+ * @brief       模式名稱
+ * @param       mode: 模式
+ * @retval      名稱字串
+ */
+const char *spec_avg_mode_name(spec_avg_mode_t mode)
+{
+    return (mode < SPEC_AVG_COUNT) ? s_mode_name[mode] : "?";
+}
+
+/**
+ * @brief       以本幀更新累加器, 並把平均結果寫回 mag[bin_start..bin_end]
+ * @note        範圍與上一幀不同 (或重新開始後的第一幀) 時以本幀為初值;
+ *              範圍超過累加器容量時不平均
+ * @param       a        : 平均器
+ * @param       mag      : 幅度頻譜 (fft_proc_t.mag)
+ * @param       bin_start: 第一個頻點
+ * @param       bin_end  : 最後一個頻點 (含)
+ * @retval      無
+ */
+void spec_avg_apply(spec_avg_t *a, float *mag, uint16_t bin_start, uint16_t bin_end)
+{
+    uint32_t n = bin_end - bin_start + 1;
+    float *x = &mag[bin_start];
+    float *acc = a->acc;
+    float w;
+
+    if (a->mode == SPEC_AVG_OFF || n > a->capacity)
+    {
+        return;
+    }
+
+    if (a->count == 0 || bin_start != a->bin_start || bin_end != a->bin_end)
+    {
+        memcpy(acc, x, n * sizeof(float));
+        a->bin_start = bin_start;
+        a->bin_end   = bin_end;
+        a->count     = 1;
+        return;
+    }
+
+    switch (a->mode)
+    {
+        case SPEC_AVG_LINEAR:
+        case SPEC_AVG_EXP:
+            if (a->mode == SPEC_AVG_LINEAR)
+            {
+                if (a->count < a->n) a->count++;
+                w = 1.0f / (float)a->count;
+            }
+            else
+            {
+                if (a->count < 0xFFFF) a->count++;
+                w = a->alpha;
+            }
+
+            for (uint32_t i = 0; i < n; i++)
+            {
+                float v = acc[i] + w * (x[i] - acc[i]);
+
+                acc[i] = v;
+                x[i]   = v;
+            }
+            break;
+
+        case SPEC_AVG_MAX_HOLD:
+        {
+            float d = a->decay;
+
+            if (a->count < 0xFFFF) a->count++;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                float v = acc[i] * d;
+
+                if (x[i] > v) v = x[i];
+                acc[i] = v;
+                x[i]   = v;
+            }
+            break;
+        }
+
+        case SPEC_AVG_MIN_HOLD:
+            if (a->count < 0xFFFF) a->count++;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                float v = acc[i];
+
+                if (x[i] < v) v = x[i];
+                acc[i] = v;
+                x[i]   = v;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
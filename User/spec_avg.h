@@ -0,0 +1,67 @@
+/**
+ ****************************************************************************************************
+ * @file        spec_avg.h
+ * @brief       頻譜平均: 線性 N 幀, 指數, 峰值保持 (含衰減), 最小值保持
+ ****************************************************************************************************
+ * @attention
+ *
+ * 在 fft_proc_spectrum_range() 之後, 對 mag[bin_start..bin_end] 原地平均 (之後的峰值搜尋,
+ * 多峰值檢測, 抽取與 dB 看到的都是平均後的曲線). 每幀只更新一次累加器, 不保存歷史幀:
+ *   SPEC_AVG_LINEAR    acc += (x - acc) / k, k = 1, 2, ..., n; 前 n 幀為算術平均,
+ *                      之後 k 固定為 n (與頻譜分析儀的 running average 相同, 等同 alpha = 1/n 的指數平均)
+ *   SPEC_AVG_EXP       acc += alpha x (x - acc)
+ *   SPEC_AVG_MAX_HOLD  acc = max(x, acc x decay), decay = 1 為純保持
+ *   SPEC_AVG_MIN_HOLD  acc = min(x, acc)
+ * 平均在幅度上進行 (video averaging), 正弦波振幅不變, 雜訊底的平均值比 RMS 低約 1dB.
+ *
+ * 記憶體: 累加器為一個 float 陣列, 點數 >= 最大計算範圍 (板端為 NPT_MAX / 2 + 1 = 2049 點, 8KB,
+ * 與其他 DSP 暫存區一起放在 CCM), 另加本結構. 頻點範圍改變時自動重新開始;
+ * 點數或窗函數改變時由呼叫端 spec_avg_reset().
+ *
+ * 耗時: 每個頻點讀 x 與 acc 各一次, 寫回兩者各一次, 加一次乘加 (或比較), 與 n / alpha 無關.
+ * M4 (CCM, 單精度 FPU) 估計每頻點約 6 週期: 預設範圍 206 點約 1.2k 週期 (7us @168MHz),
+ * 最大範圍 2049 點約 12k 週期 (73us), 比一次 1024 點 RFFT 小一個數量級.
+ * 主機量測與正確性比對見 Tools/avg_bench.c; 板端見 profiler 的 avg 區段.
+ * 不依賴 HAL.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __SPEC_AVG_H
+#define __SPEC_AVG_H
+
+#include <stdint.h>
+
+
+typedef enum
+{
+    SPEC_AVG_OFF = 0,
+    SPEC_AVG_LINEAR,
+    SPEC_AVG_EXP,
+    SPEC_AVG_MAX_HOLD,
+    SPEC_AVG_MIN_HOLD,
+    SPEC_AVG_COUNT
+} spec_avg_mode_t;
+
+typedef struct
+{
+    spec_avg_mode_t mode;
+    uint16_t n;                 /* 線性平均幀數 (>= 1) */
+    float    alpha;             /* 指數平均係數 (0 ~ 1, 越小越平滑) */
+    float    decay;             /* 峰值保持每幀的衰減倍數 (<= 1) */
+
+    float   *acc;               /* 累加器, capacity 點 */
+    uint16_t capacity;
+    uint16_t bin_start;         /* 累加器對應的頻點範圍 */
+    uint16_t bin_end;
+    uint16_t count;             /* 重新開始後累積的幀數 (線性平均時不超過 n) */
+} spec_avg_t;
+
+
+void spec_avg_init(spec_avg_t *a, float *acc, uint16_t capacity);     /* 關閉, n = 16, alpha = 0.1, 每幀衰減 0.5dB */
+void spec_avg_set_mode(spec_avg_t *a, spec_avg_mode_t mode);         /* 並重新開始 */
+void spec_avg_reset(spec_avg_t *a);
+const char *spec_avg_mode_name(spec_avg_mode_t mode);
+void spec_avg_apply(spec_avg_t *a, float *mag, uint16_t bin_start, uint16_t bin_end);
+
+#endif
@@ -121,14 +121,7 @@ void DebugMon_Handler(void)
 {
 }
 
-/**
-  * @brief  This function handles PendSVC exception.
-  * @param  None
-  * @retval None
-  */
-void PendSV_Handler(void)
-{
-}
+/* PendSV_Handler() is implemented in main.c (deferred FFT processing) */
 
 /**
   * @brief  This function handles SysTick Handler.
@@ -0,0 +1,207 @@
+/**
+ ****************************************************************************************************
+ * @file        telemetry.c
+ * @brief       UART1 二進位遙測: TX 環形緩衝 + HAL_UART_Transmit_DMA
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "./SYSTEM/usart/usart.h"
+#include "telemetry.h"
+#include "profiler.h"
+
+
+#if TELEM_PROF_HIST_BINS != PROF_HIST_BINS
+#error "TELEM_PROF_HIST_BINS must match PROF_HIST_BINS"
+#endif
+
+
+DMA_HandleTypeDef g_dma_usart1_tx;
+
+static uint8_t s_tx_ring[TELEM_TX_RING_SIZE];
+static volatile uint32_t s_tx_head = 0;     /* 寫入端 (telemetry_send) */
+static volatile uint32_t s_tx_tail = 0;     /* DMA 完成後前進 */
+static volatile uint16_t s_tx_len  = 0;     /* 正在傳送的長度, 0 表示 DMA 閒置 */
+
+volatile uint32_t g_telem_dropped = 0;
+
+/**
+ * @brief       從 tail 開始啟動下一段連續資料的 DMA 傳送
+ * @note        呼叫時必須已關中斷或位於 UART 中斷中
+ * @retval      無
+ */
+static void telemetry_kick(void)
+{
+    uint32_t tail = s_tx_tail;
+    uint32_t avail = s_tx_head - tail;
+    uint32_t off = tail & (TELEM_TX_RING_SIZE - 1);
+    uint32_t len;
+
+    if (s_tx_len != 0 || avail == 0)
+    {
+        return;
+    }
+
+    len = TELEM_TX_RING_SIZE - off;     /* 繞回時分兩段傳 */
+    if (len > avail)
+    {
+        len = avail;
+    }
+
+    s_tx_len = (uint16_t)len;
+
+    if (HAL_UART_Transmit_DMA(&g_uart1_handle, &s_tx_ring[off], (uint16_t)len) != HAL_OK)
+    {
+        s_tx_len = 0;
+    }
+}
+
+/**
+ * @brief       初始化 UART1 TX DMA
+ * @retval      無
+ */
+void telemetry_init(void)
+{
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    g_dma_usart1_tx.Instance                 = TELEM_DMA_STREAM;
+    g_dma_usart1_tx.Init.Channel             = TELEM_DMA_CHANNEL;
+    g_dma_usart1_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    g_dma_usart1_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    g_dma_usart1_tx.Init.MemInc              = DMA_MINC_ENABLE;
+    g_dma_usart1_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    g_dma_usart1_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    g_dma_usart1_tx.Init.Mode                = DMA_NORMAL;
+    g_dma_usart1_tx.Init.Priority            = DMA_PRIORITY_LOW;
+    g_dma_usart1_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_Init(&g_dma_usart1_tx);
+
+    __HAL_LINKDMA(&g_uart1_handle, hdmatx, g_dma_usart1_tx);
+
+    HAL_NVIC_SetPriority(TELEM_DMA_IRQn, 3, 2);
+    HAL_NVIC_EnableIRQ(TELEM_DMA_IRQn);
+}
+
+/**
+ * @brief       把一個已編碼的幀放入 TX 環形緩衝並啟動 DMA
+ * @note        可在任何中斷或主迴圈中呼叫; 預留空間與複製 (最多 TELEM_FRAME_MAX 位元組)
+ *              在關中斷下完成, 不同執行環境的幀不會交錯. 空間不足時整幀丟棄, 不等待
+ * @param       frame: 已編碼的幀 (含 0x00 分隔符)
+ * @param       len  : 長度
+ * @retval      0: 成功; 1: 緩衝不足, 已丟棄
+ */
+uint8_t telemetry_send(const uint8_t *frame, uint16_t len)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t head;
+    uint32_t off;
+    uint32_t first;
+
+    __disable_irq();
+
+    head = s_tx_head;
+
+    if (TELEM_TX_RING_SIZE - (head - s_tx_tail) < len)
+    {
+        g_telem_dropped++;
+        __set_PRIMASK(primask);
+        return 1;
+    }
+
+    off = head & (TELEM_TX_RING_SIZE - 1);
+    first = TELEM_TX_RING_SIZE - off;
+    if (first > len)
+    {
+        first = len;
+    }
+
+    memcpy(&s_tx_ring[off], frame, first);
+    memcpy(&s_tx_ring[0], frame + first, len - first);
+
+    s_tx_head = head + len;
+    telemetry_kick();
+
+    __set_PRIMASK(primask);
+    return 0;
+}
+
+/**
+ * @brief       編碼並送出一個 PEAK 封包
+ * @param       pk: 峰值資料
+ * @retval      0: 成功; 1: 緩衝不足, 已丟棄
+ */
+uint8_t telemetry_send_peak(const telem_peak_t *pk)
+{
+    uint8_t frame[TELEM_FRAME_MAX];
+    uint16_t len = telem_encode_peak(pk, frame);
+
+    return telemetry_send(frame, len);
+}
+
+/**
+ * @brief       編碼並送出一個 TONE 封包
+ * @param       tn: 追蹤結果
+ * @retval      0: 成功; 1: 緩衝不足, 已丟棄
+ */
+uint8_t telemetry_send_tone(const telem_tone_t *tn)
+{
+    uint8_t frame[TELEM_FRAME_MAX];
+    uint16_t len = telem_encode_tone(tn, frame);
+
+    return telemetry_send(frame, len);
+}
+
+/**
+ * @brief       送出每個有資料的 profiler 區段 (每區段一個 PROF 封包)
+ * @note        約 70 位元組/區段, 115200bps 下約 6ms/區段, 呼叫間隔應在秒級
+ * @retval      無
+ */
+void telemetry_send_profile(void)
+{
+    uint8_t frame[TELEM_FRAME_MAX];
+    telem_prof_t pr;
+
+    for (int i = 0; i < PROF_ZONE_COUNT; i++)
+    {
+        const prof_stat_t *st = prof_get((prof_zone_t)i);
+
+        if (st->count == 0)
+        {
+            continue;
+        }
+
+        pr.zone    = (uint8_t)i;
+        pr.count   = st->count;
+        pr.min     = st->min;
+        pr.max     = st->max;
+        pr.mean    = (uint32_t)(st->sum / st->count);
+        pr.tick_hz = prof_tick_hz();
+        memcpy(pr.hist, st->hist, sizeof(pr.hist));
+
+        telemetry_send(frame, telem_encode_prof(&pr, frame));
+    }
+}
+
+/**
+ * @brief       UART 傳送完成回呼 (DMA 傳完 + 最後一個位元組移出)
+ * @param       huart: UART句柄
+ * @retval      無
+ */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART_UX)
+    {
+        s_tx_tail += s_tx_len;
+        s_tx_len = 0;
+        telemetry_kick();
+    }
+}
+
+/**
+ * @brief       DMA2_Stream7 中斷服務函數 (USART1_TX)
+ * @retval      無
+ */
+void TELEM_DMA_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&g_dma_usart1_tx);
+}
@@ -0,0 +1,39 @@
+/**
+ ****************************************************************************************************
+ * @file        telemetry.h
+ * @brief       UART1 二進位遙測: TX 環形緩衝 + HAL_UART_Transmit_DMA (DMA2_Stream7 / Channel4)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 取代 FFT 熱路徑中的 printf: 呼叫端只把編碼好的幀放入環形緩衝 (數 us),
+ * 實際傳輸由 DMA 在背景完成. 緩衝不足時整幀丟棄並計數, 不會阻塞呼叫端.
+ * telemetry_send() 在關中斷下寫入環形緩衝, 主迴圈與 PendSV 可同時使用.
+ * 封包格式見 telemetry_codec.h.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __TELEMETRY_H
+#define __TELEMETRY_H
+
+#include "./SYSTEM/sys/sys.h"
+#include "telemetry_codec.h"
+
+
+#define TELEM_TX_RING_SIZE      1024    /* TX 環形緩衝大小, 必須為 2 的冪 */
+
+#define TELEM_DMA_STREAM        DMA2_Stream7
+#define TELEM_DMA_CHANNEL       DMA_CHANNEL_4
+#define TELEM_DMA_IRQn          DMA2_Stream7_IRQn
+#define TELEM_DMA_IRQHandler    DMA2_Stream7_IRQHandler
+
+extern volatile uint32_t g_telem_dropped;   /* 緩衝不足而丟棄的幀數 */
+
+
+void telemetry_init(void);                                      /* 需在 usart_init() 之後呼叫 */
+uint8_t telemetry_send(const uint8_t *frame, uint16_t len);     /* 送出已編碼的幀, 0: 成功 */
+uint8_t telemetry_send_peak(const telem_peak_t *pk);            /* 編碼並送出 PEAK 封包, 0: 成功 */
+uint8_t telemetry_send_tone(const telem_tone_t *tn);            /* 編碼並送出 TONE 封包, 0: 成功 */
+void telemetry_send_profile(void);                              /* 送出每個有資料的 profiler 區段 */
+
+#endif
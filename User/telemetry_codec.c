@@ -0,0 +1,392 @@
+/**
+ ****************************************************************************************************
+ * @file        telemetry_codec.c
+ * @brief       二進位遙測封包: 封包格式 + COBS 分幀 + CRC16
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "telemetry_codec.h"
+
+
+/* little-endian 讀寫 */
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_f32(uint8_t *p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    put_u32(p, v);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float get_f32(const uint8_t *p)
+{
+    uint32_t v = get_u32(p);
+    float f;
+    memcpy(&f, &v, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief       CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+ * @param       data: 資料
+ * @param       len : 長度
+ * @retval      CRC 值
+ */
+uint16_t telem_crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--)
+    {
+        crc ^= (uint16_t)(*data++) << 8;
+
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief       COBS 編碼
+ * @param       src: 原始資料
+ * @param       len: 原始長度
+ * @param       dst: 輸出緩衝, 至少 COBS_MAX_ENCODED(len) 位元組
+ * @retval      編碼後長度 (不含 0x00 分隔符)
+ */
+uint16_t cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+    uint16_t code_idx = 0;
+    uint16_t out = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (src[i] == 0)
+        {
+            dst[code_idx] = code;
+            code_idx = out++;
+            code = 1;
+        }
+        else
+        {
+            dst[out++] = src[i];
+            code++;
+
+            if (code == 0xFF)
+            {
+                dst[code_idx] = code;
+                code_idx = out++;
+                code = 1;
+            }
+        }
+    }
+
+    dst[code_idx] = code;
+    return out;
+}
+
+/**
+ * @brief       COBS 解碼
+ * @param       src: 編碼資料 (不含 0x00 分隔符)
+ * @param       len: 編碼長度
+ * @param       dst: 輸出緩衝, 至少 len 位元組
+ * @retval      解碼後長度; 格式錯誤回傳 0
+ */
+uint16_t cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dst)
+{
+    uint16_t in = 0;
+    uint16_t out = 0;
+
+    while (in < len)
+    {
+        uint8_t code = src[in++];
+
+        if (code == 0 || in + code - 1 > len)
+        {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            dst[out++] = src[in++];
+        }
+
+        if (code != 0xFF && in < len)
+        {
+            dst[out++] = 0;
+        }
+    }
+
+    return out;
+}
+
+/**
+ * @brief       payload 加上 CRC16, 做 COBS 編碼並補上 0x00 分隔符
+ * @param       payload: 資料 (長度不超過 TELEM_PAYLOAD_MAX)
+ * @param       len    : 長度
+ * @param       frame  : 輸出緩衝, 至少 TELEM_FRAME_MAX 位元組
+ * @retval      幀長度; payload 過長回傳 0
+ */
+uint16_t telem_encode_frame(const uint8_t *payload, uint16_t len, uint8_t *frame)
+{
+    uint8_t raw[TELEM_PAYLOAD_MAX + 2];
+    uint16_t n;
+
+    if (len > TELEM_PAYLOAD_MAX)
+    {
+        return 0;
+    }
+
+    memcpy(raw, payload, len);
+    put_u16(&raw[len], telem_crc16(payload, len));
+
+    n = cobs_encode(raw, len + 2, frame);
+    frame[n++] = 0x00;
+    return n;
+}
+
+/**
+ * @brief       編碼一個 PEAK 封包
+ * @param       pk   : 峰值資料
+ * @param       frame: 輸出緩衝, 至少 TELEM_FRAME_MAX 位元組
+ * @retval      幀長度
+ */
+uint16_t telem_encode_peak(const telem_peak_t *pk, uint8_t *frame)
+{
+    uint8_t p[TELEM_PEAK_SIZE];
+
+    p[0] = TELEM_TYPE_PEAK;
+    p[1] = TELEM_VERSION;
+    put_u32(&p[2], pk->seq);
+    put_u32(&p[6], pk->timestamp_ms);
+    put_f32(&p[10], pk->peak_freq);
+    put_f32(&p[14], pk->peak_amp);
+    put_u16(&p[18], pk->bin_start);
+    put_u16(&p[20], pk->bin_end);
+
+    return telem_encode_frame(p, TELEM_PEAK_SIZE, frame);
+}
+
+/**
+ * @brief       解析 PEAK payload (由 telem_decoder_feed() 取得)
+ * @param       payload: 資料
+ * @param       len    : 長度
+ * @param       pk     : 輸出
+ * @retval      0: 成功; 1: 型別/版本/長度不符
+ */
+uint8_t telem_parse_peak(const uint8_t *payload, uint16_t len, telem_peak_t *pk)
+{
+    if (len != TELEM_PEAK_SIZE || payload[0] != TELEM_TYPE_PEAK || payload[1] != TELEM_VERSION)
+    {
+        return 1;
+    }
+
+    pk->seq          = get_u32(&payload[2]);
+    pk->timestamp_ms = get_u32(&payload[6]);
+    pk->peak_freq    = get_f32(&payload[10]);
+    pk->peak_amp     = get_f32(&payload[14]);
+    pk->bin_start    = get_u16(&payload[18]);
+    pk->bin_end      = get_u16(&payload[20]);
+    return 0;
+}
+
+/**
+ * @brief       編碼一個 PROF 封包
+ * @param       pr   : 區段統計
+ * @param       frame: 輸出緩衝, 至少 TELEM_FRAME_MAX 位元組
+ * @retval      幀長度
+ */
+uint16_t telem_encode_prof(const telem_prof_t *pr, uint8_t *frame)
+{
+    uint8_t p[TELEM_PROF_SIZE];
+
+    p[0] = TELEM_TYPE_PROF;
+    p[1] = TELEM_VERSION;
+    p[2] = pr->zone;
+    p[3] = TELEM_PROF_HIST_BINS;
+    put_u32(&p[4], pr->count);
+    put_u32(&p[8], pr->min);
+    put_u32(&p[12], pr->max);
+    put_u32(&p[16], pr->mean);
+    put_u32(&p[20], pr->tick_hz);
+
+    for (int i = 0; i < TELEM_PROF_HIST_BINS; i++)
+    {
+        put_u16(&p[24 + 2 * i], pr->hist[i]);
+    }
+
+    return telem_encode_frame(p, TELEM_PROF_SIZE, frame);
+}
+
+/**
+ * @brief       解析 PROF payload
+ * @param       payload: 資料
+ * @param       len    : 長度
+ * @param       pr     : 輸出
+ * @retval      0: 成功; 1: 型別/版本/長度不符
+ */
+uint8_t telem_parse_prof(const uint8_t *payload, uint16_t len, telem_prof_t *pr)
+{
+    if (len != TELEM_PROF_SIZE || payload[0] != TELEM_TYPE_PROF || payload[1] != TELEM_VERSION ||
+        payload[3] != TELEM_PROF_HIST_BINS)
+    {
+        return 1;
+    }
+
+    pr->zone    = payload[2];
+    pr->count   = get_u32(&payload[4]);
+    pr->min     = get_u32(&payload[8]);
+    pr->max     = get_u32(&payload[12]);
+    pr->mean    = get_u32(&payload[16]);
+    pr->tick_hz = get_u32(&payload[20]);
+
+    for (int i = 0; i < TELEM_PROF_HIST_BINS; i++)
+    {
+        pr->hist[i] = get_u16(&payload[24 + 2 * i]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       編碼一個 TONE 封包
+ * @param       tn   : 追蹤結果 (count 超過 TELEM_TONE_MAX 時只送前 TELEM_TONE_MAX 個)
+ * @param       frame: 輸出緩衝, 至少 TELEM_FRAME_MAX 位元組
+ * @retval      幀長度
+ */
+uint16_t telem_encode_tone(const telem_tone_t *tn, uint8_t *frame)
+{
+    uint8_t p[TELEM_TONE_SIZE(TELEM_TONE_MAX)];
+    uint8_t n = (tn->count > TELEM_TONE_MAX) ? TELEM_TONE_MAX : tn->count;
+
+    p[0] = TELEM_TYPE_TONE;
+    p[1] = TELEM_VERSION;
+    put_u32(&p[2], tn->seq);
+    put_u32(&p[6], tn->timestamp_ms);
+    p[10] = n;
+
+    for (int i = 0; i < n; i++)
+    {
+        put_f32(&p[11 + 12 * i], tn->freq[i]);
+        put_f32(&p[15 + 12 * i], tn->amp[i]);
+        put_f32(&p[19 + 12 * i], tn->phase[i]);
+    }
+
+    return telem_encode_frame(p, TELEM_TONE_SIZE(n), frame);
+}
+
+/**
+ * @brief       解析 TONE payload
+ * @param       payload: 資料
+ * @param       len    : 長度
+ * @param       tn     : 輸出
+ * @retval      0: 成功; 1: 型別/版本/長度不符
+ */
+uint8_t telem_parse_tone(const uint8_t *payload, uint16_t len, telem_tone_t *tn)
+{
+    if (len < TELEM_TONE_SIZE(0) || payload[0] != TELEM_TYPE_TONE || payload[1] != TELEM_VERSION ||
+        payload[10] > TELEM_TONE_MAX || len != TELEM_TONE_SIZE(payload[10]))
+    {
+        return 1;
+    }
+
+    tn->seq          = get_u32(&payload[2]);
+    tn->timestamp_ms = get_u32(&payload[6]);
+    tn->count        = payload[10];
+
+    for (int i = 0; i < tn->count; i++)
+    {
+        tn->freq[i]  = get_f32(&payload[11 + 12 * i]);
+        tn->amp[i]   = get_f32(&payload[15 + 12 * i]);
+        tn->phase[i] = get_f32(&payload[19 + 12 * i]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief       初始化串流解碼器
+ * @param       dec: 解碼器
+ * @retval      無
+ */
+void telem_decoder_init(telem_decoder_t *dec)
+{
+    memset(dec, 0, sizeof(*dec));
+}
+
+/**
+ * @brief       餵入一個接收到的位元組
+ * @param       dec    : 解碼器
+ * @param       byte   : 位元組
+ * @param       payload: 輸出緩衝, 至少 TELEM_FRAME_MAX 位元組
+ * @retval      收到完整且 CRC 正確的幀時回傳 payload 長度 (不含 CRC), 否則回傳 0
+ */
+uint16_t telem_decoder_feed(telem_decoder_t *dec, uint8_t byte, uint8_t *payload)
+{
+    uint16_t n;
+
+    if (byte != 0x00)
+    {
+        if (dec->len < sizeof(dec->buf))
+        {
+            dec->buf[dec->len] = byte;
+        }
+
+        if (dec->len <= sizeof(dec->buf))
+        {
+            dec->len++;     /* 停在 sizeof(buf) + 1, 只用來標記超長 */
+        }
+        return 0;
+    }
+
+    /* 收到分隔符 => 嘗試解碼一幀 */
+    n = dec->len;
+    dec->len = 0;
+
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    if (n > sizeof(dec->buf))
+    {
+        dec->overflow++;
+        return 0;
+    }
+
+    n = cobs_decode(dec->buf, n, payload);
+
+    if (n < 3 || telem_crc16(payload, n - 2) != get_u16(&payload[n - 2]))
+    {
+        dec->bad_frame++;
+        return 0;
+    }
+
+    return n - 2;
+}
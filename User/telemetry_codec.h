@@ -0,0 +1,100 @@
+/**
+ ****************************************************************************************************
+ * @file        telemetry_codec.h
+ * @brief       二進位遙測封包: 封包格式 + COBS 分幀 + CRC16 (與硬體無關, 板端與主機端共用)
+ ****************************************************************************************************
+ * @attention
+ *
+ * 線上格式 (一幀):  COBS( payload + CRC16 ) + 0x00
+ *   payload[0]  : 封包型別 (TELEM_TYPE_xxx)
+ *   payload[1]  : 格式版本 (TELEM_VERSION)
+ *   payload[2..]: 依型別而定, 多位元組欄位一律為 little-endian
+ *   CRC16       : CRC-16/CCITT-FALSE, 涵蓋 payload, little-endian
+ *
+ * COBS 保證幀內不出現 0x00, 因此接收端遇到 0x00 即可重新同步.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __TELEMETRY_CODEC_H
+#define __TELEMETRY_CODEC_H
+
+#include <stdint.h>
+
+
+#define TELEM_VERSION           1
+
+#define TELEM_TYPE_PEAK         0x01        /* 每幀 FFT 峰值 */
+#define TELEM_TYPE_PROF         0x02        /* 一個 profiler 區段的統計 */
+#define TELEM_TYPE_TONE         0x03        /* 每幀固定頻率追蹤結果 (tone_bank.h) */
+
+#define TELEM_PEAK_SIZE         22          /* PEAK payload 長度 (不含 CRC) */
+#define TELEM_PROF_HIST_BINS    20
+#define TELEM_PROF_SIZE         (24 + 2 * TELEM_PROF_HIST_BINS)     /* PROF payload 長度 (不含 CRC) */
+#define TELEM_TONE_MAX          4
+#define TELEM_TONE_SIZE(n)      (11 + 12 * (n))                     /* TONE payload 長度 (n 個頻率, 不含 CRC) */
+#define TELEM_PAYLOAD_MAX       64          /* 任一型別 payload 的上限 (不含 CRC) */
+
+#define COBS_MAX_ENCODED(n)     ((n) + ((n) / 254) + 1)
+#define TELEM_FRAME_MAX         (COBS_MAX_ENCODED(TELEM_PAYLOAD_MAX + 2) + 1)   /* 含 CRC 與 0x00 分隔符 */
+
+/* 每幀 FFT 峰值 */
+typedef struct
+{
+    uint32_t seq;               /* 幀序號 (DMA 回呼序號, 不連續表示有掉幀) */
+    uint32_t timestamp_ms;      /* HAL_GetTick() */
+    float    peak_freq;         /* 峰值頻率 (Hz) */
+    float    peak_amp;          /* 峰值幅度 */
+    uint16_t bin_start;         /* 搜尋範圍第一個頻點 */
+    uint16_t bin_end;           /* 搜尋範圍最後一個頻點 */
+} telem_peak_t;
+
+/* 每幀固定頻率追蹤結果 */
+typedef struct
+{
+    uint32_t seq;               /* 幀序號 (與同一幀的 PEAK 封包相同) */
+    uint32_t timestamp_ms;      /* HAL_GetTick() */
+    uint8_t  count;             /* 頻率數 (<= TELEM_TONE_MAX) */
+    float    freq[TELEM_TONE_MAX];      /* Hz */
+    float    amp[TELEM_TONE_MAX];       /* V 峰值 */
+    float    phase[TELEM_TONE_MAX];     /* rad, 相對於本幀第一點 */
+} telem_tone_t;
+
+/* profiler 區段統計 (見 profiler.h) */
+typedef struct
+{
+    uint8_t  zone;              /* prof_zone_t */
+    uint32_t count;
+    uint32_t min;               /* tick */
+    uint32_t max;
+    uint32_t mean;
+    uint32_t tick_hz;           /* tick 頻率 */
+    uint16_t hist[TELEM_PROF_HIST_BINS];
+} telem_prof_t;
+
+/* 串流解碼器 (接收端) */
+typedef struct
+{
+    uint8_t  buf[TELEM_FRAME_MAX];
+    uint16_t len;
+    uint32_t overflow;          /* 超長幀 (丟棄) 計數 */
+    uint32_t bad_frame;         /* COBS/CRC 錯誤計數 */
+} telem_decoder_t;
+
+
+uint16_t telem_crc16(const uint8_t *data, uint16_t len);
+uint16_t cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dst);          /* 回傳編碼後長度 (不含 0x00) */
+uint16_t cobs_decode(const uint8_t *src, uint16_t len, uint8_t *dst);          /* 回傳解碼後長度, 錯誤回傳 0 */
+
+uint16_t telem_encode_frame(const uint8_t *payload, uint16_t len, uint8_t *frame);   /* 加 CRC + COBS + 0x00, 回傳幀長 */
+uint16_t telem_encode_peak(const telem_peak_t *pk, uint8_t *frame);                  /* 回傳幀長 */
+uint8_t  telem_parse_peak(const uint8_t *payload, uint16_t len, telem_peak_t *pk);   /* 0: 成功 */
+uint16_t telem_encode_prof(const telem_prof_t *pr, uint8_t *frame);                  /* 回傳幀長 */
+uint8_t  telem_parse_prof(const uint8_t *payload, uint16_t len, telem_prof_t *pr);   /* 0: 成功 */
+uint16_t telem_encode_tone(const telem_tone_t *tn, uint8_t *frame);                  /* 回傳幀長 */
+uint8_t  telem_parse_tone(const uint8_t *payload, uint16_t len, telem_tone_t *tn);   /* 0: 成功 */
+
+void     telem_decoder_init(telem_decoder_t *dec);
+uint16_t telem_decoder_feed(telem_decoder_t *dec, uint8_t byte, uint8_t *payload);  /* payload 需 TELEM_FRAME_MAX 位元組; 收到完整且 CRC 正確的幀時回傳 payload 長度 */
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ ****************************************************************************************************
+ * @file        tone_bank.c
+ * @brief       固定頻率追蹤: Goertzel 濾波器組
+ ****************************************************************************************************
+ */
+
+#include <math.h>
+#include "tone_bank.h"
+
+
+#define TONE_BANK_2PI           6.283185307179586
+
+
+/* 第 i 個頻率的係數; w (npt - 1) 可達數千 rad, 以雙精度計算再取 cos / sin (只在設定時) */
+static void tone_bank_coeff(tone_bank_t *tb, uint8_t i)
+{
+    double w = TONE_BANK_2PI * tb->freq[i] / tb->samp;
+    double w_end = fmod(w * (tb->npt - 1), TONE_BANK_2PI);
+
+    tb->coeff[i]   = (float)(2.0 * cos(w));
+    tb->cos_w[i]   = (float)cos(w);
+    tb->sin_w[i]   = (float)sin(w);
+    tb->cos_end[i] = (float)cos(w_end);
+    tb->sin_end[i] = (float)sin(w_end);
+}
+
+/* 遞迴的最後兩個狀態 => 振幅與相位 */
+static void tone_bank_result(const tone_bank_t *tb, uint8_t i, float s1, float s2, tone_result_t *res)
+{
+    float yr = s1 - tb->cos_w[i] * s2;
+    float yi = tb->sin_w[i] * s2;
+    float re = yr * tb->cos_end[i] + yi * tb->sin_end[i];
+    float im = yi * tb->cos_end[i] - yr * tb->sin_end[i];
+
+    res->freq  = tb->freq[i];
+    res->amp   = 2.0f * sqrtf(re * re + im * im) / (float)tb->npt;
+    res->phase = atan2f(im, re);
+}
+
+/**
+ * @brief       清空並設定採樣率與點數
+ * @param       tb  : 濾波器組
+ * @param       samp: 採樣率 (Hz)
+ * @param       npt : 每幀點數
+ * @retval      無
+ */
+void tone_bank_init(tone_bank_t *tb, float samp, uint16_t npt)
+{
+    tb->count = 0;
+    tb->samp  = samp;
+    tb->npt   = npt;
+}
+
+/**
+ * @brief       加入一個追蹤頻率
+ * @param       tb  : 濾波器組
+ * @param       freq: 頻率 (Hz), 0 < freq < samp / 2
+ * @retval      0: 成功; 1: 已滿或頻率超出範圍
+ */
+uint8_t tone_bank_add(tone_bank_t *tb, float freq)
+{
+    if (tb->count >= TONE_BANK_MAX || !(freq > 0.0f) || !(freq < tb->samp * 0.5f))
+    {
+        return 1;
+    }
+
+    tb->freq[tb->count] = freq;
+    tone_bank_coeff(tb, tb->count);
+    tb->count++;
+    return 0;
+}
+
+/**
+ * @brief       採樣率或點數改變 => 重算所有係數 (頻率不變)
+ * @param       tb  : 濾波器組
+ * @param       samp: 採樣率 (Hz)
+ * @param       npt : 每幀點數
+ * @retval      無
+ */
+void tone_bank_set_rate(tone_bank_t *tb, float samp, uint16_t npt)
+{
+    tb->samp = samp;
+    tb->npt  = npt;
+
+    for (uint8_t i = 0; i < tb->count; i++)
+    {
+        tone_bank_coeff(tb, i);
+    }
+}
+
+/**
+ * @brief       一幀 => 每個頻率的振幅與相位
+ * @note        兩個頻率一組走一遍 x[], 每點只讀一次; 頻率數為奇數時最後一個單獨走
+ * @param       tb : 濾波器組
+ * @param       x  : tb->npt 點輸入 (fft_proc_load_u16() 之後的 in[])
+ * @param       res: 輸出, tb->count 個
+ * @retval      無
+ */
+void tone_bank_run(const tone_bank_t *tb, const float *x, tone_result_t *res)
+{
+    uint32_t n = tb->npt;
+    uint8_t i = 0;
+
+    for (; i + 1 < tb->count; i += 2)
+    {
+        float c0 = tb->coeff[i], c1 = tb->coeff[i + 1];
+        float a1 = 0.0f, a2 = 0.0f;
+        float b1 = 0.0f, b2 = 0.0f;
+
+        for (uint32_t k = 0; k < n; k++)
+        {
+            float v = x[k];
+            float a0 = v + c0 * a1 - a2;
+            float b0 = v + c1 * b1 - b2;
+
+            a2 = a1;
+            a1 = a0;
+            b2 = b1;
+            b1 = b0;
+        }
+
+        tone_bank_result(tb, i, a1, a2, &res[i]);
+        tone_bank_result(tb, i + 1, b1, b2, &res[i + 1]);
+    }
+
+    if (i < tb->count)
+    {
+        float c0 = tb->coeff[i];
+        float a1 = 0.0f, a2 = 0.0f;
+
+        for (uint32_t k = 0; k < n; k++)
+        {
+            float a0 = x[k] + c0 * a1 - a2;
+
+            a2 = a1;
+            a1 = a0;
+        }
+
+        tone_bank_result(tb, i, a1, a2, &res[i]);
+    }
+}
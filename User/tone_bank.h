@@ -0,0 +1,65 @@
+/**
+ ****************************************************************************************************
+ * @file        tone_bank.h
+ * @brief       固定頻率追蹤: Goertzel 濾波器組, 任意 (非頻點中心) 頻率的振幅與相位
+ ****************************************************************************************************
+ * @attention
+ *
+ * 只關心少數幾個已知頻率時, 不必做整個 RFFT. 每個頻率一個二階 Goertzel 遞迴:
+ *   s[n] = x[n] + 2cos(w) s[n-1] - s[n-2],  w = 2 pi f / fs
+ * 一幀 npt 點跑完後, y = s[npt-1] - e^(-jw) s[npt-2], 再乘 e^(-jw(npt-1)) 得到
+ *   X(w) = sum x[n] e^(-jwn)
+ * 即 DTFT 在 f 上的值, f 不必是 fs / npt 的整數倍, 所以沒有 scalloping loss.
+ * 輸入為 fft_proc_load_u16() 之後的 in[] (已去直流, 乘上窗函數與振幅修正), 因此
+ *   振幅 = 2 |X| / npt  (V 峰值, 與 fft_proc 的頻點幅度同一刻度)
+ *   相位 = arg X        (rad, 以本幀第一點為時間原點的餘弦相位)
+ * 窗函數決定鄰近頻率的洩漏: 矩形窗的旁瓣會讓其他正弦波混進來, 板端預設的 Hann 窗即可.
+ *
+ * 每幀在 PendSV 處理一個半緩衝 (一整幀) 時更新, 不逐點更新: 逐點的滑動 DFT 只有頻點中心的頻率
+ * 是穩定的, 任意頻率要多一個 e^(-jw npt) 修正項與 npt 點的歷史緩衝, 且單精度的誤差會持續累積.
+ * Goertzel 每幀從零開始, 沒有累積誤差.
+ *
+ * 耗時: 每個頻率每點一次乘加與一次減法, 兩個頻率一組共用一次讀取, 與頻率的位置無關.
+ * M4 估計每頻率每點約 2.5 週期: 1024 點 4 個頻率約 10k 週期, 同點數的 RFFT + 幅度約 40k 週期;
+ * 頻率數約到 log2(npt) 以上時整個 FFT 反而比較省. 主機量測見 Tools/tone_bench.c,
+ * 板端見 profiler 的 tones 區段.
+ * 記憶體: 只有本結構 (每個頻率 6 個 float), 不需要額外緩衝. 不依賴 HAL.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __TONE_BANK_H
+#define __TONE_BANK_H
+
+#include <stdint.h>
+
+
+#define TONE_BANK_MAX           4           /* 追蹤的頻率數上限 */
+
+typedef struct
+{
+    float freq;                 /* Hz */
+    float amp;                  /* V 峰值 */
+    float phase;                /* rad (-pi ~ pi), 相對於本幀第一點的餘弦相位 */
+} tone_result_t;
+
+typedef struct
+{
+    uint8_t  count;
+    uint16_t npt;               /* 每幀點數 */
+    float    samp;              /* 採樣率 (Hz) */
+    float    freq[TONE_BANK_MAX];
+    float    coeff[TONE_BANK_MAX];      /* 2cos(w) */
+    float    cos_w[TONE_BANK_MAX];      /* e^(-jw) */
+    float    sin_w[TONE_BANK_MAX];
+    float    cos_end[TONE_BANK_MAX];    /* e^(-jw(npt-1)), 時間原點移到第一點 */
+    float    sin_end[TONE_BANK_MAX];
+} tone_bank_t;
+
+
+void tone_bank_init(tone_bank_t *tb, float samp, uint16_t npt);         /* 清空, 設定採樣率與點數 */
+uint8_t tone_bank_add(tone_bank_t *tb, float freq);                     /* 0: 成功; 1: 已滿或不在 0 ~ samp/2 */
+void tone_bank_set_rate(tone_bank_t *tb, float samp, uint16_t npt);     /* 採樣率或點數改變時重算係數 */
+void tone_bank_run(const tone_bank_t *tb, const float *x, tone_result_t *res);
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ ****************************************************************************************************
+ * @file        waterfall.c
+ * @brief       頻譜瀑布圖
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include "waterfall.h"
+#include "lv_port_disp_template.h"
+
+
+/* 調色盤的漸層節點 (索引, R, G, B), 之間線性插值: 黑 => 深藍 => 洋紅 => 橘 => 淡黃 */
+static const uint8_t s_palette_stop[][4] =
+{
+    {   0,   0,   0,   0 },
+    {  64,  24,   0, 120 },
+    { 128, 180,   0, 100 },
+    { 192, 255, 140,   0 },
+    { 255, 255, 255, 200 },
+};
+
+static uint16_t  s_lut[256];            /* 索引 => RGB565 */
+static uint8_t  *s_index;               /* WATERFALL_ROWS x WATERFALL_COLS 索引 (環形) */
+static uint16_t *s_rgb;                 /* WATERFALL_ROWS x WATERFALL_COLS RGB565 (環形) */
+static uint16_t  s_head;                /* 最新一列 */
+static uint8_t   s_stale;               /* 1: 隱藏期間加入的列尚未轉成 RGB565 */
+static uint8_t   s_hw;                  /* 1: 由 LCD 硬體捲動顯示, canvas 隱藏 */
+static float     s_db_min;
+static float     s_db_scale;            /* 255 / (db_max - db_min) */
+
+static lv_obj_t *s_cont;
+static lv_obj_t *s_newer;               /* rgb[head .. ROWS-1] */
+static lv_obj_t *s_older;               /* rgb[0 .. head-1] */
+
+
+static void waterfall_make_lut(void)
+{
+    for (int s = 0; s + 1 < (int)(sizeof(s_palette_stop) / sizeof(s_palette_stop[0])); s++)
+    {
+        const uint8_t *a = s_palette_stop[s];
+        const uint8_t *b = s_palette_stop[s + 1];
+        int span = b[0] - a[0];
+
+        for (int i = a[0]; i <= b[0]; i++)
+        {
+            int t = i - a[0];
+            lv_color_t c = lv_color_make((uint8_t)(a[1] + (b[1] - a[1]) * t / span),
+                                         (uint8_t)(a[2] + (b[2] - a[2]) * t / span),
+                                         (uint8_t)(a[3] + (b[3] - a[3]) * t / span));
+
+            s_lut[i] = lv_color_to_u16(c);
+        }
+    }
+}
+
+/* 一列索引 => RGB565 */
+static void waterfall_convert_row(uint16_t row)
+{
+    const uint8_t *src = &s_index[(uint32_t)row * WATERFALL_COLS];
+    uint16_t *dst = &s_rgb[(uint32_t)row * WATERFALL_COLS];
+
+    for (uint32_t x = 0; x < WATERFALL_COLS; x++)
+    {
+        dst[x] = s_lut[src[x]];
+    }
+}
+
+/* 兩個 canvas 指向 rgb[] 的兩段 (只改指標與高度, 不複製) */
+static void waterfall_update_views(void)
+{
+    int32_t newer_h = WATERFALL_ROWS - s_head;
+
+    lv_canvas_set_buffer(s_newer, &s_rgb[(uint32_t)s_head * WATERFALL_COLS], WATERFALL_COLS, newer_h,
+                         LV_COLOR_FORMAT_RGB565);
+
+    if (s_head == 0)
+    {
+        lv_obj_add_flag(s_older, LV_OBJ_FLAG_HIDDEN);
+    }
+    else
+    {
+        lv_canvas_set_buffer(s_older, s_rgb, WATERFALL_COLS, s_head, LV_COLOR_FORMAT_RGB565);
+        lv_obj_set_pos(s_older, 0, newer_h);
+        lv_obj_clear_flag(s_older, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+/* 顯示時嘗試改用硬體捲動: 瀑布圖須從 x = 0 開始 (捲動區為整列), 失敗時維持 canvas */
+static void waterfall_hw_begin(void)
+{
+    lv_area_t a;
+
+    lv_obj_update_layout(s_cont);
+    lv_obj_get_coords(s_cont, &a);
+
+    if (a.x1 != 0 || lv_port_disp_scroll_begin(a.y1, WATERFALL_ROWS) != 0)
+    {
+        return;
+    }
+
+    s_hw = 1;
+    lv_obj_add_flag(s_newer, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(s_older, LV_OBJ_FLAG_HIDDEN);
+
+    /* 捲動區的 GRAM 第 r 列 = rgb[] 第 r 列, 起始列 = head 時最新的一列在最上方 */
+    lv_port_disp_scroll_write(0, s_rgb, WATERFALL_ROWS);
+    lv_port_disp_scroll_to(s_head);
+}
+
+static void waterfall_hw_end(void)
+{
+    lv_port_disp_scroll_end();
+    s_hw = 0;
+
+    lv_obj_clear_flag(s_newer, LV_OBJ_FLAG_HIDDEN);
+    waterfall_update_views();
+}
+
+/**
+ * @brief       建立瀑布圖 (WATERFALL_COLS x WATERFALL_ROWS, 預設隱藏)
+ * @param       parent: 父物件
+ * @param       index : 索引緩衝, WATERFALL_ROWS x WATERFALL_COLS byte
+ * @param       rgb   : 畫面緩衝, WATERFALL_ROWS x WATERFALL_COLS 個 RGB565 (4-byte 對齊)
+ * @param       db_min: 索引 0 對應的 dBV
+ * @param       db_max: 索引 255 對應的 dBV
+ * @retval      外框物件 (位置由呼叫端設定)
+ */
+lv_obj_t *waterfall_create(lv_obj_t *parent, uint8_t *index, uint16_t *rgb, int32_t db_min, int32_t db_max)
+{
+    s_index    = index;
+    s_rgb      = rgb;
+    s_head     = 0;
+    s_stale    = 0;
+    s_db_min   = (float)db_min;
+    s_db_scale = 255.0f / (float)(db_max - db_min);
+
+    waterfall_make_lut();
+
+    /* 外部 SRAM 的內容不會自動清零 */
+    memset(s_index, 0, (uint32_t)WATERFALL_ROWS * WATERFALL_COLS);
+    for (uint16_t r = 0; r < WATERFALL_ROWS; r++)
+    {
+        waterfall_convert_row(r);
+    }
+
+    s_cont = lv_obj_create(parent);
+    lv_obj_set_size(s_cont, WATERFALL_COLS, WATERFALL_ROWS);
+    lv_obj_set_style_pad_all(s_cont, 0, LV_PART_MAIN);
+    lv_obj_set_style_border_width(s_cont, 0, LV_PART_MAIN);
+    lv_obj_set_style_radius(s_cont, 0, LV_PART_MAIN);
+    lv_obj_clear_flag(s_cont, LV_OBJ_FLAG_SCROLLABLE);
+
+    s_newer = lv_canvas_create(s_cont);
+    s_older = lv_canvas_create(s_cont);
+    lv_obj_set_pos(s_newer, 0, 0);
+
+    waterfall_update_views();
+    lv_obj_add_flag(s_cont, LV_OBJ_FLAG_HIDDEN);
+
+    return s_cont;
+}
+
+/**
+ * @brief       加入一幀 (成為最上方的一列)
+ * @note        欄 x 對應 fft_chart 的第 x * (points - 1) / (COLS - 1) 點 (最近點),
+ *              db[] 就是圖表各點的值 (lv_mainstart.c 的 fft_view_resample()), 欄與圖表的頻率軸對齊
+ * @param       db    : fft_chart 各點的 dBV
+ * @param       points: fft_chart 的點數
+ * @retval      無
+ */
+void waterfall_add_frame(const float *db, uint16_t points)
+{
+    if (s_cont == NULL || points < 2)
+    {
+        return;
+    }
+
+    s_head = (s_head == 0) ? WATERFALL_ROWS - 1 : s_head - 1;
+
+    uint8_t *row = &s_index[(uint32_t)s_head * WATERFALL_COLS];
+    uint32_t inc = ((uint32_t)(points - 1) << 16) / (WATERFALL_COLS - 1);     /* 每欄前進的點數 (16.16) */
+    uint32_t pos = 0x8000;                                                  /* 四捨五入到最近點 */
+
+    for (uint32_t x = 0; x < WATERFALL_COLS; x++, pos += inc)
+    {
+        uint32_t j = pos >> 16;
+        if (j >= points) j = points - 1;
+
+        float v = (db[j] - s_db_min) * s_db_scale;
+        if (v < 0.0f)   v = 0.0f;
+        if (v > 255.0f) v = 255.0f;
+        row[x] = (uint8_t)v;
+    }
+
+    if (lv_obj_has_flag(s_cont, LV_OBJ_FLAG_HIDDEN))
+    {
+        s_stale = 1;
+        return;
+    }
+
+    waterfall_convert_row(s_head);
+
+    if (s_hw)
+    {
+        lv_port_disp_scroll_write(s_head, &s_rgb[(uint32_t)s_head * WATERFALL_COLS], 1);
+        lv_port_disp_scroll_to(s_head);
+        return;
+    }
+
+    waterfall_update_views();
+}
+
+/**
+ * @brief       顯示 / 隱藏
+ * @note        隱藏期間加入的列在顯示時一次轉換. 顯示時若 LCD 支援就改用硬體捲動, 隱藏時結束
+ * @param       visible: 1: 顯示; 0: 隱藏
+ * @retval      無
+ */
+void waterfall_set_visible(uint8_t visible)
+{
+    if (s_cont == NULL)
+    {
+        return;
+    }
+
+    if (!visible)
+    {
+        if (s_hw)
+        {
+            waterfall_hw_end();
+        }
+        lv_obj_add_flag(s_cont, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    if (s_stale)
+    {
+        for (uint16_t r = 0; r < WATERFALL_ROWS; r++)
+        {
+            waterfall_convert_row(r);
+        }
+        s_stale = 0;
+        waterfall_update_views();
+    }
+
+    lv_obj_clear_flag(s_cont, LV_OBJ_FLAG_HIDDEN);
+
+    if (!s_hw)
+    {
+        waterfall_hw_begin();
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ ****************************************************************************************************
+ * @file        waterfall.h
+ * @brief       頻譜瀑布圖: 8-bit 調色盤索引環形歷史 + 兩個 lv_canvas 視窗
+ ****************************************************************************************************
+ * @attention
+ *
+ * 每個頻譜幀在最上方加入一列, 較舊的列往下移, 共保留 WATERFALL_ROWS 列.
+ * 兩個緩衝都由呼叫端提供 (板端放外部 SRAM, 見 mem_map.h), 都是以列為單位的環形緩衝:
+ *   index[]  WATERFALL_ROWS x WATERFALL_COLS 個調色盤索引 (0 = FFT_DB_MIN, 255 = FFT_DB_MAX)
+ *   rgb[]    同樣大小的 RGB565 畫面, 由索引經 256 色 LUT 轉換
+ * 新的一列寫在 head 的前一列, 不搬動舊資料. 畫面由兩個 lv_canvas 直接指向 rgb[] 的兩段組成:
+ *   上方 canvas: rgb[head .. ROWS-1] (較新), 下方 canvas: rgb[0 .. head-1] (較舊)
+ * 每幀只改兩個 canvas 的緩衝指標與高度, 不複製畫面.
+ *
+ * 每幀的 CPU 工作量為 O(WATERFALL_COLS): 一列 dB => 索引, 再經 LUT 轉成 RGB565 (只轉新的一列).
+ * 瀑布圖隱藏時只寫索引, 重新顯示時才把整個歷史轉一次 (O(COLS x ROWS), 只在切換顯示模式時).
+ * 以 canvas 顯示時 LVGL 每幀仍會重繪並送出整個瀑布圖區域 (ROWS x COLS 像素, 只有複製, 沒有轉換).
+ *
+ * 硬體捲動: 顯示時若 LCD 控制器在目前方向可垂直捲動 (lcd_scroll_supported(), 例如 SSD1963 橫屏),
+ * 瀑布圖所在的列成為捲動區 (lv_port_disp_scroll_begin()), GRAM 第 r 列放 rgb[] 第 r 列,
+ * 捲動起始列設為 head. 之後每幀只寫新的一列再改起始列, FSMC 流量由 ROWS x COLS 降為 COLS 像素
+ * (ROWS = 100 時約 1/100), LVGL 也不再重繪這個區域. 捲動區內 LVGL 的像素不會送出
+ * (例如頻率刻度與瀑布圖重疊的上緣), LVGL 其他區域的座標不受影響.
+ * NT35510 等原生直屏的 IC 在橫屏時捲動方向是螢幕的 X 方向, 不支援, 維持 canvas 顯示.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __WATERFALL_H
+#define __WATERFALL_H
+
+#include <stdint.h>
+#include "lvgl.h"
+
+
+#define WATERFALL_COLS          800         /* 與 fft_chart 同寬, 欄與圖表的頻率軸對齊 */
+#define WATERFALL_ROWS          100         /* 保留的幀數 (1024 點 2kHz 時約 51 秒) */
+
+lv_obj_t *waterfall_create(lv_obj_t *parent, uint8_t *index, uint16_t *rgb, int32_t db_min, int32_t db_max);
+void waterfall_add_frame(const float *db, uint16_t points);
+void waterfall_set_visible(uint8_t visible);
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ ****************************************************************************************************
+ * @file        wave_decim.c
+ * @brief       波形峰值檢測抽取
+ ****************************************************************************************************
+ */
+
+#include "wave_decim.h"
+
+
+/**
+ * @brief       把 n 點取樣縮成 cols 組 min / max
+ * @note        第 c 欄涵蓋 src[c*n/cols] ~ src[(c+1)*n/cols] (含下一欄的第一點);
+ *              cols > n 時相鄰幾欄會重複同一段取樣
+ * @param       src    : 取樣
+ * @param       n      : 取樣數 (> 0)
+ * @param       cols   : 欄數 (> 0)
+ * @param       dst_min: 輸出, cols 點
+ * @param       dst_max: 輸出, cols 點
+ * @retval      無
+ */
+void wave_decim_minmax(const uint16_t *src, uint32_t n, uint16_t cols, uint16_t *dst_min, uint16_t *dst_max)
+{
+    uint32_t first = 0;
+
+    for (uint16_t c = 0; c < cols; c++)
+    {
+        uint32_t last = (uint32_t)(c + 1) * n / cols;     /* 下一欄的第一點 */
+
+        if (last >= n)    last = n - 1;
+        if (last < first) last = first;
+
+        uint16_t lo = src[first];
+        uint16_t hi = lo;
+
+        for (uint32_t i = first + 1; i <= last; i++)
+        {
+            uint16_t v = src[i];
+
+            if (v < lo) lo = v;
+            if (v > hi) hi = v;
+        }
+
+        dst_min[c] = lo;
+        dst_max[c] = hi;
+        first = last;
+    }
+}
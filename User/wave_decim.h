@@ -0,0 +1,23 @@
+/**
+ ****************************************************************************************************
+ * @file        wave_decim.h
+ * @brief       波形峰值檢測抽取: 把一整幀取樣縮成每欄一組 min / max
+ ****************************************************************************************************
+ * @attention
+ *
+ * 與示波器的 peak-detect 模式相同, 任何窄脈衝至少會出現在一欄的 min 或 max 裡.
+ * 每欄同時包含下一欄的第一個取樣, 相鄰兩欄的包絡因此一定相連 (陡峭的邊緣不會斷開).
+ * 計算量只與取樣數成正比, 繪製量只與欄數成正比. 不依賴 HAL / LVGL.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __WAVE_DECIM_H
+#define __WAVE_DECIM_H
+
+#include <stdint.h>
+
+
+void wave_decim_minmax(const uint16_t *src, uint32_t n, uint16_t cols, uint16_t *dst_min, uint16_t *dst_max);
+
+#endif
@@ -0,0 +1,345 @@
+/**
+ ****************************************************************************************************
+ * @file        zoom_fft.c
+ * @brief       Zoom FFT: 複數降頻 + FIR 抽取 + 複數 FFT
+ ****************************************************************************************************
+ */
+
+#include <string.h>
+#include <math.h>
+#include "zoom_fft.h"
+#include "arm_const_structs.h"
+#include "adc_convert.h"
+#include "profiler.h"
+
+
+#define ZOOM_FFT_2PI            6.283185307179586
+
+/* ZOOM_FFT_NPT 對應的 CMSIS 複數 FFT 實例 */
+#if ZOOM_FFT_NPT == 256
+#define ZOOM_FFT_CFFT           arm_cfft_sR_f32_len256
+#elif ZOOM_FFT_NPT == 512
+#define ZOOM_FFT_CFFT           arm_cfft_sR_f32_len512
+#elif ZOOM_FFT_NPT == 1024
+#define ZOOM_FFT_CFFT           arm_cfft_sR_f32_len1024
+#else
+#error "ZOOM_FFT_NPT must be 256, 512 or 1024"
+#endif
+
+
+/* 第一類修正 Bessel 函數 I0 (級數, 只在設定時使用) */
+static double zoom_fft_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < 1e-12 * sum)
+        {
+            break;
+        }
+    }
+
+    return sum;
+}
+
+/* Kaiser 窗 windowed-sinc 低通, 截止 fcut (Hz), 直流增益 1 (對稱, 不需時間反序) */
+static void zoom_fft_design(zoom_fft_t *z, double fcut, double beta)
+{
+    uint16_t n = z->taps;
+    double mid = 0.5 * (n - 1);
+    double wc = 2.0 * fcut / z->samp;           /* 正規化截止 (1 = fs/2) */
+    double i0b = zoom_fft_bessel_i0(beta);
+    double sum = 0.0;
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        double t = i - mid;
+        double r = (mid > 0.0) ? t / mid : 0.0;
+        double h = (t == 0.0) ? wc : sin(3.14159265358979 * wc * t) / (3.14159265358979 * t);
+
+        h *= zoom_fft_bessel_i0(beta * sqrt(1.0 - r * r)) / i0b;
+        z->coeff[i] = (float)h;
+        sum += h;
+    }
+
+    for (uint16_t i = 0; i < n; i++)
+    {
+        z->coeff[i] = (float)(z->coeff[i] / sum);
+    }
+}
+
+/* 週期型 Hann 窗, 除以相干增益 (0.5) => 正弦波峰值頻點的幅度與矩形窗相同 */
+static void zoom_fft_make_window(zoom_fft_t *z)
+{
+    for (uint32_t i = 0; i < ZOOM_FFT_NPT; i++)
+    {
+        z->win[i] = (float)(1.0 - cos(ZOOM_FFT_2PI * i / ZOOM_FFT_NPT));
+    }
+}
+
+/**
+ * @brief       設定頻帶: 選抽取率, 產生低通 FIR 與窗函數, 並重設
+ * @note        f_low ~ f_high 須在 0 ~ samp/2 之內; 抽取率不到 2 (頻帶太寬) 時仍以 D = 1 運作,
+ *              只是沒有解析度上的好處
+ * @param       z     : zoom FFT
+ * @param       samp  : 輸入採樣率 (Hz)
+ * @param       f_low : 下限 (Hz)
+ * @param       f_high: 上限 (Hz)
+ * @retval      0: 成功; 1: 頻帶無效 (維持原設定)
+ */
+uint8_t zoom_fft_set_band(zoom_fft_t *z, float samp, float f_low, float f_high)
+{
+    if (!(f_low >= 0.0f) || !(f_high > f_low) || !(f_high <= samp * 0.5f))
+    {
+        return 1;
+    }
+
+    double bw = f_high - f_low;
+    double trans_db = ZOOM_FFT_STOP_DB - 8.0;
+    uint8_t d = ZOOM_FFT_D_MAX;
+    uint32_t taps = 0;
+
+    /* 最大的 D: fs_d 夠寬, 且過渡帶 (fs_d - B) 所需的點數放得下 */
+    for (; d > 1; d >>= 1)
+    {
+        double fs_d = samp / d;
+
+        if (fs_d < ZOOM_FFT_MARGIN * bw)
+        {
+            continue;
+        }
+
+        taps = (uint32_t)ceil(trans_db / (2.285 * ZOOM_FFT_2PI * (fs_d - bw) / samp)) | 1u;
+        if (taps <= ZOOM_FFT_TAPS_MAX)
+        {
+            break;
+        }
+    }
+
+    if (d == 1)
+    {
+        /* 只需壓掉混頻後 -2fc 附近的鏡像, 過渡帶取 fs/2 - B/2 */
+        taps = (uint32_t)ceil(trans_db / (2.285 * ZOOM_FFT_2PI * (samp * 0.5 - bw * 0.5) / samp)) | 1u;
+        if (taps > ZOOM_FFT_TAPS_MAX) taps = ZOOM_FFT_TAPS_MAX - 1;
+    }
+
+    z->samp   = samp;
+    z->f_low  = f_low;
+    z->f_high = f_high;
+    z->fc     = 0.5f * (f_low + f_high);
+    z->decim  = d;
+    z->samp_d = samp / d;
+    z->taps   = (uint16_t)taps;
+
+    zoom_fft_design(z, (d == 1) ? 0.25 * (samp + bw) : 0.5 * z->samp_d,
+                    0.1102 * (ZOOM_FFT_STOP_DB - 8.7));
+    zoom_fft_make_window(z);
+
+    double w = ZOOM_FFT_2PI * z->fc / samp;
+    z->step_re = (float)cos(w);
+    z->step_im = (float)-sin(w);
+
+    zoom_fft_reset(z);
+    return 0;
+}
+
+/**
+ * @brief       清空濾波器狀態, 環形緩衝與 NCO 相位 (輸入不連續時呼叫, 例如 ADC DMA 重新啟動)
+ * @param       z: zoom FFT (已 zoom_fft_set_band())
+ * @retval      無
+ */
+void zoom_fft_reset(zoom_fft_t *z)
+{
+    arm_fir_decimate_init_f32(&z->fir_i, z->taps, z->decim, z->coeff, z->state_i, ZOOM_FFT_BLOCK);
+    arm_fir_decimate_init_f32(&z->fir_q, z->taps, z->decim, z->coeff, z->state_q, ZOOM_FFT_BLOCK);     /* 狀態清零 */
+    memset(z->ring, 0, sizeof(z->ring));
+
+    z->nco_re = 1.0f;
+    z->nco_im = 0.0f;
+    z->head   = 0;
+}
+
+/**
+ * @brief       一幀 ADC 原始碼 => 混頻, 抽取, 寫入環形緩衝
+ * @param       z  : zoom FFT
+ * @param       src: 原始碼 (時間上接續上一次呼叫)
+ * @param       n  : 點數, z->decim 的倍數 (FFT_PROC_NPT_MIN 以上的 2 的冪都符合)
+ * @retval      無
+ */
+void zoom_fft_push_u16(zoom_fft_t *z, const uint16_t *src, uint32_t n)
+{
+    const float lsb = FFT_PROC_ADC_VREF / FFT_PROC_ADC_FULL_SCALE;
+    int32_t dc = adc_convert_mean(src, n);
+
+    PROF_BEGIN(PROF_ZONE_ZOOM_DDC);
+    for (uint32_t off = 0; off < n; off += ZOOM_FFT_BLOCK)
+    {
+        uint32_t len = n - off;
+        if (len > ZOOM_FFT_BLOCK) len = ZOOM_FFT_BLOCK;
+
+        adc_convert_f32(&src[off], len, dc, NULL, lsb, z->blk_i);
+
+        float pr = z->nco_re, pi = z->nco_im;
+        float sr = z->step_re, si = z->step_im;
+
+        for (uint32_t i = 0; i < len; i++)
+        {
+            float x = z->blk_i[i];
+            float t = pr * sr - pi * si;
+
+            z->blk_i[i] = x * pr;
+            z->blk_q[i] = x * pi;
+            pi = pr * si + pi * sr;
+            pr = t;
+        }
+
+        /* |p| 的誤差每點約 1e-7 累積, 每區塊以一階近似拉回 1 */
+        float g = 1.5f - 0.5f * (pr * pr + pi * pi);
+        z->nco_re = pr * g;
+        z->nco_im = pi * g;
+
+        arm_fir_decimate_f32(&z->fir_i, z->blk_i, z->dec_i, len);
+        arm_fir_decimate_f32(&z->fir_q, z->blk_q, z->dec_q, len);
+
+        uint32_t m = len / z->decim;
+        uint32_t h = z->head;
+
+        for (uint32_t k = 0; k < m; k++)
+        {
+            z->ring[2 * h]     = z->dec_i[k];
+            z->ring[2 * h + 1] = z->dec_q[k];
+            h = (h + 1) & (ZOOM_FFT_NPT - 1);
+        }
+
+        z->head = (uint16_t)h;
+    }
+    PROF_END(PROF_ZONE_ZOOM_DDC);
+}
+
+/**
+ * @brief       頻率範圍 => mag[] 的索引範圍 (四捨五入, 夾在 fs_d 涵蓋的範圍內)
+ * @param       z        : zoom FFT
+ * @param       f_low    : 下限 (Hz)
+ * @param       f_high   : 上限 (Hz)
+ * @param       bin_start: 輸出, 第一個索引
+ * @param       bin_end  : 輸出, 最後一個索引 (含)
+ * @retval      無
+ */
+void zoom_fft_bin_range(const zoom_fft_t *z, float f_low, float f_high, uint16_t *bin_start, uint16_t *bin_end)
+{
+    float per_hz = ZOOM_FFT_NPT / z->samp_d;
+    int start = (int)floorf((f_low - z->fc) * per_hz + 0.5f) + ZOOM_FFT_NPT / 2;
+    int end   = (int)floorf((f_high - z->fc) * per_hz + 0.5f) + ZOOM_FFT_NPT / 2;
+
+    if (start < 0)                 start = 0;
+    if (end > ZOOM_FFT_NPT - 1)    end = ZOOM_FFT_NPT - 1;
+    if (start > end)
+    {
+        start = 0;
+        end   = ZOOM_FFT_NPT - 1;
+    }
+
+    *bin_start = (uint16_t)start;
+    *bin_end   = (uint16_t)end;
+}
+
+/**
+ * @brief       最近 ZOOM_FFT_NPT 個抽取後的點 => 加窗, 複數 FFT, 範圍內的幅度 (fftshift 後的索引)
+ * @param       z        : zoom FFT
+ * @param       bin_start: 第一個索引 (zoom_fft_bin_range())
+ * @param       bin_end  : 最後一個索引 (含)
+ * @retval      無
+ */
+void zoom_fft_spectrum(zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end)
+{
+    const uint32_t half = ZOOM_FFT_NPT / 2;
+    uint32_t h = z->head;
+
+    PROF_BEGIN(PROF_ZONE_ZOOM_FFT);
+    /* 時間順序: ring[head] 最舊 */
+    for (uint32_t k = 0; k < ZOOM_FFT_NPT; k++)
+    {
+        z->buf[2 * k]     = z->ring[2 * h] * z->win[k];
+        z->buf[2 * k + 1] = z->ring[2 * h + 1] * z->win[k];
+        h = (h + 1) & (ZOOM_FFT_NPT - 1);
+    }
+
+    arm_cfft_f32(&ZOOM_FFT_CFFT, z->buf, 0, 1);
+
+    /* mag[j] = |X[(j + NPT/2) mod NPT]|: 負頻率 (j < NPT/2) 在 buf 的後半 */
+    if (bin_start < half)
+    {
+        uint32_t last = (bin_end < half) ? bin_end : half - 1;
+        arm_cmplx_mag_f32(&z->buf[2 * (bin_start + half)], &z->mag[bin_start], last - bin_start + 1);
+    }
+    if (bin_end >= half)
+    {
+        uint32_t first = (bin_start > half) ? bin_start : half;
+        arm_cmplx_mag_f32(&z->buf[2 * (first - half)], &z->mag[first], bin_end - first + 1);
+    }
+    PROF_END(PROF_ZONE_ZOOM_FFT);
+}
+
+/**
+ * @brief       範圍內的最大值 => 峰值 (Hann 主瓣插值)
+ * @param       z        : zoom FFT (zoom_fft_spectrum() 之後)
+ * @param       bin_start: 第一個索引
+ * @param       bin_end  : 最後一個索引 (含)
+ * @param       pk       : 輸出
+ * @retval      無
+ */
+void zoom_fft_find_peak(const zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end, fft_peak_t *pk)
+{
+    float maxv;
+    uint32_t idx = 0;
+
+    arm_max_f32((float *)&z->mag[bin_start], bin_end - bin_start + 1, &maxv, &idx);
+    zoom_fft_refine_peak(z, bin_start, bin_end, bin_start + idx, pk);
+}
+
+/**
+ * @brief       以指定的索引填入 fft_peak_t
+ * @note        複數頻譜沒有負頻率的鏡像, 單一正弦波的 Hann 主瓣為 |W(d)| = sinc(d) / (1 - d^2),
+ *              以峰值與較大的鄰點之比直接解出偏移 d = (2b - a) / (a + b) (a 為峰值, b 為鄰點),
+ *              振幅 = 峰值 / W(d); index 在範圍兩端時不插值. freq 為絕對頻率 (Hz)
+ * @param       z        : zoom FFT (zoom_fft_spectrum() 之後)
+ * @param       bin_start: 已計算幅度的第一個索引
+ * @param       bin_end  : 最後一個索引 (含)
+ * @param       index    : 峰值索引
+ * @param       pk       : 輸出
+ * @retval      無
+ */
+void zoom_fft_refine_peak(const zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end, uint32_t index, fft_peak_t *pk)
+{
+    float a = z->mag[index];
+    float gain = 1.0f;
+
+    pk->index  = index;
+    pk->value  = a;
+    pk->offset = 0.0f;
+
+    if (index > bin_start && index < bin_end && a > 0.0f)
+    {
+        float l = z->mag[index - 1];
+        float r = z->mag[index + 1];
+        float b = (r > l) ? r : l;
+        float d = (2.0f * b - a) / (a + b);
+
+        if (d < 0.0f) d = 0.0f;
+        if (d > 0.5f) d = 0.5f;
+
+        if (d > 1e-4f)
+        {
+            float x = 3.14159265f * d;
+            gain = sinf(x) / x / (1.0f - d * d);
+        }
+
+        pk->offset = (r > l) ? d : -d;
+    }
+
+    pk->freq = z->fc + ((float)index + pk->offset - ZOOM_FFT_NPT / 2) * z->samp_d / ZOOM_FFT_NPT;
+    pk->amp  = a / gain * 2.0f / ZOOM_FFT_NPT;
+}
@@ -0,0 +1,113 @@
+/**
+ ****************************************************************************************************
+ * @file        zoom_fft.h
+ * @brief       Zoom FFT: 複數降頻到頻帶中心, FIR 抽取, 較小的複數 FFT, 只分析 f_low ~ f_high
+ ****************************************************************************************************
+ * @attention
+ *
+ * 顯示只用到 f_low ~ f_high (預設 250 ~ 650Hz), 一般的 RFFT 卻把點數花在整個 0 ~ fs/2.
+ * 本模組的處理 (每幀 ADC 原始碼, 逐幀串接, 跨幀連續):
+ *   1. 去直流 (本幀平均), 換算成電壓 (adc_convert_f32)
+ *   2. 乘上 e^(-j 2 pi fc n / fs), fc = (f_low + f_high) / 2, 頻帶移到 0Hz 兩側 (I / Q)
+ *      NCO 以複數相量遞迴, 每個區塊重新正規化一次, 相位跨幀連續
+ *   3. I / Q 各一個低通 FIR 抽取器 (arm_fir_decimate_f32, 只計算保留下來的輸出點, 即 polyphase 的
+ *      運算量: 每輸入點 taps / D 次乘加), 抽取率 D 為 2 的冪, fs_d = fs / D
+ *   4. 抽取後的複數點寫入 ZOOM_FFT_NPT 點的環形緩衝; 每幀取最近 ZOOM_FFT_NPT 點,
+ *      乘 Hann 窗 (含振幅修正), arm_cfft_f32, 只算範圍內的幅度, 並做 fftshift:
+ *        mag[j] 對應 fc + (j - NPT/2) x fs_d / NPT  (Hz)
+ *
+ * D 取滿足 fs_d >= ZOOM_FFT_MARGIN x (f_high - f_low) 的最大值 (<= ZOOM_FFT_D_MAX).
+ * 低通濾波器為 Kaiser 窗的 windowed-sinc (設定時產生): 通帶到 B/2, 阻帶從 fs_d - B/2 開始
+ * (折疊後會落進頻帶內的最近頻率), 衰減 ZOOM_FFT_STOP_DB, 截止頻率在兩者中間 (fs_d / 2);
+ * 點數依過渡帶寬估計, 上限 ZOOM_FFT_TAPS_MAX. 不用 CIC: 這裡 D 只有 2 ~ 16, 乘法不是瓶頸,
+ * CIC 在 B / fs_d = 0.8 時頻帶邊緣的下垂與折疊抑制都不足, 還要多一級補償 FIR.
+ *
+ * 幅度單位與 fft_proc 相同: 正弦波 A cos 混頻後為 A/2, 加窗 (振幅修正) 後峰值頻點 = A x NPT / 2,
+ * 因此 fft_proc_decimate_mag() / fft_proc_mag_to_db(ZOOM_FFT_NPT, ...), peak_detect_run(),
+ * spec_avg_apply() 都可直接使用 mag[].
+ *
+ * 預設 fs = 2kHz, 250 ~ 650Hz: fc = 450Hz, D = 4, fs_d = 500Hz, 73 taps;
+ *   NPT = 1024 時解析度 fs_d / NPT = 0.49Hz, 為同一 fs 下 1024 點 RFFT (1.95Hz) 的 4 倍, 與 4096 點 RFFT 相同.
+ *   環形緩衝涵蓋 NPT x D 個輸入點 (1024 時 4096 點, 2.05s), 每幀 (npt 點) 更新一次, 相鄰兩次重疊
+ *   1 - npt / (NPT x D); 開始或重設後要 NPT x D 個輸入點才填滿 (之前的部分為 0).
+ *   頻帶越窄 D 越大 (例如 300 ~ 500Hz 為 D = 8), 解析度跟著變細, 每輸入點的乘加數大致不變.
+ * 耗時與解析度的取捨 (ZOOM_FFT_NPT 於編譯時選 256 / 512 / 1024, 預設 1024):
+ *   zoom 並不比 1024 點 RFFT 便宜, 它是以較高的耗時換取頻帶內的解析度. 混頻與 FIR 與 NPT 無關,
+ *   每 1024 個輸入點約 8k + 47k 週期 (FIR 2 x 73 / 4 = 36.5 次乘加/點), 已超過 1024 點 RFFT + 幅度
+ *   (約 40k, 見 tone_bank.h). 每 1024 個輸入點更新一次, M4 估計:
+ *     NPT   解析度    複數 FFT  加窗  範圍內幅度   合計
+ *     256   1.95Hz    約 4k     1.5k  205 點 3k    約 64k  (與 1024 點 RFFT 同解析度, 沒有好處)
+ *     512   0.98Hz    約 10k    3k    410 點 6k    約 74k
+ *     1024  0.49Hz    約 22k    6k    821 點 12k   約 95k
+ *   同解析度的 4096 點 RFFT + 821 點幅度每次約 125k, 而且每 4096 點 (npt = 4096, 2s) 才更新一次;
+ *   換算成每個輸入點, 不重疊的 4096 點 RFFT 比較便宜. zoom 的好處是以 1024 點的更新率得到
+ *   4096 點的解析度, 且不必把 npt 切到 4096 (Wave Chart, 峰值的延遲都不變).
+ *   主機量測 (Tools/zoom_bench.c, 以 -DZOOM_FFT_NPT=n 編譯; 主機 FFT 為雙精度實作, 比例偏向 zoom):
+ *   對 1024 點 RFFT 約 0.85x / 1.05x / 1.75x (NPT 256 / 512 / 1024). 板端見 profiler 的
+ *   zoom_ddc / zoom_fft 區段.
+ * 峰值插值: 複數頻譜沒有負頻率的鏡像, Hann 主瓣的兩點比值公式對單一正弦波為精確解 (zoom_fft_refine_peak()).
+ * 記憶體: 全部在本結構內 (NPT = 256 / 512 / 1024 時約 15 / 21 / 33KB), 由呼叫端決定放在哪裡. 不依賴 HAL.
+ *
+ ****************************************************************************************************
+ */
+
+#ifndef __ZOOM_FFT_H
+#define __ZOOM_FFT_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "fft_proc.h"
+
+
+#ifndef ZOOM_FFT_NPT
+#define ZOOM_FFT_NPT            1024        /* 複數 FFT 點數: 256 / 512 / 1024 (耗時與解析度的取捨見上方) */
+#endif
+#define ZOOM_FFT_BLOCK          256         /* 每次混頻 / 抽取的輸入點數 */
+#define ZOOM_FFT_D_MAX          16          /* 抽取率上限 (2 的冪, 整除 ZOOM_FFT_BLOCK 與 FFT_PROC_NPT_MIN) */
+#define ZOOM_FFT_TAPS_MAX       192         /* 低通 FIR 點數上限 */
+#define ZOOM_FFT_MARGIN         1.25f       /* fs_d >= MARGIN x 頻寬 (留給過渡帶) */
+#define ZOOM_FFT_STOP_DB        60.0f       /* 阻帶衰減 (dB) */
+
+typedef struct
+{
+    float    samp;              /* 輸入採樣率 (Hz) */
+    float    f_low;             /* 目前的頻帶 (Hz) */
+    float    f_high;
+    float    fc;                /* 頻帶中心 = 混頻頻率 (Hz) */
+    float    samp_d;            /* 抽取後採樣率 (Hz) */
+    uint8_t  decim;             /* 抽取率 D */
+    uint16_t taps;              /* 低通 FIR 點數 */
+
+    float    nco_re;            /* 目前的相量 e^(-j 2 pi fc n / fs) */
+    float    nco_im;
+    float    step_re;           /* 每點的旋轉 e^(-j 2 pi fc / fs) */
+    float    step_im;
+
+    uint16_t head;              /* ring[] 下一個寫入的複數點 (最舊的點) */
+
+    arm_fir_decimate_instance_f32 fir_i;
+    arm_fir_decimate_instance_f32 fir_q;
+    float    coeff[ZOOM_FFT_TAPS_MAX];
+    float    state_i[ZOOM_FFT_TAPS_MAX + ZOOM_FFT_BLOCK - 1];
+    float    state_q[ZOOM_FFT_TAPS_MAX + ZOOM_FFT_BLOCK - 1];
+    float    blk_i[ZOOM_FFT_BLOCK];     /* 混頻後的區塊 */
+    float    blk_q[ZOOM_FFT_BLOCK];
+    float    dec_i[ZOOM_FFT_BLOCK];     /* 抽取後的區塊 (blk / D 點) */
+    float    dec_q[ZOOM_FFT_BLOCK];
+
+    float    ring[2 * ZOOM_FFT_NPT];    /* 抽取後的複數點 (I, Q 交錯), 環形 */
+    float    win[ZOOM_FFT_NPT];         /* Hann 窗 x 振幅修正 */
+    float    buf[2 * ZOOM_FFT_NPT];     /* 複數 FFT 工作區 */
+    float    mag[ZOOM_FFT_NPT];         /* fftshift 後的幅度, zoom_fft_spectrum() 的範圍內有效 */
+} zoom_fft_t;
+
+
+uint8_t zoom_fft_set_band(zoom_fft_t *z, float samp, float f_low, float f_high);    /* 0: 成功; 1: 頻帶無效 */
+void zoom_fft_reset(zoom_fft_t *z);                                     /* 清空濾波器狀態與環形緩衝 */
+void zoom_fft_push_u16(zoom_fft_t *z, const uint16_t *src, uint32_t n); /* n 為 decim 的倍數 */
+void zoom_fft_bin_range(const zoom_fft_t *z, float f_low, float f_high, uint16_t *bin_start, uint16_t *bin_end);
+void zoom_fft_spectrum(zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end);
+void zoom_fft_find_peak(const zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end, fft_peak_t *pk);
+void zoom_fft_refine_peak(const zoom_fft_t *z, uint16_t bin_start, uint16_t bin_end, uint32_t index, fft_peak_t *pk);
+
+#endif